@@ -13,12 +13,14 @@ namespace RadisLaunch
         unsigned width = 1280;                         // The width of the window.
         unsigned height = 720;                         // The height of the window.
         unsigned fps = 120;			                   // The target frames per second.
+        unsigned simRate = 60;                         // Fixed simulation steps per second (physics, network ticks).
         std::string serverAddress = Radis::SERVER_IP;    // The address of the server. Defaults to online VPS server.
         uint16_t serverPort = 7777;                    // The port of the server.
         Radis::GraphicsAPI graphicsAPI = Radis::GraphicsAPI::Vulkan; // The graphics API to use.
 
         std::string workingDirectory = "";              // The working directory of the engine.
         bool launchWithEditor = true;                   // Whether to launch the engine with the editor.
+        unsigned frameCount = 0;                        // Frames to run before exiting, 0 runs until closed.
     };
 
     inline void to_json(nlohmann::json& j, const EngineSpec& args) {
@@ -27,11 +29,13 @@ namespace RadisLaunch
             {"width", args.width},
             {"height", args.height},
             {"fps", args.fps},
+            {"simRate", args.simRate},
             {"serverAddress", args.serverAddress},
             {"serverPort", args.serverPort},
             {"graphicsAPI", args.graphicsAPI},
             {"workingDirectory", args.workingDirectory },
-            {"launchWithEditor", args.launchWithEditor }
+            {"launchWithEditor", args.launchWithEditor },
+            {"frameCount", args.frameCount }
         };
     }
 
@@ -40,11 +44,13 @@ namespace RadisLaunch
         j.at("width").get_to(args.width);
         j.at("height").get_to(args.height);
         j.at("fps").get_to(args.fps);
+        args.simRate = j.value("simRate", args.simRate); // optional, older launch.json files don't have it
         j.at("serverAddress").get_to(args.serverAddress);
         j.at("serverPort").get_to(args.serverPort);
         j.at("graphicsAPI").get_to(args.graphicsAPI);
         j.at("workingDirectory").get_to(args.workingDirectory);
         j.at("launchWithEditor").get_to(args.launchWithEditor);
+        args.frameCount = j.value("frameCount", args.frameCount); // optional, for bounded headless runs
     }
 
 } // namespace RadisLaunch
\ No newline at end of file
@@ -1,17 +1,19 @@
 #version 450
 
-// Per Vertex Inputs
-layout(location = 0) in vec3 position;
+// Per Vertex Inputs, packed (see PackedVertex/SkinVertex)
+layout(location = 0) in vec3 quantizedPosition; // unorm16 in the mesh AABB
 layout(location = 1) in vec3 color;
-layout(location = 2) in vec3 normal;
+layout(location = 2) in vec2 octNormal;         // octahedral snorm16
 layout(location = 3) in vec2 texCoord;
-layout(location = 4) in ivec4 boneIds;
-layout(location = 5) in vec4 weights;
+layout(location = 4) in uvec4 boneIds;
+layout(location = 5) in vec4 weights;           // 0 for unused influences
 // Per Instance Inputs
 layout(location = 6) in mat4 iModel;
 layout(location = 10) in vec4 iTint;
 layout(location = 11) in uint iTextureIndex;
 layout(location = 12) in uint iBoneOffset;
+layout(location = 13) in vec3 iPositionOffset;
+layout(location = 14) in vec3 iPositionScale;
 
 // Outputs
 layout(location = 0) out vec3 fragColor;
@@ -44,17 +46,27 @@ vec3 rotate(vec4 q, vec3 v) {
     return v + q.w * t + cross(q.xyz, t);
 }
 
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main() 
 {
     vec4 totalPosition = vec4(0.0f);
     vec3 totalNormal = vec3(0.0f);
+
+    vec3 position = iPositionOffset + quantizedPosition * iPositionScale;
+    vec3 normal = octDecode(octNormal);
     
     bool validBoneFound = false;
     if (iBoneOffset != 10001)
     {
         for (uint i = 0; i < 4 ; i++)
         {
-            if(boneIds[i] == -1) continue;
+            if(weights[i] == 0.0) continue;
 
             VQS transform = animationData.finalBoneVQS[iBoneOffset + boneIds[i]];
 
@@ -57,12 +57,18 @@ struct Light {
     int type;          // 0=dir, 1=point, 2=spot
 };
 
-#define MAX_LIGHTS 1000
 SSBO_LAYOUT(0, 4) readonly buffer LightData {
     uint lightCount;
-    Light lights[MAX_LIGHTS];
+    Light lights[];
 } lightData;
 
+// Clustered light lists, see LightGridHeader
+SSBO_LAYOUT(0, 6) readonly buffer LightGrid {
+    uvec4 gridSize;    // tiles x, tiles y, depth slices, directional light count
+    vec4 depthParams;  // slice = log(view depth) * x + y
+    uint cells[];      // (first, count) per cluster, directional lights, cluster light lists
+} lightGrid;
+
 // --- PBR Implementation ---
 
 // GGX Trowbridge-Reitz
@@ -125,6 +131,49 @@ vec3 computePBRLight(vec3 albedo, float metallic, float roughness, vec3 N, vec3
     return (diffuse + specular) * NdotL * lightColor;
 }
 
+vec3 ShadeLight(Light light, vec3 albedo, float metallic, float roughness, vec3 N, vec3 V, vec3 worldPos)
+{
+    vec3 L;
+    float attenuation = 1.0;
+
+    if (light.type == 0) {
+        // Directional light
+        L = normalize(-light.direction);
+    }
+    else {
+        // Point / Spot
+        vec3 toLight = light.position - worldPos;
+        float dist = length(toLight);
+        L = normalize(toLight);
+        attenuation = clamp(1.0 - dist / light.radius, 0.0, 1.0);
+        attenuation *= attenuation; // smoother
+    }
+
+    if (light.type == 2) {
+        // Spot light cone
+        float spotFactor = dot(L, -light.direction);
+        float smoothS = smoothstep(light.outerCone, light.innerCone, spotFactor);
+        attenuation *= smoothS;
+    }
+
+    vec3 lightCol = light.color * light.intensity * attenuation;
+    return computePBRLight(albedo, metallic, roughness, N, V, L, lightCol);
+}
+
+// Cluster of the light grid the fragment falls in
+uint GetLightCluster(vec3 worldPos)
+{
+    vec4 clip = uniforms.projectionView * vec4(worldPos, 1.0);
+    vec2 ndc = clip.xy / clip.w;
+    float viewDepth = max(-(uniforms.view * vec4(worldPos, 1.0)).z, 1e-4);
+
+    uvec2 tile = uvec2(clamp(ndc * 0.5 + 0.5, 0.0, 1.0) * vec2(lightGrid.gridSize.xy));
+    tile = min(tile, lightGrid.gridSize.xy - 1u);
+    float slice = log(viewDepth) * lightGrid.depthParams.x + lightGrid.depthParams.y;
+    uint depthSlice = uint(clamp(slice, 0.0, float(lightGrid.gridSize.z - 1u)));
+    return (depthSlice * lightGrid.gridSize.y + tile.y) * lightGrid.gridSize.x + tile.x;
+}
+
 // -------------------------
 vec4 SampleTexture(uint texIndex, vec2 uv)
 {
@@ -191,34 +240,22 @@ void main()
     vec3 V = normalize(uniforms.cameraPos - fragWorldPos);
     vec3 Lo = vec3(0.0);
 
-    for (uint i = 0; i < lightData.lightCount; ++i)
+    // Directional lights reach everything, they follow the cluster table
+    uint clusterCount = lightGrid.gridSize.x * lightGrid.gridSize.y * lightGrid.gridSize.z;
+    for (uint i = 0; i < lightGrid.gridSize.w; ++i)
+    {
+        Light light = lightData.lights[lightGrid.cells[clusterCount * 2 + i]];
+        Lo += ShadeLight(light, albedo, metallic, roughness, N, V, fragWorldPos);
+    }
+
+    // Point and spot lights only from this fragment's cluster
+    uint cluster = GetLightCluster(fragWorldPos);
+    uint first = lightGrid.cells[cluster * 2];
+    uint count = lightGrid.cells[cluster * 2 + 1];
+    for (uint i = 0; i < count; ++i)
     {
-        Light light = lightData.lights[i];
-        vec3 L;
-        float attenuation = 1.0;
-
-        if (light.type == 0) {
-            // Directional light
-            L = normalize(-light.direction);
-        }
-        else {
-            // Point / Spot
-            vec3 toLight = light.position - fragWorldPos;
-            float dist = length(toLight);
-            L = normalize(toLight);
-            attenuation = clamp(1.0 - dist / light.radius, 0.0, 1.0);
-            attenuation *= attenuation; // smoother
-        }
-
-        if (light.type == 2) {
-            // Spot light cone
-            float spotFactor = dot(L, -light.direction);
-            float smoothS = smoothstep(light.outerCone, light.innerCone, spotFactor);
-            attenuation *= smoothS;
-        }
-
-        vec3 lightCol = light.color * light.intensity * attenuation;
-        Lo += computePBRLight(albedo, metallic, roughness, N, V, L, lightCol);
+        Light light = lightData.lights[lightGrid.cells[first + i]];
+        Lo += ShadeLight(light, albedo, metallic, roughness, N, V, fragWorldPos);
     }
 
     // Apply ambient & AO
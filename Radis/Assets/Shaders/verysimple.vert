@@ -1,12 +1,12 @@
 #version 460
 
-// Per Vertex Inputs
-layout(location = 0) in vec3 position;
+// Per Vertex Inputs, packed (see PackedVertex/SkinVertex)
+layout(location = 0) in vec3 quantizedPosition; // unorm16 in the mesh AABB
 layout(location = 1) in vec3 color;
-layout(location = 2) in vec3 normal;
+layout(location = 2) in vec2 octNormal;         // octahedral snorm16
 layout(location = 3) in vec2 texCoord;
-layout(location = 4) in ivec4 boneIds;
-layout(location = 5) in vec4 weights;
+layout(location = 4) in uvec4 boneIds;
+layout(location = 5) in vec4 weights;           // 0 for unused influences
 
 // Outputs -----------------------------------------
 layout(location = 0) out vec3 fragColor;
@@ -24,7 +24,6 @@ layout(location = 10) out vec3 fragWorldPos;
 
 const float PI = 3.14159265359;
 const uint INVALID_TEXTURE_INDEX = 10001;
-const int INVALID_BONE_ID = -1;
 
 struct VQS {
     vec4 rotation;    // Quat
@@ -62,13 +61,22 @@ struct Instance
     uint boneOffset;
     uint indexOffset;
     uint vertexOffset;
+    uint meshID;
+    vec4 positionOffset;
+    vec4 positionScale;
 };
 
+// Persistent instance table, indexed through this frame's visible slots
 SSBO_LAYOUT(0, 1) readonly buffer InstanceData
 {
     Instance instances[];
 };
 
+SSBO_LAYOUT(0, 5) readonly buffer VisibleInstances
+{
+    uint visibleSlots[];
+};
+
 SSBO_LAYOUT(0, 2) readonly buffer BoneBuffer
 {
     VQS finalBoneVQS[];
@@ -80,6 +88,13 @@ vec3 rotate(vec4 q, vec3 v) {
     vec3 t = 2.0 * cross(q.xyz, v);
     return v + q.w * t + cross(q.xyz, t);
 }
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
 // ----------------------------------------------------
 
 void main() 
@@ -87,14 +102,18 @@ void main()
     vec4 totalPosition = vec4(0.0f);
     vec3 totalNormal = vec3(0.0f);
     
-    Instance instance = instances[INSTANCE_ID];
+    uint slot = visibleSlots[INSTANCE_ID];
+    Instance instance = instances[slot];
+
+    vec3 position = instance.positionOffset.xyz + quantizedPosition * instance.positionScale.xyz;
+    vec3 normal = octDecode(octNormal);
 
     bool validBoneFound = false;
     if (instance.boneOffset != INVALID_TEXTURE_INDEX)
     {
         for (int i = 0; i < 4 ; i++)
         {
-            if(boneIds[i] == INVALID_BONE_ID) continue;
+            if(weights[i] == 0.0) continue;
             VQS transform = animationData.finalBoneVQS[instance.boneOffset + boneIds[i]];
         
             // --- Position Transformation ---
@@ -133,7 +152,7 @@ void main()
     baseColorFactor = instance.baseColorFactor;
     metallicRoughnessFactor = instance.metallicRoughnessFactor;
     emissiveFactor = instance.emissiveFactor;
-    instanceIndex = INSTANCE_ID;
+    instanceIndex = slot;
     fragWorldPos = worldPos.xyz;
     fragWorldNormal = worldNormal;
 }
\ No newline at end of file
@@ -7,25 +7,27 @@
 #include "Graphics/Common/TextureLoader.h"
 #include "BinaryIO.h"
 #include "Engine.h"
+#include "Jobs/JobSystem.h"
 
 using namespace Radis;
 
 const std::string ModelSerializer::RADIS_MODEL_FILE_PATH = "assets/models/dm/";
 const std::string ModelSerializer::RADIS_MODEL_EXTENTION = ".dm";
 
-bool ModelSerializer::validateHeader(std::ifstream& file) {
+bool ModelSerializer::validateHeader(std::ifstream& file, uint32_t& outVersion) {
     BinaryReaderLE reader(file);
 
     uint32_t hash = reader.U32(); // you ignore it, but still read
     uint32_t magic = reader.U32();
     uint32_t version = reader.U32();
 
-    if (magic != MAGIC_NUMBER || version != VERSION)
+    if (magic != MAGIC_NUMBER || version < MIN_VERSION || version > VERSION)
     {
         RADIS_ERROR("Invalid file format or version.");
         return false;
     }
 
+    outVersion = version;
     return true;
 }
 
@@ -196,13 +198,18 @@ void ModelSerializer::save(const Model& model, const std::string& filename, uint
     }
 
     // ---------------- PARALLEL KTX2 BUILD ---------------------------
-    std::for_each(std::execution::par, textures.begin(), textures.end(), [](TextureRecord& rec)
+    JobSystem::ParallelFor(textures.size(), 1, [&textures](size_t begin, size_t end)
     {
-        TextureLoader::KTX2BuildInput input{};
-        input.sourcePath = rec.sourcePath;
-        input.data = rec.embeddedData;
+        for (size_t i = begin; i < end; ++i)
+        {
+            TextureRecord& rec = textures[i];
+
+            TextureLoader::KTX2BuildInput input{};
+            input.sourcePath = rec.sourcePath;
+            input.data = rec.embeddedData;
 
-        TextureLoader::BuildKTX2File(input, rec.outKTX2Path);
+            TextureLoader::BuildKTX2File(input, rec.outKTX2Path);
+        }
     });
 
     // ---------------- FILE WRITE (paths to KTX2s only) ---------------
@@ -286,6 +293,29 @@ void ModelSerializer::save(const Model& model, const std::string& filename, uint
         for (uint32_t idxVal : mesh.mIndices)
             w.U32(idxVal);
 
+        // LOD chain: [count] then per LOD [error][indexCount][indices]
+        w.U32(static_cast<uint32_t>(mesh.mLODs.size()));
+        for (const MeshLOD& lod : mesh.mLODs)
+        {
+            w.F32(lod.error);
+            w.U32(static_cast<uint32_t>(lod.indices.size()));
+            for (uint32_t idxVal : lod.indices)
+                w.U32(idxVal);
+        }
+
+        // Meshlets: [count] then per meshlet [firstIndex][indexCount][center][radius][apex][axis][cutoff]
+        w.U32(static_cast<uint32_t>(mesh.mMeshlets.size()));
+        for (const Meshlet& meshlet : mesh.mMeshlets)
+        {
+            w.U32(meshlet.firstIndex);
+            w.U32(meshlet.indexCount);
+            w.Vec3(meshlet.center);
+            w.F32(meshlet.radius);
+            w.Vec3(meshlet.coneApex);
+            w.Vec3(meshlet.coneAxis);
+            w.F32(meshlet.coneCutoff);
+        }
+
         // Texture KTX2 paths
         WriteTexturePathEntry(refs.tex[0]);
         WriteTexturePathEntry(refs.tex[1]);
@@ -345,7 +375,8 @@ bool ModelSerializer::load(Model& model, const std::string& filename)
         return false;
     }
 
-    if (!validateHeader(file))
+    uint32_t version = 0;
+    if (!validateHeader(file, version))
     {
         file.close();
         std::filesystem::remove(tempRaw);
@@ -355,6 +386,7 @@ bool ModelSerializer::load(Model& model, const std::string& filename)
     BinaryReaderLE r(file);
 
     uint32_t hasAnimation = r.U32();
+    model.mCooked = version >= COOKED_VERSION;
 
     model.mMeshes.clear();
 
@@ -367,10 +399,7 @@ bool ModelSerializer::load(Model& model, const std::string& filename)
 
     for (auto& meshPtr : model.mMeshes)
     {
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-            meshPtr = std::make_unique<VKMesh>();
-        else
-            meshPtr = std::make_unique<GLMesh>();
+        meshPtr = IMesh::Create();
 
         auto& mesh = *meshPtr;
 
@@ -399,6 +428,35 @@ bool ModelSerializer::load(Model& model, const std::string& filename)
         for (uint32_t i = 0; i < indexCount; ++i)
             mesh.mIndices[i] = r.U32();
 
+        if (version >= LOD_VERSION)
+        {
+            mesh.mLODs.resize(r.U32());
+            for (MeshLOD& lod : mesh.mLODs)
+            {
+                lod.error = r.F32();
+                lod.indices.resize(r.U32());
+                for (uint32_t& idxVal : lod.indices)
+                    idxVal = r.U32();
+            }
+        }
+
+        if (version >= MESHLET_VERSION)
+        {
+            mesh.mMeshlets.resize(r.U32());
+            for (Meshlet& meshlet : mesh.mMeshlets)
+            {
+                meshlet.firstIndex = r.U32();
+                meshlet.indexCount = r.U32();
+                meshlet.center = r.Vec3();
+                meshlet.radius = r.F32();
+                meshlet.coneApex = r.Vec3();
+                meshlet.coneAxis = r.Vec3();
+                meshlet.coneCutoff = r.F32();
+            }
+        }
+
+        mesh.ComputeBounds();
+
         // Textures
         auto ReadTextureData = [&](std::string& texturePath, std::vector<unsigned char>& textureData)
             {
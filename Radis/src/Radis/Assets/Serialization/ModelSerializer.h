@@ -20,9 +20,15 @@ namespace Radis
     private:
         // Magic number for format verification
         static constexpr uint32_t MAGIC_NUMBER = 0x4D4F444C; // 'MODL'
-        static constexpr uint32_t VERSION = 2;
+        static constexpr uint32_t VERSION = 5;
+        // Oldest version load still reads. 2 has no LOD chains, 3 predates the GPU optimization
+        // pass and 4 has no meshlets, such models are cooked again after loading.
+        static constexpr uint32_t MIN_VERSION = 2;
+        static constexpr uint32_t LOD_VERSION = 3;      // first with per-mesh LOD chains
+        static constexpr uint32_t MESHLET_VERSION = 5;  // first with meshlets
+        static constexpr uint32_t COOKED_VERSION = 5;
 
         // Validate the file header and version
-        static bool validateHeader(std::ifstream& file);
+        static bool validateHeader(std::ifstream& file, uint32_t& outVersion);
     };
 }
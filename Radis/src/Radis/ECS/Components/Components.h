@@ -4,6 +4,8 @@
 
 namespace Radis {
 
+	class Model;
+
 	struct TagComponent
 	{
 		std::string Tag;
@@ -27,6 +29,30 @@ namespace Radis {
 		glm::mat3 normalMatrix() const;
 	};
 
+	// Parent/child links, edited through ECS::SetParent. A child's TransformComponent is relative to its parent.
+	// Children are kept in an intrusive list: Parent.FirstChild -> NextSibling -> ...
+	struct HierarchyComponent
+	{
+		entt::entity Parent = entt::null;
+		entt::entity FirstChild = entt::null;
+		entt::entity NextSibling = entt::null;
+		entt::entity PrevSibling = entt::null;
+	};
+
+	// Matrices cached by TransformSystem, rebuilt only when the TRS (or a parent's) changes.
+	// Added automatically with TransformComponent and never serialized.
+	struct WorldTransformComponent
+	{
+		glm::mat4 Local = glm::mat4(1.0f); // TransformComponent::GetTransform()
+		glm::mat4 World = glm::mat4(1.0f); // parent World * Local, or Local for roots
+		uint32_t LocalFrame = 0;           // TransformSystem frame Local was last rebuilt on
+
+		// TRS that World was built from. NaN never compares equal, so new entities build on their first frame.
+		glm::vec3 BuiltTranslation = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+		glm::vec3 BuiltRotation = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+		glm::vec3 BuiltScale = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+	};
+
 	struct ModelComponent
 	{
 		std::string ModelPath = "";
@@ -38,6 +64,23 @@ namespace Radis {
         float roughnessOverride = 1.0f;
 	};
 
+	// Instance table slots of a ModelComponent, one per mesh, and what they were last written from.
+	// Managed by RenderSystem, unchanged entities skip the upload.
+	struct RenderInstanceComponent
+	{
+		uint32_t FirstSlot = UINT32_MAX;
+		uint32_t SlotCount = 0;
+
+		const Model* BuiltModel = nullptr;
+		glm::mat4 BuiltWorld = glm::mat4(1.0f);
+		uint32_t BuiltBoneOffset = 0;
+		glm::vec4 BuiltTint = glm::vec4(1.0f);
+		bool BuiltUseMetallicOverride = false;
+		bool BuiltUseRoughnessOverride = false;
+		float BuiltMetallicOverride = 1.0f;
+		float BuiltRoughnessOverride = 1.0f;
+	};
+
 	struct AnimationComponent
 	{
         bool IsPlaying = true;
@@ -87,6 +130,10 @@ namespace Radis {
 		bool isInitialized{ false };
 	};
 
+	// Singleton tag (see ECS::GetSingleton) for the camera the scene is rendered from.
+	// CameraSystem gives it to the first CameraComponent when nobody has it.
+	struct PrimaryCameraTag {};
+
 	struct LightComponent 
 	{
 		enum LightType
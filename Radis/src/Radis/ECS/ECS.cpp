@@ -4,15 +4,51 @@
 #include "Resources/IResource.h"
 #include "Entities/Entity.h"
 #include "Components/Components.h"
+#include "Jobs/JobSystem.h"
 
 namespace Radis
 {
+    namespace
+    {
+        // Removes entity from its parent's child list.
+        void UnlinkFromParent(entt::registry& registry, HierarchyComponent& hc)
+        {
+            if (hc.Parent == entt::null) return;
+
+            if (hc.PrevSibling != entt::null)
+                registry.get<HierarchyComponent>(hc.PrevSibling).NextSibling = hc.NextSibling;
+            else
+                registry.get<HierarchyComponent>(hc.Parent).FirstChild = hc.NextSibling;
+
+            if (hc.NextSibling != entt::null)
+                registry.get<HierarchyComponent>(hc.NextSibling).PrevSibling = hc.PrevSibling;
+
+            hc.Parent = entt::null;
+            hc.NextSibling = entt::null;
+            hc.PrevSibling = entt::null;
+        }
+    }
+
+    uint32_t NextResourceTypeId()
+    {
+        static std::atomic<uint32_t> next{ 0 };
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t NextSingletonTypeId()
+    {
+        static std::atomic<uint32_t> next{ 0 };
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
     ECS::ECS()
         : mSystems()
-        , mEntityMap()
+        , mEntityNames()
         , mRegistry()
     {
-        mResources.reserve(100);
+        mResources.reserve(32);
+        mRegistry.on_destroy<HierarchyComponent>().connect<&ECS::OnHierarchyDestroyed>(this);
+        mRegistry.on_destroy<TagComponent>().connect<&ECS::OnTagDestroyed>(this);
     }
 
     ECS::~ECS()
@@ -21,52 +57,303 @@ namespace Radis
 
     void ECS::Init()
     {
-        // Run Init
-        for (auto& resource : mResources)
+        mCommandBuffers.clear();
+        for (uint32_t i = 0; i < JobSystem::GetWorkerCount() + 1; ++i)
         {
-            resource.second->ecs = this;
+            mCommandBuffers.push_back(std::make_unique<EntityCommandBuffer>(i));
         }
 
+        // Run Init
         for (auto& system : mSystems)
         {
             system->ecs = this;
             system->Init();
         }
+
+        BuildSchedule();
+    }
+
+    void ECS::BuildSchedule()
+    {
+        const uint32_t count = static_cast<uint32_t>(mSystems.size());
+
+        mSchedule.clear();
+        mSchedule.resize(count);
+        mPendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(count);
+
+        // Conflicting pairs always run in registration order, so the result doesn't depend on timing.
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const SystemAccess& access = mSystems[i]->GetAccess();
+            const std::string& name = mSystems[i]->GetDebugName();
+            mSchedule[i].frameStartScope = Profiler::RegisterScope((name + "::FrameStart").c_str());
+            mSchedule[i].updateScope = Profiler::RegisterScope((name + "::Update").c_str());
+            mSchedule[i].fixedUpdateScope = Profiler::RegisterScope((name + "::FixedUpdate").c_str());
+            mSchedule[i].frameEndScope = Profiler::RegisterScope((name + "::FrameEnd").c_str());
+
+            if (!access.IsDeclared())
+            {
+                RADIS_WARN("{0} does not declare its access; it will run exclusively.", mSystems[i]->GetDebugName());
+            }
+
+            for (uint32_t j = 0; j < i; ++j)
+            {
+                if (access.ConflictsWith(mSystems[j]->GetAccess()))
+                {
+                    mSchedule[j].successors.push_back(i);
+                    ++mSchedule[i].dependencyCount;
+                }
+            }
+        }
     }
 
     void ECS::FrameStart()
     {
         PROFILE_SCOPE("ECS::FrameStart");
 
-        for (auto& system : mSystems)
+        for (size_t i = 0; i < mSystems.size(); ++i)
         {
-            std::string profileName = system->GetDebugName() + "::FrameStart";
-            PROFILE_SCOPE(profileName.c_str());
-            system->FrameStart();
+            PROFILE_SCOPE_ID(mSchedule[i].frameStartScope);
+            SetCommandSortKey(static_cast<uint32_t>(i));
+            mSystems[i]->FrameStart();
         }
+        SetCommandSortKey(~0u);
+
+        PlaybackCommands();
+    }
+
+    void ECS::FixedUpdate(float fixedDt)
+    {
+        PROFILE_SCOPE("ECS::FixedUpdate");
+        RunPhase(&ISystem::FixedUpdate, &ScheduledSystem::fixedUpdateScope, fixedDt);
     }
 
     void ECS::Update(float dt)
     {
         PROFILE_SCOPE("ECS::Update");
+        RunPhase(&ISystem::Update, &ScheduledSystem::updateScope, dt);
+    }
 
-        for (auto& system : mSystems)
+    void ECS::RunPhase(void (ISystem::*phase)(float), uint32_t ScheduledSystem::*scope, float dt)
+    {
+        mPhase = phase;
+        mPhaseScope = scope;
+
+        const uint32_t count = static_cast<uint32_t>(mSystems.size());
+
+        // No workers - keep the plain sequential path.
+        if (JobSystem::GetWorkerCount() == 0)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                PROFILE_SCOPE_ID(mSchedule[i].*scope);
+                SetCommandSortKey(i);
+                (mSystems[i].get()->*phase)(dt);
+            }
+            SetCommandSortKey(~0u);
+
+            PlaybackCommands();
+            return;
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            mSystems[i]->GetAccess().AssureStorage(mRegistry);
+            mPendingDependencies[i].store(mSchedule[i].dependencyCount, std::memory_order_relaxed);
+            mSchedule[i].ranOnWorker = false;
+        }
+        mSystemsRemaining.store(count, std::memory_order_release);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (mSchedule[i].dependencyCount == 0)
+            {
+                DispatchSystem(i, dt);
+            }
+        }
+
+        // The main thread runs main-thread-only systems and otherwise helps with queued jobs.
+        while (mSystemsRemaining.load(std::memory_order_acquire) > 0)
+        {
+            uint32_t index = 0;
+            bool haveMainThreadSystem = false;
+            {
+                std::lock_guard<std::mutex> lock(mMainThreadQueueMutex);
+                if (!mMainThreadQueue.empty())
+                {
+                    index = mMainThreadQueue.front();
+                    mMainThreadQueue.erase(mMainThreadQueue.begin());
+                    haveMainThreadSystem = true;
+                }
+            }
+
+            if (haveMainThreadSystem)
+            {
+                RunScheduledSystem(index, dt);
+            }
+            else if (!JobSystem::TryRunPendingJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Worker threads can't touch the profiler, report their timings now.
+        for (const ScheduledSystem& scheduled : mSchedule)
         {
-            std::string profileName = system->GetDebugName() + "::Update";
-            PROFILE_SCOPE(profileName.c_str());
-            system->Update(dt);
+            if (scheduled.ranOnWorker)
+            {
+                Profiler::RecordScope(scheduled.*scope, scheduled.startNs, scheduled.endNs);
+            }
         }
+
+        PlaybackCommands();
+    }
+
+    void ECS::DispatchSystem(uint32_t index, float dt)
+    {
+        if (mSystems[index]->RunsOnMainThread())
+        {
+            std::lock_guard<std::mutex> lock(mMainThreadQueueMutex);
+            mMainThreadQueue.push_back(index);
+            return;
+        }
+
+        JobSystem::Submit([this, index, dt] { RunScheduledSystem(index, dt); });
+    }
+
+    void ECS::RunScheduledSystem(uint32_t index, float dt)
+    {
+        ScheduledSystem& scheduled = mSchedule[index];
+
+        // Waits inside a system can run another system on this thread, so restore the key after.
+        const uint32_t previousSortKey = SetCommandSortKey(index);
+
+        if (JobSystem::IsMainThread())
+        {
+            PROFILE_SCOPE_ID(scheduled.*mPhaseScope);
+            (mSystems[index].get()->*mPhase)(dt);
+        }
+        else
+        {
+            scheduled.startNs = Profiler::Now();
+            (mSystems[index].get()->*mPhase)(dt);
+            scheduled.endNs = Profiler::Now();
+            scheduled.ranOnWorker = true;
+        }
+        SetCommandSortKey(previousSortKey);
+
+        for (uint32_t successor : scheduled.successors)
+        {
+            if (mPendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                DispatchSystem(successor, dt);
+            }
+        }
+
+        mSystemsRemaining.fetch_sub(1, std::memory_order_acq_rel);
     }
 
     void ECS::FrameEnd()
     {
         PROFILE_SCOPE("ECS::FrameEnd");
 
-        for (auto& system : mSystems | std::views::reverse)
+        for (size_t i = mSystems.size(); i-- > 0;)
         {
-            std::string profileName = system->GetDebugName() + "::FrameEnd";
-            PROFILE_SCOPE(profileName.c_str());
-            system->FrameEnd();
+            PROFILE_SCOPE_ID(mSchedule[i].frameEndScope);
+            SetCommandSortKey(static_cast<uint32_t>(i));
+            mSystems[i]->FrameEnd();
+        }
+        SetCommandSortKey(~0u);
+
+        PlaybackCommands();
+    }
+
+    EntityCommandBuffer& ECS::Commands()
+    {
+        // Before Init there is only the calling thread.
+        if (mCommandBuffers.empty())
+        {
+            mCommandBuffers.push_back(std::make_unique<EntityCommandBuffer>(0));
+        }
+
+        const uint32_t threadIndex = JobSystem::GetThreadIndex();
+        RADIS_ASSERT(threadIndex < mCommandBuffers.size(), "No command buffer for this thread");
+        return *mCommandBuffers[threadIndex];
+    }
+
+    uint32_t ECS::SetCommandSortKey(uint32_t key)
+    {
+        // Kept in the job context rather than the buffer so ParallelFor chunks a system hands
+        // to other workers record under its key too.
+        return JobSystem::SetJobContext(key);
+    }
+
+    void ECS::PlaybackCommands()
+    {
+        struct PlaybackEntry
+        {
+            uint32_t sortKey;
+            uint32_t pass;      // creates first, so a system's other threads can use its new entities
+            uint32_t buffer;
+            uint32_t command;
+        };
+
+        std::vector<PlaybackEntry> order;
+        for (uint32_t b = 0; b < mCommandBuffers.size(); ++b)
+        {
+            EntityCommandBuffer& buffer = *mCommandBuffers[b];
+            for (uint32_t c = 0; c < buffer.mCommands.size(); ++c)
+            {
+                const EntityCommandBuffer::Command& command = buffer.mCommands[c];
+                const uint32_t pass = command.type == EntityCommandBuffer::CommandType::Create ? 0 : 1;
+                order.push_back({ command.sortKey, pass, b, c });
+            }
+            buffer.mCreated.assign(buffer.mDeferredCount, entt::null);
+        }
+        if (order.empty()) return;
+
+        PROFILE_SCOPE("ECS::PlaybackCommands");
+
+        // Systems in registration order. Every command carries the key of the system it was
+        // recorded under, including ones from its ParallelFor chunks, so the order between systems
+        // doesn't depend on which thread ran what. Within a system, commands from different
+        // threads keep per-thread order only.
+        std::sort(order.begin(), order.end(), [](const PlaybackEntry& a, const PlaybackEntry& b)
+        {
+            return std::tie(a.sortKey, a.pass, a.buffer, a.command) < std::tie(b.sortKey, b.pass, b.buffer, b.command);
+        });
+
+        for (const PlaybackEntry& entry : order)
+        {
+            EntityCommandBuffer& buffer = *mCommandBuffers[entry.buffer];
+            EntityCommandBuffer::Command& command = buffer.mCommands[entry.command];
+
+            if (command.type == EntityCommandBuffer::CommandType::Create)
+            {
+                buffer.SetCreated(command.target, AddEntity(command.name));
+                continue;
+            }
+
+            const entt::entity handle = EntityCommandBuffer::Resolve(command.target, mCommandBuffers);
+            if (!mRegistry.valid(handle))
+            {
+                // Destroyed by an earlier command (or never created)
+                continue;
+            }
+
+            if (command.type == EntityCommandBuffer::CommandType::Destroy)
+            {
+                RemoveEntity(handle);
+            }
+            else
+            {
+                command.apply(mRegistry, handle);
+            }
+        }
+
+        for (auto& buffer : mCommandBuffers)
+        {
+            buffer->Clear();
         }
     }
 
@@ -77,9 +364,12 @@ namespace Radis
             system->Exit();
         }
 
-        for (auto& resource : mResources)
+        for (auto& slot : mResources)
         {
-            resource.second->Shutdown();
+            if (slot.resource)
+            {
+                slot.resource->Shutdown();
+            }
         }
     }
 
@@ -90,21 +380,69 @@ namespace Radis
         entity.AddComponent<TagComponent>(name);
         entity.AddComponent<TransformComponent>();
 
-        mEntityMap[name] = entity;
+        if (!name.empty())
+        {
+            auto [it, inserted] = mEntityNames.try_emplace(name, entity);
+            if (!inserted)
+            {
+                RADIS_WARN("Entity name '{0}' is already taken; lookups by name keep returning the first one.", name);
+            }
+        }
 
         return entity;
     }
 
     Entity ECS::GetEntity(const std::string& name)
     {
-        auto it = mEntityMap.find(name);
-        if (it == mEntityMap.end())
+        Entity entity = FindEntity(name);
+        if (!entity)
         {
             RADIS_WARN("Entity with name '{0}' not found!", name);
+        }
+
+        return entity;
+    }
+
+    Entity ECS::FindEntity(const std::string& name)
+    {
+        auto it = mEntityNames.find(name);
+        if (it == mEntityNames.end())
+        {
             return Entity();
         }
 
-        return it->second;
+        return Entity(&mRegistry, it->second);
+    }
+
+    void ECS::RenameEntity(entt::entity entity, const std::string& name)
+    {
+        TagComponent& tag = mRegistry.get_or_emplace<TagComponent>(entity);
+        if (tag.Tag == name) return;
+
+        auto it = mEntityNames.find(tag.Tag);
+        if (it != mEntityNames.end() && it->second == entity)
+        {
+            mEntityNames.erase(it);
+        }
+
+        tag.Tag = name;
+        if (!name.empty())
+        {
+            auto [newIt, inserted] = mEntityNames.try_emplace(name, entity);
+            if (!inserted)
+            {
+                RADIS_WARN("Entity name '{0}' is already taken; lookups by name keep returning the first one.", name);
+            }
+        }
+    }
+
+    void ECS::OnTagDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        auto it = mEntityNames.find(registry.get<TagComponent>(entity).Tag);
+        if (it != mEntityNames.end() && it->second == entity)
+        {
+            mEntityNames.erase(it);
+        }
     }
 
     Entity ECS::CloneEntity(const Entity& entity)
@@ -114,24 +452,32 @@ namespace Radis
 
         // Iterate over all component storage pools
         for (auto [id, storage] : mRegistry.storage()) {
-            if (storage.contains(handle)) {
+            // Skip pools already filled by construction hooks (e.g. WorldTransformComponent)
+            if (storage.contains(handle) && !storage.contains(clone)) {
                 storage.push(clone, storage.value(handle));
             }
         }
 
+        // The copied links belong to the source entity; only keep its parent.
+        if (auto* hc = mRegistry.try_get<HierarchyComponent>(clone))
+        {
+            const entt::entity parent = hc->Parent;
+            *hc = HierarchyComponent{};
+            SetParent(clone, parent);
+        }
+
         return Entity(&mRegistry, clone);
     }
 
     void ECS::RemoveEntity(const std::string& name)
     {
-        auto it = mEntityMap.find(name);
-        if (it == mEntityMap.end())
+        auto it = mEntityNames.find(name);
+        if (it == mEntityNames.end())
         {
             RADIS_WARN("Entity with name '{0}' not found!", name);
             return;
         }
-        mRegistry.destroy(it->second);
-        mEntityMap.erase(it);
+        mRegistry.destroy(it->second); // OnTagDestroyed drops the index entry
     }
 
     void ECS::RemoveEntity(Entity entity)
@@ -144,4 +490,68 @@ namespace Radis
         mRegistry.destroy(entity);
     }
 
+    void ECS::SetParent(entt::entity child, entt::entity parent)
+    {
+        if (!mRegistry.valid(child) || (parent != entt::null && !mRegistry.valid(parent)))
+        {
+            RADIS_WARN("SetParent called with an invalid entity.");
+            return;
+        }
+
+        for (entt::entity ancestor = parent; ancestor != entt::null;)
+        {
+            if (ancestor == child)
+            {
+                RADIS_WARN("SetParent would make an entity its own ancestor; ignoring.");
+                return;
+            }
+            const auto* ancestorHc = mRegistry.try_get<HierarchyComponent>(ancestor);
+            ancestor = ancestorHc ? ancestorHc->Parent : entt::null;
+        }
+
+        // Emplace the parent first so no reference below is taken before a pool insert.
+        HierarchyComponent* parentHc = parent != entt::null ? &mRegistry.get_or_emplace<HierarchyComponent>(parent) : nullptr;
+        HierarchyComponent& hc = mRegistry.get_or_emplace<HierarchyComponent>(child);
+        if (hc.Parent == parent) return;
+
+        UnlinkFromParent(mRegistry, hc);
+
+        if (parentHc)
+        {
+            hc.Parent = parent;
+            hc.NextSibling = parentHc->FirstChild;
+            if (parentHc->FirstChild != entt::null)
+            {
+                mRegistry.get<HierarchyComponent>(parentHc->FirstChild).PrevSibling = child;
+            }
+            parentHc->FirstChild = child;
+        }
+
+        // Lets on_update listeners (TransformSystem) pick up the new layout.
+        mRegistry.patch<HierarchyComponent>(child);
+    }
+
+    entt::entity ECS::GetParent(entt::entity entity) const
+    {
+        const auto* hc = mRegistry.try_get<HierarchyComponent>(entity);
+        return hc ? hc->Parent : entt::null;
+    }
+
+    void ECS::OnHierarchyDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        HierarchyComponent& hc = registry.get<HierarchyComponent>(entity);
+        UnlinkFromParent(registry, hc);
+
+        for (entt::entity child = hc.FirstChild; child != entt::null;)
+        {
+            HierarchyComponent& childHc = registry.get<HierarchyComponent>(child);
+            const entt::entity next = childHc.NextSibling;
+            childHc.Parent = entt::null;
+            childHc.NextSibling = entt::null;
+            childHc.PrevSibling = entt::null;
+            child = next;
+        }
+        hc.FirstChild = entt::null;
+    }
+
 }
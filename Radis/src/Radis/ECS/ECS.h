@@ -2,12 +2,19 @@
 
 #include "Systems/ISystem.h"
 #include "Entities/Entity.h"
+#include "EntityCommandBuffer.h"
 
 namespace Radis
 {
     class Entity;
     struct IResource;
 
+    uint32_t NextSingletonTypeId();
+
+    // Dense per-type index into ECS::mSingletons.
+    template<typename T>
+    inline const uint32_t SingletonTypeId = NextSingletonTypeId();
+
     class ECS
     {
     public:
@@ -21,6 +28,7 @@ namespace Radis
 
         void Init();
         void FrameStart();
+        void FixedUpdate(float fixedDt); // zero or more times per frame, see Engine::Run
         void Update(float dt);
         void FrameEnd();
         void Exit();
@@ -37,50 +45,170 @@ namespace Radis
         void AddResource(Args&&... args) {
             static_assert(std::is_base_of<IResource, T>::value, "Resource type must inherit from Radis::IResource");
 
-            const auto typeId = std::type_index(typeid(T));
-
-            auto [it, inserted] = mResources.try_emplace(typeId, std::make_unique<T>(std::forward<Args>(args)...));
-
-            if (!inserted) {
+            ResourceSlot& slot = GetResourceSlot(ResourceTypeId<T>);
+            if (slot.resource) {
                 RADIS_ERROR("Resource of type '{0}' already exists.", typeid(T).name());
+                return;
             }
+
+            slot.resource = std::make_unique<T>(std::forward<Args>(args)...);
+            slot.resource->ecs = this;
         }
 
-        // Gets a pointer to the resource of the specified type.
+        // Gets a pointer to the resource of the specified type, or nullptr if it hasn't been added.
+        // A slot only ever holds a T, so no dynamic_cast is needed.
         template<typename T>
         T* GetResource() {
-            static T* cachedResource = [this]
-            {
-                const auto typeId = std::type_index(typeid(T));
-                auto it = mResources.find(typeId);
-
-                if (it == mResources.end()) {
-                    return static_cast<T*>(nullptr);
-                }
-
-                return dynamic_cast<T*>(it->second.get());
-            }();
+            const uint32_t id = ResourceTypeId<T>;
+            if (id >= mResources.size()) {
+                return nullptr;
+            }
 
-            return cachedResource;
+            return static_cast<T*>(mResources[id].resource.get());
         }
 
         Entity AddEntity(const std::string& name = "");
+
+        // Name lookups go through an index kept in sync with TagComponent. Names should be unique;
+        // duplicates are reported and resolve to the entity that claimed the name first.
         Entity GetEntity(const std::string& name);
+        Entity FindEntity(const std::string& name); // like GetEntity, without the warning
+        void RenameEntity(entt::entity entity, const std::string& name);
         Entity CloneEntity(const Entity& entity);
         void RemoveEntity(const std::string& name);
         void RemoveEntity(Entity entity);
         void RemoveEntity(entt::entity entity);
-        
+
+        // Links child under parent, or detaches it when parent is entt::null. The child's
+        // TransformComponent becomes relative to the parent; cycles are refused.
+        void SetParent(entt::entity child, entt::entity parent);
+        entt::entity GetParent(entt::entity entity) const;
+
+        // Entity holding the singleton tag T (e.g. PrimaryCameraTag), or entt::null. The handle is
+        // cached and only looked up again after T is added or removed somewhere. Main thread only.
+        template<typename T>
+        entt::entity GetSingleton()
+        {
+            const uint32_t id = SingletonTypeId<T>;
+            if (id >= mSingletons.size()) {
+                mSingletons.resize(id + 1);
+            }
+
+            SingletonSlot& slot = mSingletons[id];
+            if (!slot.connected) {
+                mRegistry.on_construct<T>().template connect<&ECS::OnSingletonChanged<T>>(this);
+                mRegistry.on_destroy<T>().template connect<&ECS::OnSingletonChanged<T>>(this);
+                slot.connected = true;
+            }
+
+            if (slot.dirty) {
+                auto& storage = mRegistry.storage<T>();
+                slot.entity = storage.empty() ? entt::entity{ entt::null } : *storage.begin();
+                slot.dirty = false;
+
+                if (storage.size() > 1) {
+                    RADIS_WARN("{0} entities have singleton '{1}'.", storage.size(), typeid(T).name());
+                }
+            }
+
+            return slot.entity;
+        }
+
+        // Moves singleton tag T onto entity.
+        template<typename T>
+        void SetSingleton(entt::entity entity)
+        {
+            mRegistry.clear<T>();
+            mRegistry.emplace<T>(entity);
+        }
+
+        // Deferred structural changes for the calling thread. Safe to use from any system,
+        // including ones running on workers; applied at the end of the current phase.
+        EntityCommandBuffer& Commands();
+
 
         entt::registry& GetRegistry() { return mRegistry; }
 
     private:
+        // Update scheduling
+        void BuildSchedule();
+        void DispatchSystem(uint32_t index, float dt);
+        void RunScheduledSystem(uint32_t index, float dt);
+
+        // Applies every thread's command buffer, ordered by the system that recorded it.
+        void PlaybackCommands();
+
+        // Tags commands recorded on this thread, and by jobs it submits, with the running system;
+        // returns the previous key.
+        uint32_t SetCommandSortKey(uint32_t key);
+
+        template<typename T>
+        void OnSingletonChanged(entt::registry&, entt::entity)
+        {
+            mSingletons[SingletonTypeId<T>].dirty = true;
+        }
+
+        // Keeps mEntityNames in sync when an entity or its tag goes away
+        void OnTagDestroyed(entt::registry& registry, entt::entity entity);
+
+        // Children of a destroyed entity become roots
+        void OnHierarchyDestroyed(entt::registry& registry, entt::entity entity);
+
+        struct ResourceSlot
+        {
+            std::unique_ptr<IResource> resource;
+        };
+
+        ResourceSlot& GetResourceSlot(uint32_t id)
+        {
+            if (id >= mResources.size()) {
+                mResources.resize(id + 1);
+            }
+            return mResources[id];
+        }
+
+        struct SingletonSlot
+        {
+            entt::entity entity = entt::null;
+            bool dirty = true;
+            bool connected = false;
+        };
+
+        struct ScheduledSystem
+        {
+            std::vector<uint32_t> successors;   // later systems that conflict with this one
+            uint32_t dependencyCount = 0;       // earlier systems this one has to wait for
+            uint32_t frameStartScope = 0;       // profiler ids, registered once in BuildSchedule
+            uint32_t updateScope = 0;
+            uint32_t fixedUpdateScope = 0;
+            uint32_t frameEndScope = 0;
+            uint64_t startNs = 0;
+            uint64_t endNs = 0;
+            bool ranOnWorker = false;
+        };
+
+        // Runs one parallel phase (Update/FixedUpdate) over the schedule
+        void RunPhase(void (ISystem::*phase)(float), uint32_t ScheduledSystem::*scope, float dt);
+
         // Systems/Resources
         std::vector<std::unique_ptr<ISystem>> mSystems;
-        std::unordered_map<std::type_index, std::unique_ptr<IResource>> mResources;
+        std::vector<ResourceSlot> mResources; // indexed by ResourceTypeId<T>
         
         // Entities
         entt::registry mRegistry;
-        std::unordered_map<std::string, Entity> mEntityMap;
+        std::unordered_map<std::string, entt::entity> mEntityNames;
+        std::vector<SingletonSlot> mSingletons; // indexed by SingletonTypeId<T>
+
+        // One per job system thread, indexed by JobSystem::GetThreadIndex()
+        std::vector<std::unique_ptr<EntityCommandBuffer>> mCommandBuffers;
+
+        // Update DAG and per-system profiler ids, rebuilt on Init
+        std::vector<ScheduledSystem> mSchedule;
+        std::unique_ptr<std::atomic<uint32_t>[]> mPendingDependencies;
+        void (ISystem::*mPhase)(float) = &ISystem::Update;           // phase RunPhase is dispatching
+        uint32_t ScheduledSystem::*mPhaseScope = &ScheduledSystem::updateScope;
+        std::atomic<uint32_t> mSystemsRemaining{ 0 };
+        std::mutex mMainThreadQueueMutex;
+        std::vector<uint32_t> mMainThreadQueue;
     };
 }
@@ -0,0 +1,39 @@
+#include <PCH/pch.h>
+#include "EntityCommandBuffer.h"
+
+#include "Jobs/JobSystem.h"
+
+namespace Radis
+{
+    EntityCommandBuffer::EntityRef EntityCommandBuffer::CreateEntity(const std::string& name)
+    {
+        EntityRef ref;
+        ref.mBuffer = mIndex;
+        ref.mDeferredIndex = mDeferredCount++;
+        Record(CommandType::Create, ref, nullptr, name);
+        return ref;
+    }
+
+    void EntityCommandBuffer::DestroyEntity(EntityRef entity)
+    {
+        Record(CommandType::Destroy, entity, nullptr);
+    }
+
+    void EntityCommandBuffer::Record(CommandType type, EntityRef target, Apply apply, std::string name)
+    {
+        // The ECS sets the sort key as the job context, so jobs a system fans out inherit it.
+        mCommands.push_back({ JobSystem::GetJobContext(), type, target, std::move(name), std::move(apply) });
+    }
+
+    entt::entity EntityCommandBuffer::Resolve(const EntityRef& ref, std::span<const std::unique_ptr<EntityCommandBuffer>> buffers)
+    {
+        return ref.IsDeferred() ? buffers[ref.mBuffer]->mCreated[ref.mDeferredIndex] : ref.mHandle;
+    }
+
+    void EntityCommandBuffer::Clear()
+    {
+        mCommands.clear();
+        mCreated.clear();
+        mDeferredCount = 0;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Entities/Entity.h"
+
+namespace Radis
+{
+    // Records entity creation/destruction and component add/remove so they can be applied later
+    // at a sync point instead of while views are being iterated. Get one with ECS::Commands();
+    // the ECS plays every thread's buffer back on the main thread after FrameStart, Update and FrameEnd.
+    class EntityCommandBuffer
+    {
+    public:
+        // An existing entity, or one created through a command buffer. Created entities only
+        // exist after playback, so their references stop meaning anything once it has run.
+        // References can be handed to other threads; they remember which buffer created them.
+        class EntityRef
+        {
+        public:
+            EntityRef(entt::entity handle) : mHandle(handle) {}
+            EntityRef(const Entity& entity) : mHandle(entity) {}
+
+            bool IsDeferred() const { return mDeferredIndex != NOT_DEFERRED; }
+
+        private:
+            friend class EntityCommandBuffer;
+            static constexpr uint32_t NOT_DEFERRED = ~0u;
+
+            EntityRef() = default;
+
+            entt::entity mHandle = entt::null;
+            uint32_t mBuffer = 0;                   // buffer that recorded the create
+            uint32_t mDeferredIndex = NOT_DEFERRED;
+        };
+
+        explicit EntityCommandBuffer(uint32_t index) : mIndex(index) {}
+
+        // Same as ECS::AddEntity (tag + transform) once played back.
+        EntityRef CreateEntity(const std::string& name = "");
+        void DestroyEntity(EntityRef entity);
+
+        template<typename T, typename... Args>
+        void AddComponent(EntityRef entity, Args&&... args)
+        {
+            Record(CommandType::Component, entity, [component = T{ std::forward<Args>(args)... }](entt::registry& registry, entt::entity handle) mutable
+            {
+                registry.emplace_or_replace<T>(handle, std::move(component));
+            });
+        }
+
+        template<typename T>
+        void RemoveComponent(EntityRef entity)
+        {
+            Record(CommandType::Component, entity, [](entt::registry& registry, entt::entity handle)
+            {
+                registry.remove<T>(handle);
+            });
+        }
+
+        bool IsEmpty() const { return mCommands.empty(); }
+
+    private:
+        friend class ECS;
+
+        using Apply = std::move_only_function<void(entt::registry&, entt::entity)>;
+
+        // Create/Destroy go through ECS::AddEntity/RemoveEntity so the name map stays in sync.
+        enum class CommandType { Create, Destroy, Component };
+
+        struct Command
+        {
+            uint32_t sortKey;       // index of the system that recorded it (the job context)
+            CommandType type;
+            EntityRef target;
+            std::string name;       // Create only
+            Apply apply;            // Component only
+        };
+
+        void Record(CommandType type, EntityRef target, Apply apply, std::string name = {});
+        void SetCreated(const EntityRef& ref, entt::entity handle) { mCreated[ref.mDeferredIndex] = handle; }
+        void Clear();
+
+        // Looks a deferred reference up in the buffer that created it.
+        static entt::entity Resolve(const EntityRef& ref, std::span<const std::unique_ptr<EntityCommandBuffer>> buffers);
+
+        std::vector<Command> mCommands;
+        std::vector<entt::entity> mCreated; // deferred index -> real entity, filled during playback
+        uint32_t mDeferredCount = 0;
+        uint32_t mIndex = 0;                // position in the ECS's per-thread buffers
+    };
+}
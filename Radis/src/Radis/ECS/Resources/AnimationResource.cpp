@@ -5,6 +5,5 @@ namespace Radis
 {
     AnimationResource::AnimationResource()
     {
-        bonesMatrices.reserve(10000);
     }
 }
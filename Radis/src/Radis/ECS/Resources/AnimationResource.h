@@ -8,6 +8,8 @@ namespace Radis
     {
         AnimationResource();
 
-        std::vector<VQS> bonesMatrices;
+        // Where this frame's bone VQS landed in the frame ring buffer
+        uint32_t boneOffset = 0;
+        uint32_t boneCount = 0;
     };
 }
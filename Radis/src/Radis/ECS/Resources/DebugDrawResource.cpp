@@ -12,24 +12,29 @@ namespace Radis
     std::vector<DebugDrawResource::Rect> DebugDrawResource::rects{};
     std::vector<DebugDrawResource::Cube> DebugDrawResource::cubes{};
     std::vector<DebugDrawResource::Circle> DebugDrawResource::circles{};
+    std::mutex DebugDrawResource::drawMutex;
 
     void DebugDrawResource::DrawLine(const glm::vec3& start, const glm::vec3& end, const glm::vec4& color, float thickness)
     {
+        std::lock_guard<std::mutex> lock(drawMutex);
         lines.emplace_back(start, end, color, thickness);
     }
 
     void DebugDrawResource::DrawRect(const glm::vec3& center, const glm::vec2& size, const glm::vec4& color)
     {
+        std::lock_guard<std::mutex> lock(drawMutex);
         rects.emplace_back(center, size, color);
     }
 
     void DebugDrawResource::DrawCube(const glm::vec3& center, const glm::vec3& size, const glm::vec4& color)
     {
+        std::lock_guard<std::mutex> lock(drawMutex);
         cubes.emplace_back(center, size, color);
     }
 
     void DebugDrawResource::DrawCircle(const glm::vec3& center, float radius, const glm::vec4& color)
     {
+        std::lock_guard<std::mutex> lock(drawMutex);
         circles.emplace_back(center, radius, color); 
     }
 
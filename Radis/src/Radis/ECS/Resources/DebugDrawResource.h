@@ -30,6 +30,9 @@ namespace Radis
         static void DrawEditorGrid(int gridSize = 50, float step = 1.0f);
 
     private:
+        // Draw* can be called from systems running on job threads.
+        static std::mutex drawMutex;
+
         struct Line
         {
             glm::vec3 start;
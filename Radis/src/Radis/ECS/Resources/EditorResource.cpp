@@ -74,6 +74,19 @@ namespace Radis
 			throw std::runtime_error("Failed to create descriptor set layout!");
 		}
 
+		// Freed with the pool
+		std::vector<VkDescriptorSetLayout> viewportLayouts(SwapChain::MAX_FRAMES_IN_FLIGHT, samplerSetLayout);
+		viewportSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = descriptorPool;
+		allocInfo.descriptorSetCount = static_cast<uint32_t>(viewportSets.size());
+		allocInfo.pSetLayouts = viewportLayouts.data();
+		if (vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, viewportSets.data()) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to allocate viewport descriptor sets!");
+		}
+
 		// init imgui
 		IMGUI_CHECKVERSION();
 		ImGui::CreateContext();
@@ -153,6 +166,7 @@ namespace Radis
 				vkDestroyDescriptorPool(device->GetDevice(), descriptorPool, nullptr);
 				descriptorPool = VK_NULL_HANDLE;
 			}
+			viewportSets.clear();
 		}
 		else
 		{
@@ -22,6 +22,11 @@ namespace Radis
         VkDescriptorPool descriptorPool;
         VkDescriptorSetLayout samplerSetLayout;
 
+        // What the scene window shows, one set per frame in flight. The render graph texture is
+        // only known once the graph executes, the ImGui pass points this frame's set at it.
+        std::vector<VkDescriptorSet> viewportSets;
+        std::string viewportTexture = "SceneColor";
+
         float sceneWindowX = 1.f;
         float sceneWindowY = 1.f;
         float sceneWindowWidth = 1.f;
@@ -29,7 +34,6 @@ namespace Radis
         bool renderRaytracingHeatmap = false;
 
         Entity selectedEntity;
-        Entity entityToDelete;
 
         bool GetImGuiInitialized() { return isInitialized; }
 
@@ -2,6 +2,13 @@
 
 namespace Radis
 {
+    // Dense, process-wide ids for resource types, handed out on first use. The same id is
+    // valid in every ECS instance and indexes straight into its resource table.
+    uint32_t NextResourceTypeId();
+
+    template<typename T>
+    inline const uint32_t ResourceTypeId = NextResourceTypeId();
+
     struct IResource
     {
     public:
@@ -189,13 +189,13 @@ namespace Radis
         tlasInstances.reserve(64);
 
         auto& registry = ecs->GetRegistry();
-        auto entityView = registry.view<ModelComponent, TransformComponent>();
+        auto entityView = registry.view<ModelComponent, WorldTransformComponent>();
         int instanceIndex = 0;
         for (auto& entityHandle : entityView)
         {
             Entity entity(&registry, entityHandle);
             ModelComponent& mc = entity.GetComponent<ModelComponent>();
-            TransformComponent& tc = entity.GetComponent<TransformComponent>();
+            WorldTransformComponent& wtc = entity.GetComponent<WorldTransformComponent>();
             Model* model = rr->modelLibrary->GetModel(mc.ModelPath);
             if (!model) continue;
 
@@ -203,7 +203,7 @@ namespace Radis
             for (auto& mesh : model->mMeshes)
             {
                 VkAccelerationStructureInstanceKHR asInstance{};
-                asInstance.transform = toTransformMatrixKHR(tc.GetTransform() * model->GetNormalizationMatrix());  // Position of the instance
+                asInstance.transform = toTransformMatrixKHR(wtc.World * model->GetNormalizationMatrix());  // Position of the instance
 
                 asInstance.instanceCustomIndex = instanceIndex++;//mesh->GetID();  // gl_InstanceCustomIndexEXT
                 asInstance.accelerationStructureReference = rr->blasAccel[mesh->GetID()].address;
@@ -8,15 +8,22 @@
 #include "Graphics/Vulkan/Pipeline/Pipeline.h"
 #include "Graphics/Vulkan/Pipeline/RaytracingPipeline.h"
 #include "Graphics/Vulkan/RenderGraph.h"
+#include "Graphics/Vulkan/OcclusionCuller.h"
 #include "Graphics/Vulkan/Texture/VKTexture.h"
 #include "Graphics/Vulkan/VulkanWindow.h"
 #include "Graphics/Vulkan/Uniform/Uniform.h"
 #include "Graphics/Vulkan/Uniform/UniformData.h"
 #include "Graphics/Vulkan/Uniform/Descriptors.h"
+#include "Graphics/Vulkan/VKRingBuffer.h"
+#include "Graphics/Vulkan/VKInstanceTable.h"
+#include "Graphics/Vulkan/ThreadCommandPools.h"
 
 #include "Graphics/OpenGL/GLFrameBuffer.h"
+#include "Graphics/OpenGL/GLRingBuffer.h"
+#include "Graphics/OpenGL/GLInstanceTable.h"
 
 #include "Graphics/Common/ModelLibrary.h"
+#include "Graphics/Common/UnifiedMesh.h"
 #include "Graphics/Common/TextureLibrary.h"
 #include "Graphics/Common/Animation/AnimationLibrary.h"
 #include "Graphics/Common/Animation/Animator.h"
@@ -60,6 +67,9 @@ namespace Radis
             device->SetFormats(linearFormat, srgbFormat);
 
             syncObjects = std::make_unique<Synchronizer>(device->GetDevice(), swapChain->ImageCount());
+            CreateIndirectBuffers();
+            frameRing = std::make_unique<VKRingBuffer>(*device, SwapChain::MAX_FRAMES_IN_FLIGHT);
+            instanceTable = std::make_unique<VKInstanceTable>(*device);
         }
         else if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL)
         {
@@ -73,6 +83,9 @@ namespace Radis
             fbSpec.samples = 1;
             fbSpec.attachments = { FBAttachment::RGBA8_SRGB, FBAttachment::Depth24Stencil8 };
             sceneFrameBuffer = std::make_unique<GLFrameBuffer>(fbSpec);
+
+            frameRing = std::make_unique<GLRingBuffer>(SwapChain::MAX_FRAMES_IN_FLIGHT);
+            instanceTable = std::make_unique<GLInstanceTable>();
         }
 
         bool recreateTextures = textureLibrary != nullptr;
@@ -102,6 +115,11 @@ namespace Radis
         if (!modelLibrary)
         {
             modelLibrary = std::make_unique<ModelLibrary>(*device, *textureLibrary);
+            if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
+            {
+                // Ray tracing builds its mesh data from the CPU mirror and can be switched on at any time
+                modelLibrary->GetUnifiedMesh()->SetCPUCopiesRequired(true);
+            }
 
             modelLibrary->AddModel(Assets::ModelsPath + "cube.obj", true);
             modelLibrary->AddModel(Assets::ModelsPath + "quad.obj", true);
@@ -149,37 +167,14 @@ namespace Radis
         {
             textureLibrary->RecreateAllBuffers(device.get());
         }
-        if (swapChain)
-        {
-            VkExtent2D extent = swapChain->GetSwapChainExtent();
-
-            // Create scene and depth textures
-            textureLibrary->CreateTexture(
-                "SceneTexture",                 // name
-                extent.width,                   // width
-                extent.height,                  // height
-                device->GetLinearFormat(),      // format
-                VK_IMAGE_TILING_OPTIMAL,        // tiling
-                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, // usage
-                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL // final layout
-            );
-            textureLibrary->CreateTexture(
-                "SceneDepth",                 // name
-                extent.width,                 // width
-                extent.height,                // height
-                swapChain->FindDepthFormat(), // format
-                VK_IMAGE_TILING_OPTIMAL,      // tiling
-                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, // usage
-                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL // final layout
-            );
-        }
 
         modelLibrary->QueueTextures();
         
         if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
         {
             CreateCommandBuffers();
-            renderGraph = std::make_unique<RenderGraph>();
+            threadCommandPools = std::make_unique<ThreadCommandPools>(*device, SwapChain::MAX_FRAMES_IN_FLIGHT);
+            renderGraph = std::make_unique<RenderGraph>(*device);
 
             cameraUniform = std::make_unique<Uniform>(*device, *this, cameraUniformSettings);
             rtUniform = std::make_unique<Uniform>(*device, *this, rayTracingUniformSettings);
@@ -212,6 +207,8 @@ namespace Radis
                 *device,
                 rtunis
             );
+
+            occlusionCuller = std::make_unique<OcclusionCuller>(*device);
         }
     }
 
@@ -250,13 +247,23 @@ namespace Radis
                 animationLibrary.reset();
             }
             renderGraph.reset();
+            threadCommandPools.reset();
             cameraUniform.reset();
             rtUniform.reset();
             pipeline.reset();
             wireframePipeline.reset();
             raytracingPipeline.reset();
+            occlusionCuller.reset();
+            instanceTable.reset();
+            frameRing.reset();
             syncObjects.reset();
 
+            for (auto& indirectBuffer : indirectBuffers)
+            {
+                Allocator::DestroyBuffer(indirectBuffer);
+            }
+            indirectBuffers.clear();
+
             for (auto& blas : blasAccel)
             {
                 Allocator::DestroyAcceleration(blas);
@@ -277,6 +284,8 @@ namespace Radis
             if (textureLibrary) textureLibrary->ClearAllBuffers(device.get());
             sceneFrameBuffer.reset();
             shader.reset();
+            instanceTable.reset();
+            frameRing.reset();
             GLShader::CleanupUBO();
         }
     }
@@ -327,6 +336,25 @@ namespace Radis
         }
     }
 
+    void RenderingResource::CreateIndirectBuffers()
+    {
+        const VkDeviceSize bufferSize = INDIRECT_COMMANDS_OFFSET + sizeof(VkDrawIndexedIndirectCommand) * MAX_INDIRECT_DRAWS;
+
+        indirectBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (Buffer& indirectBuffer : indirectBuffers)
+        {
+            // Rewritten by the CPU every frame, so keep it host visible and mapped
+            Allocator::CreateBuffer(
+                indirectBuffer,
+                bufferSize,
+                VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT_KHR | VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR,
+                VMA_MEMORY_USAGE_AUTO,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+            );
+            Allocator::SetAllocationName(indirectBuffer.allocation, "Indirect Draw Buffer");
+        }
+    }
+
     VkFormat RenderingResource::ToLinearFormat(VkFormat format)
     {
         if (format == VK_FORMAT_R8G8B8A8_SRGB) {
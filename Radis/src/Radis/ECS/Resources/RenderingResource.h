@@ -20,6 +20,10 @@ namespace Radis
     class AnimationLibrary;
     class GLFrameBuffer;
     class GLShader;
+    class OcclusionCuller;
+    class FrameRingBuffer;
+    class InstanceTable;
+    class ThreadCommandPools;
 
     struct RenderingResource : public IResource
     {
@@ -44,10 +48,25 @@ namespace Radis
         //std::unique_ptr<Uniform> instanceUniform;
         // -------------------------
 
+        // Per-frame instance, bone and light data, written in place by the systems and bound by offset
+        std::unique_ptr<FrameRingBuffer> frameRing;
+
+        // Instance data that persists across frames, the draws index it through a per-frame slot list
+        std::unique_ptr<InstanceTable> instanceTable;
+
         std::vector<VkCommandBuffer> commandBuffers;
+        // Secondary command buffers for render graph passes recorded on the job system
+        std::unique_ptr<ThreadCommandPools> threadCommandPools;
         uint32_t currentImageIndex = 0;
         uint32_t currentFrameIndex = 0;
 
+        // Indirect draws, one mapped buffer per frame in flight: the draw count
+        // at offset 0, VkDrawIndexedIndirectCommands from INDIRECT_COMMANDS_OFFSET.
+        // Also written by the occlusion cull shader.
+        static constexpr VkDeviceSize INDIRECT_COMMANDS_OFFSET = 16;
+        static constexpr uint32_t MAX_INDIRECT_DRAWS = 10001; // every instance + the debug cubes
+        std::vector<Buffer> indirectBuffers;
+
         // Scene textures ----------------
         VkImage sceneImage{ VK_NULL_HANDLE };
         VmaAllocation sceneImageAllocation{ VK_NULL_HANDLE };
@@ -66,6 +85,9 @@ namespace Radis
         std::unique_ptr<RaytracingPipeline> raytracingPipeline;
         // -----------
 
+        // Hi-Z occlusion culling of the indirect draws, Vulkan only
+        std::unique_ptr<OcclusionCuller> occlusionCuller;
+
         // OPENGL STUFFS
         std::unique_ptr<GLShader> shader;
         std::unique_ptr<GLFrameBuffer> sceneFrameBuffer;
@@ -78,6 +100,12 @@ namespace Radis
 
         bool renderWireframe = false;
         bool useRaytracing = false;
+        bool useOcclusionCulling = true;
+        bool showOcclusionCulled = false; // debug boxes around the instances the GPU culled
+        bool useMeshLODs = true;
+        float lodPixelError = 1.0f;       // screen-space error a mesh LOD may show, in pixels
+        bool useClusterCulling = true;    // per meshlet frustum culling of meshes drawn at LOD 0
+        bool clusterBackfaceCulling = false; // normal cone rejection, wrong for the double sided Vulkan pipeline
 
         bool supportsVulkan = true;
 
@@ -89,7 +117,8 @@ namespace Radis
         friend class PresentSystem;
         void RecreateSwapChain(IWindow* window);
 
-        void CreateCommandBuffers();        
+        void CreateCommandBuffers();
+        void CreateIndirectBuffers();
         VkFormat ToLinearFormat(VkFormat format);
     };
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "IResource.h"
+
+namespace Radis
+{
+    // Frame and simulation clocks, written by Engine::Run before each phase.
+    struct TimeResource : public IResource
+    {
+        float deltaTime = 0.0f;         // variable frame time passed to Update
+        float fixedDeltaTime = 0.0f;    // step passed to FixedUpdate (1 / EngineSpec::simRate)
+
+        // How far the frame is between the last fixed step and the next one, in [0, 1).
+        // Renderers blend previous/current simulation state with it.
+        float alpha = 0.0f;
+
+        double simulationTime = 0.0;    // sum of all fixed steps taken
+        uint64_t fixedStepCount = 0;
+        uint32_t stepsThisFrame = 0;
+    };
+}
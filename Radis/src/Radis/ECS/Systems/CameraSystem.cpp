@@ -4,6 +4,7 @@
 
 #include "ECS/ECS.h"
 #include "ECS/Components/Components.h"
+#include "ECS/Resources/InputResource.h"
 
 namespace Radis
 {
@@ -18,6 +19,50 @@ namespace Radis
         return a + d * t;
     }
 
+    void CameraSystem::Init()
+    {
+        Access()
+            .Read<InputResource>()
+            .Write<TransformComponent, CameraComponent>();
+
+        entt::registry& registry = ecs->GetRegistry();
+        registry.on_construct<CameraComponent>().connect<&CameraSystem::OnCameraAdded>(this);
+        registry.on_destroy<CameraComponent>().connect<&CameraSystem::OnCameraRemoved>(this);
+        for (auto entityHandle : registry.view<CameraComponent>())
+        {
+            OnCameraAdded(registry, entityHandle);
+        }
+    }
+
+    void CameraSystem::OnCameraAdded(entt::registry& registry, entt::entity entity)
+    {
+        if (registry.storage<PrimaryCameraTag>().empty())
+        {
+            registry.emplace<PrimaryCameraTag>(entity);
+        }
+    }
+
+    void CameraSystem::OnCameraRemoved(entt::registry& registry, entt::entity entity)
+    {
+        // Called before the component goes away. When the entity is being destroyed its tag may
+        // already be gone, so an empty tag storage also means the primary camera was this one.
+        auto& primary = registry.storage<PrimaryCameraTag>();
+        if (!primary.empty() && !primary.contains(entity))
+        {
+            return;
+        }
+
+        registry.remove<PrimaryCameraTag>(entity);
+        for (auto other : registry.view<CameraComponent>())
+        {
+            if (other != entity)
+            {
+                registry.emplace<PrimaryCameraTag>(other);
+                break;
+            }
+        }
+    }
+
     void CameraSystem::Update(float dt)
     {
         if (dt <= 0.0f) return;
@@ -10,9 +10,13 @@ namespace Radis
         CameraSystem() : ISystem("CameraSystem") {};
         ~CameraSystem() {}
 
+        void Init();
         void Update(float dt);
 
     private:
+        void OnCameraAdded(entt::registry& registry, entt::entity entity);
+        void OnCameraRemoved(entt::registry& registry, entt::entity entity);
+
         // Camera control settings
         float mMoveSpeed{ 20.f };
         float mMouseSensitivity{ 0.15f };
@@ -14,6 +14,7 @@
 #include "Graphics/Vulkan/Core/Device.h"
 #include "Graphics/Vulkan/Core/SwapChain.h"
 #include "Graphics/Vulkan/RenderGraph.h"
+#include "Graphics/Common/TextureLibrary.h"
 #include "Graphics/Common/Animation/AnimationLibrary.h"
 #include "Graphics/Common/Animation/Animation.h"
 #include "Graphics/Common/ModelLibrary.h"
@@ -38,6 +39,8 @@ namespace Radis
 {
     void EditorSystem::Init()
     {
+        // The editor UI is built in FrameStart, Update only queues/issues the ImGui draw.
+        Access().Write<RenderingResource, EditorResource>().MainThread();
     }
 
     void EditorSystem::FrameStart()
@@ -86,6 +89,20 @@ namespace Radis
         ImGui::BeginDisabled(!rr->useRaytracing);
         ImGui::Checkbox("Raytracing Heatmap Estimation", &er->renderRaytracingHeatmap);
         ImGui::EndDisabled();
+        ImGui::BeginDisabled(Engine::GetGraphicsAPI() != GraphicsAPI::Vulkan);
+        ImGui::Checkbox("Occlusion Culling", &rr->useOcclusionCulling);
+        ImGui::BeginDisabled(!rr->useOcclusionCulling);
+        ImGui::Checkbox("Show Occluded", &rr->showOcclusionCulled);
+        ImGui::EndDisabled();
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Mesh LODs", &rr->useMeshLODs);
+        ImGui::BeginDisabled(!rr->useMeshLODs);
+        ImGui::SliderFloat("LOD Pixel Error", &rr->lodPixelError, 0.25f, 8.0f);
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Cluster Culling", &rr->useClusterCulling);
+        ImGui::BeginDisabled(!rr->useClusterCulling);
+        ImGui::Checkbox("Cluster Backface Culling", &rr->clusterBackfaceCulling);
+        ImGui::EndDisabled();
         ImGui::End();
 
         // Handle mouse lock for ImGui windows (excluding "Viewport")
@@ -128,16 +145,27 @@ namespace Radis
         if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
         {
             auto rr = ecs->GetResource<RenderingResource>();
-            if (!rr)
+            auto er = ecs->GetResource<EditorResource>();
+            if (!rr || !er)
             {
-                RADIS_CRITICAL("No rendering resource in editor system");
+                RADIS_CRITICAL("No rendering or editor resource in editor system");
                 return;
             }
 
+            // Picked here rather than by the scene window, so it matches the scene pass added this frame
+            if (rr->useRaytracing)
+            {
+                er->viewportTexture = er->renderRaytracingHeatmap ? "RTHeatmap" : "RTColor";
+            }
+            else
+            {
+                er->viewportTexture = "SceneColor";
+            }
+
             rr->renderGraph->AddPass(
                 "ImGuiPass",
                 [&](RGPassBuilder& builder) {
-                    builder.reads("SceneColor");
+                    builder.reads(er->viewportTexture);
                     builder.writes("BackBuffer");
                 },
                 std::bind(&EditorSystem::RenderImGui, this, std::placeholders::_1)
@@ -181,7 +209,34 @@ namespace Radis
 		// Rendering
 		ImGui::Render();
 
-        if      (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan) ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
+        {
+            auto rr = ecs->GetResource<RenderingResource>();
+            auto er = ecs->GetResource<EditorResource>();
+
+            // The graph's view of the scene only exists now and changes whenever the graph
+            // reallocates its transients, so the viewport set is rewritten every frame. This frame's
+            // fence has been waited on, so its set isn't in use.
+            RGResourceHandle handle = rr->renderGraph->GetResourceHandle(er->viewportTexture);
+            if (handle.index != UINT32_MAX)
+            {
+                VkDescriptorImageInfo imageInfo{};
+                imageInfo.sampler = rr->textureLibrary->GetSampler();
+                imageInfo.imageView = rr->renderGraph->GetResource(handle).imageView;
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+                VkWriteDescriptorSet write{};
+                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                write.dstSet = er->viewportSets[rr->currentFrameIndex];
+                write.dstBinding = 0;
+                write.descriptorCount = 1;
+                write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                write.pImageInfo = &imageInfo;
+                vkUpdateDescriptorSets(rr->device->GetDevice(), 1, &write, 0, nullptr);
+            }
+
+            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
+        }
         else if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL) ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 	}
 
@@ -423,8 +478,12 @@ namespace Radis
         // --- Tag Component (Special case, always at the top) ---
         if (selectedEnt.HasComponent<TagComponent>())
         {
-            auto& tag = selectedEnt.GetComponent<TagComponent>();
-            ImGui::InputText("##Tag", &tag.Tag);
+            // Edit a copy so the name index only changes through RenameEntity
+            std::string name = selectedEnt.GetComponent<TagComponent>().Tag;
+            if (ImGui::InputText("##Tag", &name))
+            {
+                ecs->RenameEntity(selectedEnt, name);
+            }
         }
 
         // --- Scrolling Component Region ---
@@ -85,7 +85,11 @@ namespace Radis
                 {
                     if (ImGui::MenuItem("Remove Entity"))
                     {
-                        er->entityToDelete = entity;
+                        if (er->selectedEntity == entity)
+                        {
+                            er->selectedEntity = {};
+                        }
+                        ecs->Commands().DestroyEntity(entity);
                     }
                     ImGui::EndPopup();
                 }
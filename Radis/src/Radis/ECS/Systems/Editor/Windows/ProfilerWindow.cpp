@@ -296,6 +296,19 @@ namespace Radis
             ImGui::Columns(1);
             ImGui::Separator();
 
+            // Counters set this frame (draws, culled meshes...)
+            if (!displaySnap.counters.empty() && ImGui::CollapsingHeader("Counters", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                for (const ProfilerSnapshotCounter& counter : displaySnap.counters)
+                {
+                    const bool validName = counter.nameId >= 0 && counter.nameId < (int)displaySnap.names.size();
+                    ImGui::TextUnformatted(validName ? displaySnap.names[counter.nameId].c_str() : "<unknown>");
+                    ImGui::SameLine(300);
+                    ImGui::TextDisabled("%lld", (long long)counter.value);
+                }
+                ImGui::Separator();
+            }
+
             // Filters row
             ImGui::PushItemWidth(200);
             ImGui::InputTextWithHint("##search", "Filter by name...", searchBuf, sizeof(searchBuf));
@@ -1,7 +1,6 @@
 #include <PCH/pch.h>
 #include "SceneWindow.h"
 
-#include "Graphics/Common/TextureLibrary.h"
 #include "Graphics/OpenGL/GLFrameBuffer.h"
 
 #include "ECS/Resources/RenderingResource.h"
@@ -20,28 +19,12 @@ namespace Radis
             auto rr = ecs->GetResource<RenderingResource>();
             auto er = ecs->GetResource<EditorResource>();
             if (!rr || !er) return;
-            auto tl = rr->textureLibrary.get();
-            if (!tl) return;
 
             void* sceneTexturePtr;
             if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
             {
-                if (rr->useRaytracing)
-                {
-                    uint32_t frameIndex = rr->currentFrameIndex;
-                    if (er->renderRaytracingHeatmap)
-                    {
-                        sceneTexturePtr = tl->GetTexture("RTHeatmapImage_" + std::to_string(frameIndex))->GetTextureID();
-                    }
-                    else
-                    {
-                        sceneTexturePtr = tl->GetTexture("RTColorImage_" + std::to_string(frameIndex))->GetTextureID();
-                    }
-                }
-                else
-                {
-                    sceneTexturePtr = reinterpret_cast<void*>(rr->textureLibrary->GetTexture("SceneTexture")->GetTextureID());
-                }
+                // The scene is a render graph texture, the ImGui pass points this set at it
+                sceneTexturePtr = reinterpret_cast<void*>(er->viewportSets[rr->currentFrameIndex]);
             }
             else
             {
@@ -97,11 +80,11 @@ namespace Radis
             glm::mat4 view = glm::mat4(1.0f);
             glm::mat4 projection = glm::perspective(glm::radians(45.0f), er->sceneWindowWidth / er->sceneWindowHeight, 0.1f, 100.0f);
 
-            Entity cameraEntity = ecs->GetEntity("Camera");
-            if (cameraEntity)
+            entt::entity cameraHandle = ecs->GetSingleton<PrimaryCameraTag>();
+            if (cameraHandle != entt::null)
             {
-                TransformComponent& tc = cameraEntity.GetComponent<TransformComponent>();
-                CameraComponent& cc = cameraEntity.GetComponent<CameraComponent>();
+                TransformComponent& tc = ecs->GetRegistry().get<TransformComponent>(cameraHandle);
+                CameraComponent& cc = ecs->GetRegistry().get<CameraComponent>(cameraHandle);
 
                 glm::vec3 cameraPos = tc.Translation;
                 glm::vec3 forwardDir = glm::normalize(cc.Forward);
@@ -117,11 +100,18 @@ namespace Radis
             ImGuizmo::SetRect(er->sceneWindowX, er->sceneWindowY, er->sceneWindowWidth, er->sceneWindowHeight);
 
             ImGuizmo::OPERATION operation = ImGuizmo::OPERATION::UNIVERSAL;
-            glm::mat4 modelMatrix = transformComponent.GetTransform();
+
+            // The gizmo works in world space; children store their TRS relative to the parent.
+            glm::mat4 parentMatrix = glm::mat4(1.0f);
+            if (auto* parentWorld = ecs->GetRegistry().try_get<WorldTransformComponent>(ecs->GetParent(er->selectedEntity)))
+            {
+                parentMatrix = parentWorld->World;
+            }
+            glm::mat4 modelMatrix = parentMatrix * transformComponent.GetTransform();
 
             if (ImGuizmo::Manipulate(glm::value_ptr(view), glm::value_ptr(projection), operation, ImGuizmo::WORLD, glm::value_ptr(modelMatrix)))
             {
-                glm::mat4 manipulatedTransform = modelMatrix;
+                glm::mat4 manipulatedTransform = glm::inverse(parentMatrix) * modelMatrix;
                 glm::vec3 newTranslation, newRotation, newScale;
 
                 ImGuizmo::DecomposeMatrixToComponents(
@@ -11,8 +11,7 @@
 
 #include "Graphics/Common/Animation/AnimationLibrary.h"
 #include "Graphics/Common/Animation/Animator.h"
-#include "Graphics/Vulkan/Uniform/Uniform.h"
-#include "Graphics/Vulkan/RenderGraph.h"
+#include "Graphics/Common/FrameRingBuffer.h"
 
 #include "Graphics/Common/Path/PathFollower.h"
 #include "Graphics/Common/Path/ArcLengthTable.h"
@@ -23,6 +22,19 @@
 
 namespace Radis
 {
+    void AnimationSystem::Init()
+    {
+        Access()
+            .Read<WorldTransformComponent, ModelComponent>()
+            .Write<AnimationComponent, AnimationResource, RenderingResource>()
+            .Append<DebugDrawResource>();
+    }
+
+    bool AnimationSystem::RunsOnMainThread() const
+    {
+        return Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL;
+    }
+
     void AnimationSystem::Update(float dt)
     {
         auto rr = ecs->GetResource<RenderingResource>();
@@ -32,15 +44,36 @@ namespace Radis
 
         // loop over model components
         entt::registry& registry = ecs->GetRegistry();
-        auto view = registry.view<TransformComponent, ModelComponent, AnimationComponent>();
+        auto view = registry.view<WorldTransformComponent, ModelComponent, AnimationComponent>();
+
+        // Bone counts are fixed per animator, so the frame's bones can be allocated in one go
+        uint32_t boneCount = 0;
+        for (auto entityHandle : view)
+        {
+            const AnimationComponent& ac = view.get<AnimationComponent>(entityHandle);
+            if (ac.AnimationIndex == AnimationLibrary::INVALID_ANIMATION_INDEX) continue;
+
+            Animator* animator = al->GetAnimator(ac.AnimationIndex);
+            if (!al->GetAnimation(ac.AnimationIndex) || !animator)
+                continue;
+
+            boneCount += static_cast<uint32_t>(animator->GetFinalBoneVQS().size());
+        }
 
-        auto& bonesMatrices = ar->bonesMatrices;
-        bonesMatrices.clear();
+        // Evaluated straight into the frame ring, headless has none and only advances time
+        VQS* bones = nullptr;
+        ar->boneOffset = 0;
+        ar->boneCount = 0;
+        if (rr->frameRing)
+        {
+            bones = rr->frameRing->Allocate<VQS>(boneCount, ar->boneOffset);
+            ar->boneCount = bones ? boneCount : 0;
+        }
 
         uint32_t boneOffset = 0;
         for (auto entityHandle : view)
         {
-            TransformComponent& tc = view.get<TransformComponent>(entityHandle);
+            WorldTransformComponent& wtc = view.get<WorldTransformComponent>(entityHandle);
             ModelComponent& mc = view.get<ModelComponent>(entityHandle);
             AnimationComponent& ac = view.get<AnimationComponent>(entityHandle);
 
@@ -58,39 +91,18 @@ namespace Radis
             }
             ac.AnimationTime = fmod(ac.AnimationTime, anim->GetDuration());
 
-            glm::mat4 tr = tc.GetTransform();
+            glm::mat4 tr = wtc.World;
             animator->UpdateAnimationInstant(ac.AnimationTime, ac.inPlace, tr);
             ac.PrevAnimationTime = ac.AnimationTime;
             ac.prevInPlace = ac.inPlace;
 
             const auto& finalMatrices = animator->GetFinalBoneVQS();
-            bonesMatrices.insert(bonesMatrices.end(), finalMatrices.begin(), finalMatrices.end());
+            if (bones)
+            {
+                std::copy(finalMatrices.begin(), finalMatrices.end(), bones + boneOffset);
+            }
             ac.BoneOffset = boneOffset;
             boneOffset += static_cast<uint32_t>(finalMatrices.size());
         }
-
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-        {
-            auto& rg = rr->renderGraph;
-            rg->AddPass(
-                "UpdateAnimationUniform",
-                [](RGPassBuilder& builder) {},
-                [&](VkCommandBuffer cmd)
-                {
-                    auto renderingData = ecs->GetResource<RenderingResource>();
-                    auto animationData = ecs->GetResource<AnimationResource>();
-                    renderingData->cameraUniform->SetUniformData(animationData->bonesMatrices, 2, renderingData->currentFrameIndex);
-                }
-            );
-        }
-        else
-        {
-            rr->shader->Use();
-            GLShader::SetupAnimationSSBO();
-            GLuint animationVBO = GLShader::GetAnimationSSBO();
-            glBindBuffer(GL_SHADER_STORAGE_BUFFER, animationVBO);
-            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bonesMatrices.size() * sizeof(VQS), bonesMatrices.data());
-            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        }
     }
 }
@@ -10,6 +10,10 @@ namespace Radis
         AnimationSystem() : ISystem("AnimationSystem") {};
         ~AnimationSystem() {}
 
+        void Init();
         void Update(float dt);
+
+        // Growing the frame ring under OpenGL makes GL calls, which need the context.
+        bool RunsOnMainThread() const override;
     };
 }
\ No newline at end of file
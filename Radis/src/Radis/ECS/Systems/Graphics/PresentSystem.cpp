@@ -10,33 +10,17 @@
 #include "Graphics/Vulkan/Core/Device.h"
 #include "Graphics/Vulkan/Core/SwapChain.h"
 #include "Graphics/Vulkan/RenderGraph.h"
+#include "Graphics/Vulkan/ThreadCommandPools.h"
 #include "Graphics/Vulkan/Core/Synchronization.h"
 #include "Graphics/Vulkan/VulkanWindow.h"
 
-#include "Graphics/Common/TextureLibrary.h"
-#include "Graphics/Vulkan/Texture/VKTexture.h"
-
 #include "Engine.h"
 
 namespace Radis
 {
 	void PresentSystem::Init()
 	{
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-        {
-            auto rr = ecs->GetResource<RenderingResource>();
-            auto tl = rr->textureLibrary.get();
-            if (tl)
-            {
-                const auto& extent = rr->swapChain->GetSwapChainExtent();
-                tl->ResizeStorageImage("RTColorImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTColorImage_1", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_1", extent.width, extent.height);
-                tl->ResizeTexture("SceneTexture", extent.width, extent.height);
-                tl->ResizeTexture("SceneDepth", extent.width, extent.height);
-            }
-        }
+        Access().Read<RenderingResource, WindowResource>();
 	}
 
 	void PresentSystem::FrameStart()
@@ -62,18 +46,6 @@ namespace Radis
         if (result == VK_ERROR_OUT_OF_DATE_KHR)
         {
             rr->RecreateSwapChain(wr->window.get());
-
-            auto tl = rr->textureLibrary.get();
-            if (tl)
-            {
-                const auto& extent = rr->swapChain->GetSwapChainExtent();
-                tl->ResizeStorageImage("RTColorImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTColorImage_1", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_1", extent.width, extent.height);
-                tl->ResizeTexture("SceneTexture", extent.width, extent.height);
-                tl->ResizeTexture("SceneDepth", extent.width, extent.height);
-            }
             return;
         }
 
@@ -90,9 +62,11 @@ namespace Radis
         rr->syncObjects->GetImageInFlightFence(rr->currentFrameIndex) = rr->syncObjects->GetCommandBufferInFlightFence();
 
 
-        // Get the command buffer for the current frame and reset it
+        // Get the command buffer for the current frame and reset it, along with the secondaries
+        // its last submission executed
         VkCommandBuffer commandBuffer = rr->commandBuffers[rr->currentFrameIndex];
         vkResetCommandBuffer(commandBuffer, 0);
+        rr->threadCommandPools->BeginFrame(rr->currentFrameIndex);
 
         // --- Begin Recording with Render Graph ---
         VkCommandBufferBeginInfo beginInfo{};
@@ -104,38 +78,7 @@ namespace Radis
         // Start a new render graph!
         rg->Clear();
 
-        // Import resources!
-        auto tl = rr->textureLibrary.get();
-        if (Engine::GetEditorEnabled()) 
-        {
-            VKTexture* tex = (VKTexture*)tl->GetTexture("SceneTexture");
-            rg->ImportTexture(
-                "SceneColor",
-                tex->GetImage(),//rr->sceneImage,
-                tex->GetImageView(),//rr->sceneImageView,
-                tex->GetExtent(), //rr->swapChain->GetSwapChainExtent(),
-                tex->GetImageFormat() //rr->swapChain->GetImageFormat()
-            );
-        }
-
-        {
-            VKTexture* tex = (VKTexture*)tl->GetTexture("SceneDepth");
-            rg->ImportTexture(
-                "SceneDepth",
-                tex->GetImage(),
-                tex->GetImageView(),
-                tex->GetExtent(),
-                tex->GetImageFormat()
-            );
-            //rg->ImportTexture(
-            //    "SceneDepth",
-            //    rr->mDepthImage,
-            //    rr->mDepthImageView,
-            //    rr->swapChain->GetSwapChainExtent(),
-            //    rr->swapChain->FindDepthFormat()
-            //);
-        }
-
+        // Import resources! The scene textures are the graph's own and follow the backbuffer's size.
         rg->ImportBackbuffer(
             "BackBuffer",
             rr->swapChain->GetImage(),
@@ -167,7 +110,7 @@ namespace Radis
         VkCommandBuffer commandBuffer = rr->commandBuffers[rr->currentFrameIndex];
 
         // Execute the graph
-        rr->renderGraph->Execute(commandBuffer, rr->device->GetDevice());
+        rr->renderGraph->Execute(commandBuffer, rr->device->GetDevice(), rr->threadCommandPools.get(), rr->currentFrameIndex);
 
         // --- End Graph ---
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
@@ -207,19 +150,6 @@ namespace Radis
         {
             wr->window->ResetResizeFlag();
             rr->RecreateSwapChain(wr->window.get());
-            //rr->RecreateAllSceneTextures();
-
-            auto tl = rr->textureLibrary.get();
-            if (tl)
-            {
-                const auto& extent = rr->swapChain->GetSwapChainExtent();
-                tl->ResizeStorageImage("RTColorImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTColorImage_1", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_0", extent.width, extent.height);
-                tl->ResizeStorageImage("RTHeatmapImage_1", extent.width, extent.height);
-                tl->ResizeTexture("SceneTexture", extent.width, extent.height);
-                tl->ResizeTexture("SceneDepth", extent.width, extent.height);
-            }
             rr->syncObjects->ClearImageFences();
         }
         else if (result != VK_SUCCESS) {
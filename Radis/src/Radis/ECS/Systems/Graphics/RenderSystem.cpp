@@ -7,6 +7,7 @@
 #include "ECS/Resources/WindowResource.h"
 #include "ECS/Resources/SwapRendererResource.h"
 #include "ECS/Resources/RaytracingResource.h"
+#include "ECS/Resources/AnimationResource.h"
 
 #include "../InputSystem.h"
 
@@ -19,12 +20,19 @@
 #include "Graphics/Common/Model.h"
 #include "Graphics/Vulkan/Uniform/Uniform.h"
 #include "Graphics/Vulkan/RenderGraph.h"
+#include "Graphics/Vulkan/OcclusionCuller.h"
 #include "Graphics/Common/Animation/AnimationLibrary.h"
 #include "Graphics/Common/TextureLibrary.h"
 #include "Graphics/Vulkan/Texture/VKTexture.h"
 #include "Graphics/Vulkan/Uniform/Descriptors.h"
 #include "Graphics/Vulkan/Utils/ScopedDebugLabel.h"
 #include "Graphics/Common/UnifiedMesh.h"
+#include "Graphics/Common/Frustum.h"
+#include "Graphics/Common/FrameRingBuffer.h"
+#include "Graphics/Common/InstanceTable.h"
+#include "Graphics/Vulkan/VKInstanceTable.h"
+#include "Graphics/Vulkan/VKRingBuffer.h"
+#include "Jobs/JobSystem.h"
 
 #include "ECS/ECS.h"
 #include "ECS/Entities/Entity.h"
@@ -34,6 +42,8 @@
 #include "Graphics/OpenGL/GLMesh.h"
 #include "Graphics/OpenGL/GLFrameBuffer.h"
 #include "Graphics/OpenGL/GLTexture.h"
+#include "Graphics/OpenGL/GLRingBuffer.h"
+#include "Graphics/OpenGL/GLInstanceTable.h"
 
 
 namespace Radis
@@ -43,16 +53,50 @@ namespace Radis
 
     void RenderSystem::Init()
     {
+        Access()
+            .Read<TransformComponent, WorldTransformComponent, ModelComponent, LightComponent, CameraComponent, PrimaryCameraTag, AnimationComponent>()
+            .Read<DebugDrawResource, EditorResource, WindowResource, AnimationResource>()
+            .Write<RenderInstanceComponent>()
+            .Write<RenderingResource, RaytracingResource, SwapRendererResource>()
+            .MainThread();
+
+        entt::registry& registry = ecs->GetRegistry();
+        registry.on_destroy<RenderInstanceComponent>().connect<&RenderSystem::OnInstanceDestroyed>(this);
+        registry.on_destroy<ModelComponent>().connect<&RenderSystem::OnModelRemoved>(this);
     }
 
     void RenderSystem::Exit()
     {
+        entt::registry& registry = ecs->GetRegistry();
+        registry.on_destroy<RenderInstanceComponent>().disconnect(this);
+        registry.on_destroy<ModelComponent>().disconnect(this);
+    }
+
+    void RenderSystem::OnInstanceDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        auto rr = ecs->GetResource<RenderingResource>();
+        if (rr && rr->instanceTable)
+        {
+            const RenderInstanceComponent& ric = registry.get<RenderInstanceComponent>(entity);
+            rr->instanceTable->Free(ric.FirstSlot, ric.SlotCount);
+        }
+    }
+
+    void RenderSystem::OnModelRemoved(entt::registry& registry, entt::entity entity)
+    {
+        registry.remove<RenderInstanceComponent>(entity);
     }
 
     void RenderSystem::FrameStart()
     {
         auto rr = ecs->GetResource<RenderingResource>();
 
+        // Vulkan waited on this frame's fence in PresentSystem::FrameStart, GL waits on its own
+        if (rr->frameRing)
+        {
+            rr->frameRing->BeginFrame(rr->currentFrameIndex);
+        }
+
         if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan && !rr->tlasAccel.accel && rr->blasAccel.empty())
         {
             // get num entities with model component
@@ -62,23 +106,10 @@ namespace Radis
             auto uMeshes = rr->modelLibrary->GetUnifiedMesh();
             if (uMeshes)
             {            
-                MeshDataUniform vertexData;
-                for (auto& v : uMeshes->GetUnifiedMesh()->mVertices)
-                {
-                    vertexData.posX = v.position.x;
-                    vertexData.posY = v.position.y;
-                    vertexData.posZ = v.position.z;
-                    vertexData.colorR = v.color.r;
-                    vertexData.colorG = v.color.g;
-                    vertexData.colorB = v.color.b;
-                    vertexData.normalX = v.normal.x;
-                    vertexData.normalY = v.normal.y;
-                    vertexData.normalZ = v.normal.z;
-                    vertexData.texU = v.uv.x;
-                    vertexData.texV = v.uv.y;
-
-                    mRTMeshData.push_back(vertexData);
-                }
+                static_assert(sizeof(MeshDataUniform) == sizeof(PackedVertex));
+                const std::vector<PackedVertex>& vertices = uMeshes->GetPackedVertices();
+                mRTMeshData.resize(vertices.size());
+                memcpy(mRTMeshData.data(), vertices.data(), sizeof(PackedVertex) * vertices.size());
             
                 mRTMeshIndices = uMeshes->GetUnifiedMesh()->mIndices;
             }
@@ -111,11 +142,6 @@ namespace Radis
         rr->textureLibrary->LoadQueuedTextures();
         rr->textureLibrary->UpdateTextureUniform(rr->cameraUniform.get());
 
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-        {
-            rr->textureLibrary->UpdateRTUniform(*rr);
-        }
-
         DebugDrawResource::DrawEditorGrid(50, 1.0f);
 
         // Heh
@@ -131,15 +157,18 @@ namespace Radis
         float aspectRatio = GetAspectRatio();
 
         CameraUniforms camData{};
+        float nearPlane = 0.1f;
+        float farPlane = 100.0f;
         camData.view = glm::mat4(1.0f);
-        camData.projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f); 
+        camData.projection = glm::perspective(glm::radians(45.0f), aspectRatio, nearPlane, farPlane); 
 
         // get camera entity
-        Entity cameraEntity = ecs->GetEntity("Camera");
-        if (cameraEntity)
+        auto& registry = ecs->GetRegistry();
+        entt::entity cameraHandle = ecs->GetSingleton<PrimaryCameraTag>();
+        if (cameraHandle != entt::null)
         {
-            TransformComponent& tc = cameraEntity.GetComponent<TransformComponent>();
-            CameraComponent& cc = cameraEntity.GetComponent<CameraComponent>();
+            TransformComponent& tc = registry.get<TransformComponent>(cameraHandle);
+            CameraComponent& cc = registry.get<CameraComponent>(cameraHandle);
 
             // Get the position directly
             glm::vec3 cameraPos = tc.Translation;
@@ -149,30 +178,47 @@ namespace Radis
             glm::vec3 cameraTarget = cameraPos + forwardDir;
             camData.view = glm::lookAt(cameraPos, cameraTarget, upDir);
             camData.cameraPos = glm::vec4(tc.Translation, 1.0f);
-            camData.projection = glm::perspective(glm::radians(cc.FOV), aspectRatio, cc.Near, cc.Far);
+            nearPlane = cc.Near;
+            farPlane = cc.Far;
+            camData.projection = glm::perspective(glm::radians(cc.FOV), aspectRatio, nearPlane, farPlane);
         }
 
         if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan) camData.projection[1][1] *= -1;
         camData.projectionView = camData.projection * camData.view;
 
-        mInstanceData.clear();
-        mLightData.clear();
-        const auto& debugData = DebugDrawResource::GetInstanceData();
-        
-        if (!rr->useRaytracing)
+        OcclusionCuller* culler = rr->occlusionCuller.get();
+        mUseGpuOcclusion = Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan && culler && culler->IsSupported() && rr->useOcclusionCulling && !rr->useRaytracing;
+        if (mUseGpuOcclusion)
         {
-            if (mInstanceData.size() + debugData.size() < InstanceUniforms::MAX_INSTANCES)
-            {
-                mInstanceData.insert(mInstanceData.end(), debugData.begin(), debugData.end());
-            }
-            else
+            // Results of the last submission that used this frame slot, its fence has been waited on
+            const uint32_t* visibility = culler->GetVisibility(rr->currentFrameIndex);
+            const OcclusionCuller::CullInstance* lastInstances = culler->GetCullInstances(rr->currentFrameIndex);
+            uint32_t occludedCount = 0;
+            for (uint32_t i = 0; i < culler->GetLastCullCount(rr->currentFrameIndex); ++i)
             {
-                RADIS_WARN("Too many instances for debug draw render!");
+                if (visibility[i]) continue;
+                ++occludedCount;
+
+                // Reads back write-combined memory, fine for a debug view
+                if (rr->showOcclusionCulled)
+                {
+                    DebugDrawResource::DrawCube(glm::vec3(lastInstances[i].centerRadius), glm::vec3(lastInstances[i].extents) * 2.0f, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+                }
             }
+            PROFILE_COUNTER("Meshes Occluded", occludedCount);
         }
 
-        auto& registry = ecs->GetRegistry();
-        registry.view<LightComponent, TransformComponent>().each([&](auto entity, LightComponent& lc, TransformComponent& tc)
+        FrameRingBuffer* ring = rr->frameRing.get();
+        const auto& debugData = DebugDrawResource::GetInstanceData();
+
+        // Lights and their cluster grid go into the ring behind their headers. Finished before the
+        // instances are allocated, which may move the slot. Gathered on the CPU first, the grid
+        // build reads them back and ring memory is write-combined.
+        struct LightHeader { uint32_t lightCount; uint32_t _pad[3]; };
+        auto lightView = registry.view<LightComponent, TransformComponent>();
+        mLights.clear();
+
+        lightView.each([&](auto entity, LightComponent& lc, TransformComponent& tc)
         {
             LightUniform lu{};
             lu.position = glm::vec4(tc.Translation, 1.0f);
@@ -185,16 +231,68 @@ namespace Radis
             lu.type = static_cast<int>(lc.Type);
             lu._padding[0] = 777;
             lu._padding[1] = 777;
-            mLightData.push_back(lu);
+            mLights.push_back(lu);
         });
 
+        const uint32_t lightCount = static_cast<uint32_t>(mLights.size());
+        mLightBytes = static_cast<uint32_t>(sizeof(LightHeader) + sizeof(LightUniform) * lightCount);
+        RingAllocation lightAllocation = ring->Allocate(mLightBytes);
+        mLightOffset = lightAllocation.offset;
+        if (lightAllocation.data)
+        {
+            LightHeader header{ .lightCount = lightCount };
+            memcpy(lightAllocation.data, &header, sizeof(LightHeader));
+            memcpy(lightAllocation.data + sizeof(LightHeader), mLights.data(), sizeof(LightUniform) * lightCount);
+        }
+
+        {
+            PROFILE_SCOPE("Light Grid");
+            mLightGrid.Build(mLights.data(), lightCount, camData.view, camData.projection, nearPlane, farPlane);
+            mLightGridBytes = mLightGrid.GetByteSize();
+            RingAllocation gridAllocation = ring->Allocate(mLightGridBytes);
+            mLightGridOffset = gridAllocation.offset;
+            if (gridAllocation.data)
+            {
+                mLightGrid.Write(gridAllocation.data);
+            }
+        }
+        PROFILE_COUNTER("Lights", lightCount);
+        PROFILE_COUNTER("Light Grid References", mLightGrid.GetIndexCount());
+
         AnimationLibrary* al = rr->animationLibrary.get();
         ModelLibrary* ml = rr->modelLibrary.get();
         UnifiedMeshes* uMeshes = ml->GetUnifiedMesh();
+        InstanceTable* table = rr->instanceTable.get();
+
+        // Texture indices changed under every mesh, or the table itself was recreated. Start over.
+        if (ml->GetGeneration() != mInstanceGeneration)
+        {
+            registry.clear<RenderInstanceComponent>();
+            table->Clear();
+            mInstanceGeneration = ml->GetGeneration();
+            mDebugFirstSlot = InstanceTable::INVALID_SLOT;
+            mDebugSlotCount = 0;
+        }
 
-        uint32_t indexOffset = 0;
-        uint32_t vertexOffset = 0;
-        registry.view<ModelComponent, TransformComponent>().each([&](auto entity, ModelComponent& mc, TransformComponent& tc)
+        // Debug cubes are rewritten in place every frame, an unchanged grid uploads nothing
+        mDebugInstanceCount = rr->useRaytracing ? 0 : static_cast<uint32_t>(debugData.size());
+        if (mDebugInstanceCount > mDebugSlotCount)
+        {
+            table->Free(mDebugFirstSlot, mDebugSlotCount);
+            mDebugSlotCount = std::max(mDebugInstanceCount, mDebugSlotCount * 2);
+            mDebugFirstSlot = table->Allocate(mDebugSlotCount);
+        }
+        const IMesh* cube = ml->TryAddGetModel("Assets/Models/cube.obj")->mMeshes[0].get();
+        for (uint32_t i = 0; i < mDebugInstanceCount; ++i)
+        {
+            InstanceUniforms data = debugData[i];
+            data.positionOffset = glm::vec4(cube->GetQuantizationOffset(), 0.f);
+            data.positionScale = glm::vec4(cube->GetQuantizationScale(), 0.f);
+            table->Write(mDebugFirstSlot + i, data);
+        }
+
+        mMeshCandidates.clear();
+        registry.view<ModelComponent, WorldTransformComponent>().each([&](auto entity, ModelComponent& mc, WorldTransformComponent& wtc)
         {
             Model* model = rr->modelLibrary->TryAddGetModel(mc.ModelPath);
             if (!model) return;
@@ -207,85 +305,365 @@ namespace Radis
                 boneOffset = ac->BoneOffset;
             }
 
-            for (auto& mesh : model->mMeshes)
+            const glm::mat4 transform = boneOffset == AnimationLibrary::INVALID_ANIMATION_INDEX ? wtc.World * model->GetNormalizationMatrix() : wtc.World;
+
+            // Only entities that changed since their slots were written rebuild them
+            RenderInstanceComponent& ric = registry.get_or_emplace<RenderInstanceComponent>(entity);
+            const bool changed = ric.BuiltModel != model ||
+                ric.BuiltWorld != wtc.World ||
+                ric.BuiltBoneOffset != boneOffset ||
+                ric.BuiltTint != mc.tintColor ||
+                ric.BuiltUseMetallicOverride != mc.useMetallicOverride ||
+                ric.BuiltUseRoughnessOverride != mc.useRoughnessOverride ||
+                ric.BuiltMetallicOverride != mc.metallicOverride ||
+                ric.BuiltRoughnessOverride != mc.roughnessOverride;
+
+            if (ric.BuiltModel != model)
             {
-                InstanceUniforms& data = mInstanceData.emplace_back();
-                if (boneOffset == AnimationLibrary::INVALID_ANIMATION_INDEX)
+                table->Free(ric.FirstSlot, ric.SlotCount);
+                ric.SlotCount = static_cast<uint32_t>(model->mMeshes.size());
+                ric.FirstSlot = table->Allocate(ric.SlotCount);
+            }
+
+            if (changed)
+            {
+                for (uint32_t i = 0; i < ric.SlotCount; ++i)
                 {
-                    data.model = tc.GetTransform() * model->GetNormalizationMatrix();
+                    const IMesh* mesh = model->mMeshes[i].get();
+                    const MeshInfo& meshInfo = uMeshes->GetMeshInfo(mesh->GetID());
+
+                    float meshMetallic = mc.useMetallicOverride ? mc.metallicOverride : mesh->metallicFactor;
+                    float meshRoughness = mc.useRoughnessOverride ? mc.roughnessOverride : mesh->roughnessFactor;
+                    uint32_t metallicIndex = mc.useMetallicOverride ? TextureLibrary::INVALID_TEXTURE_INDEX : mesh->metalnessTextureIndex;
+                    uint32_t roughnessIndex = mc.useRoughnessOverride ? TextureLibrary::INVALID_TEXTURE_INDEX : mesh->roughnessTextureIndex;
+                    if (mesh->mMetallicRoughnessCombined) roughnessIndex = metallicIndex;
+
+                    InstanceUniforms data{};
+                    data.model = transform;
+                    data.tint = mc.tintColor;
+                    data.textureIndicies = glm::uvec4(mesh->albedoTextureIndex, mesh->normalTextureIndex, metallicIndex, roughnessIndex);
+                    data.textureIndicies2 = glm::uvec4(mesh->occlusionTextureIndex, mesh->emissiveTextureIndex, 10001, 10001);
+                    data.boneOffset = boneOffset;
+                    data.baseColorFactor = mesh->baseColorFactor;
+                    data.metallicRoughnessFactor = glm::vec4(meshMetallic, meshRoughness, 0.f, 0.f);
+                    data.emissiveFactor = mesh->emissiveFactor;
+                    data.indexOffset = meshInfo.firstIndex;
+                    data.vertexOffset = meshInfo.vertexOffset;
+                    data.meshID = mesh->GetID();
+                    data.positionOffset = glm::vec4(mesh->GetQuantizationOffset(), 0.f);
+                    data.positionScale = glm::vec4(mesh->GetQuantizationScale(), 0.f);
+                    table->Write(ric.FirstSlot + i, data);
                 }
-                else
+
+                ric.BuiltModel = model;
+                ric.BuiltWorld = wtc.World;
+                ric.BuiltBoneOffset = boneOffset;
+                ric.BuiltTint = mc.tintColor;
+                ric.BuiltUseMetallicOverride = mc.useMetallicOverride;
+                ric.BuiltUseRoughnessOverride = mc.useRoughnessOverride;
+                ric.BuiltMetallicOverride = mc.metallicOverride;
+                ric.BuiltRoughnessOverride = mc.roughnessOverride;
+            }
+
+            for (uint32_t i = 0; i < ric.SlotCount; ++i)
+            {
+                mMeshCandidates.push_back({ model->mMeshes[i].get(), transform, boneOffset, ric.FirstSlot + i });
+            }
+        });
+
+        // Frustum culling. Skinned meshes move away from their bind pose bounds, and ray traced
+        // frames need off-screen geometry in the TLAS, so those are always kept.
+        const size_t candidateCount = mMeshCandidates.size();
+        mCullBatch.Resize(candidateCount);
+        for (size_t i = 0; i < candidateCount; ++i)
+        {
+            const MeshCandidate& candidate = mMeshCandidates[i];
+            if (rr->useRaytracing || candidate.boneOffset != AnimationLibrary::INVALID_ANIMATION_INDEX)
+            {
+                mCullBatch.SetAlwaysVisible(i);
+                continue;
+            }
+
+            const IMesh& mesh = *candidate.mesh;
+            mCullBatch.Set(i, candidate.transform, (mesh.mAABBmin + mesh.mAABBmax) * 0.5f, (mesh.mAABBmax - mesh.mAABBmin) * 0.5f, mesh.mBoundingRadius);
+        }
+
+        const Frustum frustum = Frustum::FromMatrix(camData.projectionView);
+        JobSystem::ParallelFor(candidateCount, 1024, [&](size_t begin, size_t end)
+        {
+            CullAgainstFrustum(frustum, mCullBatch, begin, end);
+        });
+
+        // LOD selection: the coarsest LOD whose simplification error projects to at most lodPixelError
+        // pixels at the near side of the instance's bounding sphere. Skinned and ray traced instances
+        // stay at LOD 0, their bounds don't describe what is drawn.
+        const bool useLODs = rr->useMeshLODs && !rr->useRaytracing;
+        const glm::vec3 cameraPos = glm::vec3(camData.cameraPos);
+        const float pixelsAtUnitDistance = GetViewportHeight() * 0.5f * std::abs(camData.projection[1][1]);
+        uint32_t reducedLODCount = 0;
+
+        // Bucket the visible instances by mesh and LOD, candidate index keeps the order stable within a bucket
+        mSortKeys.clear();
+        for (size_t i = 0; i < candidateCount; ++i)
+        {
+            if (!mCullBatch.visible[i]) continue;
+
+            const MeshCandidate& candidate = mMeshCandidates[i];
+            const uint32_t meshID = candidate.mesh->GetID();
+            uint32_t lod = 0;
+            const uint32_t lodCount = useLODs && candidate.boneOffset == AnimationLibrary::INVALID_ANIMATION_INDEX ? uMeshes->GetLODCount(meshID) : 1;
+            if (lodCount > 1 && candidate.mesh->mBoundingRadius > 0.f)
+            {
+                const float radius = mCullBatch.radius[i];
+                const float worldScale = radius / candidate.mesh->mBoundingRadius;
+                const glm::vec3 center(mCullBatch.centerX[i], mCullBatch.centerY[i], mCullBatch.centerZ[i]);
+                const float distance = std::max(glm::length(center - cameraPos) - radius, 0.001f);
+                const float pixelsPerUnit = pixelsAtUnitDistance * worldScale / distance;
+
+                while (lod + 1 < lodCount && uMeshes->GetMeshInfo(meshID, lod + 1).lodError * pixelsPerUnit <= rr->lodPixelError)
                 {
-                    data.model = tc.GetTransform();
+                    ++lod;
                 }
-                
-                const MeshInfo& meshInfo = uMeshes->GetMeshInfo(mesh->GetID());
-                float meshMetallic = mc.useMetallicOverride ? mc.metallicOverride : mesh->metallicFactor;
-                float meshRoughness = mc.useRoughnessOverride ? mc.roughnessOverride : mesh->roughnessFactor;
-                uint32_t metallicIndex = mc.useMetallicOverride ? TextureLibrary::INVALID_TEXTURE_INDEX : mesh->metalnessTextureIndex;
-                uint32_t roughnessIndex = mc.useRoughnessOverride ? TextureLibrary::INVALID_TEXTURE_INDEX : mesh->roughnessTextureIndex;
-                if (mesh->mMetallicRoughnessCombined) roughnessIndex = metallicIndex;
-
-                data.tint = mc.tintColor;
-                data.textureIndicies = glm::uvec4(mesh->albedoTextureIndex, mesh->normalTextureIndex, metallicIndex, roughnessIndex);
-                data.textureIndicies2 = glm::uvec4(mesh->occlusionTextureIndex, mesh->emissiveTextureIndex, 10001, 10001);
-                data.boneOffset = boneOffset;
-                data.baseColorFactor = mesh->baseColorFactor;
-                data.metallicRoughnessFactor = glm::vec4(meshMetallic, meshRoughness, 0.f, 0.f);
-                data.emissiveFactor = mesh->emissiveFactor;
-                data.indexOffset = meshInfo.firstIndex;
-                data.vertexOffset = meshInfo.vertexOffset;
-                data.meshID = mesh->GetID();
+                reducedLODCount += lod > 0 ? 1 : 0;
             }
-        });
 
-        struct LightHeader { uint32_t lightCount; uint32_t _pad[3]; };
-        LightHeader header{ .lightCount = static_cast<uint32_t>(mLightData.size()) };
-        mLightBuffer.resize(sizeof(LightHeader) + sizeof(LightUniform) * mLightData.size());
-        memcpy(mLightBuffer.data(), &header, sizeof(LightHeader));
-        memcpy(mLightBuffer.data() + sizeof(LightHeader), mLightData.data(), sizeof(LightUniform) * mLightData.size());
+            mSortKeys.push_back(static_cast<uint64_t>(meshID) << 32 | static_cast<uint64_t>(lod) << SORT_KEY_LOD_SHIFT | static_cast<uint64_t>(i));
+        }
+        std::sort(mSortKeys.begin(), mSortKeys.end());
+
+        // Cluster culling: instances drawn at LOD 0 that cross the frustum (or any, with backface
+        // rejection) are split into the runs of their meshlets that survive. Skinned and ray traced
+        // instances are drawn whole, same as for LOD selection.
+        const bool useClusters = rr->useClusterCulling && !rr->useRaytracing;
+        uint32_t clusteredCount = 0;
+        uint32_t culledClusterCount = 0;
+        mDrawEntries.clear();
+        for (uint64_t sortKey : mSortKeys)
+        {
+            const uint32_t candidateIndex = static_cast<uint32_t>(sortKey & SORT_KEY_CANDIDATE_MASK);
+            const MeshCandidate& candidate = mMeshCandidates[candidateIndex];
+            const uint32_t lod = static_cast<uint32_t>(sortKey >> SORT_KEY_LOD_SHIFT) & 0xF;
+            const MeshInfo& meshInfo = uMeshes->GetMeshInfo(candidate.mesh->GetID(), lod);
+            if (meshInfo.indexCount == 0) continue; // not in the arena
+
+            const std::vector<Meshlet>* meshlets = useClusters && lod == 0 && candidate.boneOffset == AnimationLibrary::INVALID_ANIMATION_INDEX ?
+                uMeshes->GetMeshlets(candidate.mesh->GetID()) : nullptr;
+            const glm::vec3 center(mCullBatch.centerX[candidateIndex], mCullBatch.centerY[candidateIndex], mCullBatch.centerZ[candidateIndex]);
+            if (meshlets && (rr->clusterBackfaceCulling || !frustum.ContainsSphere(center, mCullBatch.radius[candidateIndex])))
+            {
+                mClusterRuns.clear();
+                culledClusterCount += CullMeshlets(frustum, cameraPos, rr->clusterBackfaceCulling, candidate.transform, *meshlets, mClusterRuns);
+                for (const ClusterRun& run : mClusterRuns)
+                {
+                    mDrawEntries.push_back({ candidateIndex, run.indexCount, meshInfo.firstIndex + run.firstIndex, meshInfo.vertexOffset, true, 0 });
+                }
+                ++clusteredCount;
+                continue;
+            }
+
+            mDrawEntries.push_back({ candidateIndex, meshInfo.indexCount, meshInfo.firstIndex, meshInfo.vertexOffset, false, 0 });
+        }
+
+        // Debug cubes first, then every draw entry in sort key order. Only the slot goes into the
+        // ring, the instance data itself stays in the table.
+        mInstanceCount = mDebugInstanceCount + static_cast<uint32_t>(mDrawEntries.size());
+        uint32_t* visibleSlots = ring->Allocate<uint32_t>(mInstanceCount, mInstanceOffset);
+        if (!visibleSlots)
+        {
+            mInstanceCount = 0;
+            mDebugInstanceCount = 0;
+            mSortKeys.clear();
+            mDrawEntries.clear();
+        }
+        for (uint32_t i = 0; i < mDebugInstanceCount; ++i)
+        {
+            visibleSlots[i] = mDebugFirstSlot + i;
+        }
+
+        mDrawCommands.clear();
+        const MeshInfo& cubeMesh = uMeshes->GetMeshInfo(cube->GetID());
+        mDrawCommands.push_back({ cubeMesh.indexCount, mDebugInstanceCount, cubeMesh.firstIndex, cubeMesh.vertexOffset, 0 });
+
+        // Whole mesh LODs batch with their neighbours, a mesh LOD is identified by its index range
+        bool batchOpen = false;
+        for (size_t i = 0; i < mDrawEntries.size(); ++i)
+        {
+            DrawEntry& entry = mDrawEntries[i];
+
+            const uint32_t instanceIndex = mDebugInstanceCount + static_cast<uint32_t>(i);
+            visibleSlots[instanceIndex] = mMeshCandidates[entry.candidate].slot;
+
+            const VkDrawIndexedIndirectCommand& last = mDrawCommands.back();
+            if (entry.clustered || !batchOpen || last.firstIndex != entry.firstIndex || last.indexCount != entry.indexCount)
+            {
+                mDrawCommands.push_back({ entry.indexCount, 0, entry.firstIndex, entry.vertexOffset, instanceIndex });
+            }
+            batchOpen = !entry.clustered;
+            ++mDrawCommands.back().instanceCount;
+            entry.command = static_cast<uint32_t>(mDrawCommands.size() - 1);
+        }
+
+        // Every Write of the frame is done, upload what changed
+        table->Flush(*ring);
+
+        PROFILE_COUNTER("Instances Uploaded", table->GetLastUploadCount());
+        PROFILE_COUNTER("Meshes Drawn", mSortKeys.size());
+        PROFILE_COUNTER("Meshes Culled", candidateCount - mSortKeys.size());
+        PROFILE_COUNTER("Meshes At Reduced LOD", reducedLODCount);
+        PROFILE_COUNTER("Meshes Cluster Culled", clusteredCount);
+        PROFILE_COUNTER("Clusters Culled", culledClusterCount);
+        PROFILE_COUNTER("Mesh Draw Calls", mDrawCommands.size() - 1);
+
+        if (mDrawCommands.size() > RenderingResource::MAX_INDIRECT_DRAWS)
+        {
+            RADIS_WARN("Too many draws for the indirect buffer, dropping {0}", mDrawCommands.size() - RenderingResource::MAX_INDIRECT_DRAWS);
+            mDrawCommands.resize(RenderingResource::MAX_INDIRECT_DRAWS);
+        }
 
         if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
         {
-            rr->cameraUniform->SetUniformData(camData, 0, rr->currentFrameIndex);       // Set Camera Data
-            rr->cameraUniform->SetUniformData(mInstanceData, 1, rr->currentFrameIndex); // Set Instance Data
-            rr->cameraUniform->SetUniformData(mLightBuffer, 4, rr->currentFrameIndex);  // Set Light Data
+            auto ar = ecs->GetResource<AnimationResource>();
+            rr->cameraUniform->SetUniformData(camData, 0, rr->currentFrameIndex); // Set Camera Data
+            rr->cameraUniform->SetDynamicOffset(2, ar->boneOffset);               // Bone Data
+            rr->cameraUniform->SetDynamicOffset(4, mLightOffset);                 // Light Data
+            rr->cameraUniform->SetDynamicOffset(5, mInstanceOffset);              // Visible Instance Slots
+            rr->cameraUniform->SetDynamicOffset(6, mLightGridOffset);             // Light Grid
+
+            // Draw count, then the commands, into this frame's indirect buffer. With occlusion culling
+            // the mesh commands go in without instances, the cull shader adds the survivors. The
+            // draw count stays one per mesh LOD either way.
+            uint8_t* indirect = rr->indirectBuffers[rr->currentFrameIndex].mapping;
+            const uint32_t drawCount = static_cast<uint32_t>(mDrawCommands.size());
+            memcpy(indirect, &drawCount, sizeof(drawCount));
+            VkDrawIndexedIndirectCommand* commands = reinterpret_cast<VkDrawIndexedIndirectCommand*>(indirect + RenderingResource::INDIRECT_COMMANDS_OFFSET);
+            memcpy(commands, mDrawCommands.data(), sizeof(VkDrawIndexedIndirectCommand) * drawCount);
+
+            if (mUseGpuOcclusion)
+            {
+                for (uint32_t i = 1; i < drawCount; ++i)
+                {
+                    commands[i].instanceCount = 0;
+                }
+
+                // One entry per draw entry, in instance order, up to the last command that fit.
+                // Cluster runs are tested with their instance's bounds.
+                mCullInstanceCount = static_cast<uint32_t>(mDrawEntries.size());
+                OcclusionCuller::CullInstance* cullInstances = culler->BeginCullInstances(rr->currentFrameIndex, mCullInstanceCount);
+                for (uint32_t i = 0; i < mCullInstanceCount; ++i)
+                {
+                    const DrawEntry& entry = mDrawEntries[i];
+                    if (entry.command >= drawCount)
+                    {
+                        mCullInstanceCount = i;
+                        break;
+                    }
+                    const uint32_t candidateIndex = entry.candidate;
+                    const MeshCandidate& candidate = mMeshCandidates[candidateIndex];
+
+                    OcclusionCuller::CullInstance& cullInstance = cullInstances[i];
+                    cullInstance.centerRadius = glm::vec4(mCullBatch.centerX[candidateIndex], mCullBatch.centerY[candidateIndex], mCullBatch.centerZ[candidateIndex], mCullBatch.radius[candidateIndex]);
+                    cullInstance.extents = glm::vec4(mCullBatch.extentX[candidateIndex], mCullBatch.extentY[candidateIndex], mCullBatch.extentZ[candidateIndex], 0.0f);
+                    cullInstance.command = entry.command;
+                    cullInstance.slot = candidate.slot;
+                    cullInstance.flags = candidate.boneOffset != AnimationLibrary::INVALID_ANIMATION_INDEX ? OcclusionCuller::CULL_ALWAYS_VISIBLE : 0;
+                }
+                mSceneProjectionView = camData.projectionView;
+            }
 
             // Add the scene render pass
             auto& rg = rr->renderGraph;
+            if (static_cast<VKRingBuffer*>(ring)->HasPendingCopies())
+            {
+                // The ring grew this frame, ahead of everything that reads it (the table upload included)
+                rg->AddPass(
+                    "RingGrowPass",
+                    [&](RGPassBuilder& builder) {},
+                    std::bind(&RenderSystem::CopyGrownRingVK, this, std::placeholders::_1)
+                );
+            }
+
+            if (static_cast<VKInstanceTable*>(table)->HasPendingUpload())
+            {
+                // Ahead of everything that reads the table
+                rg->AddPass(
+                    "InstanceUploadPass",
+                    [&](RGPassBuilder& builder) {},
+                    std::bind(&RenderSystem::UploadInstancesVK, this, std::placeholders::_1)
+                );
+            }
+
+            if (mUseGpuOcclusion)
+            {
+                rg->AddPass(
+                    "OcclusionCullPass",
+                    [&](RGPassBuilder& builder) {},
+                    std::bind(&RenderSystem::CullSceneVK, this, std::placeholders::_1)
+                );
+            }
+
+            // Owned by the graph, it only lives from the scene pass to the Hi-Z build
+            RGTextureDesc sceneDepthDesc{};
+            sceneDepthDesc.format = rr->swapChain->GetDepthFormat();
+
             if (Engine::GetEditorEnabled()) 
             {
+                // The editor viewport samples the scene from the graph's textures, at backbuffer size
                 if (rr->useRaytracing)
                 {
+                    RGTextureDesc rtOutputDesc{};
+                    rtOutputDesc.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+
                     rg->AddPass(
                         "ScenePass",
-                        [&](RGPassBuilder& builder) {},
+                        [&](RGPassBuilder& builder)
+                        {
+                            builder.createStorage("RTColor", rtOutputDesc, VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
+                            builder.createStorage("RTHeatmap", rtOutputDesc, VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
+                        },
                         std::bind(&RenderSystem::RaytraceSceneVK, this, std::placeholders::_1)
                     );
                 }
                 else
                 {
-                    rg->AddPass(
+                    RGTextureDesc sceneColorDesc{};
+                    sceneColorDesc.format = rr->device->GetLinearFormat();
+
+                    rg->AddParallelPass(
                         "ScenePass",
                         [&](RGPassBuilder& builder) 
                         {
-                            builder.writes("SceneColor");
-                            builder.writes("SceneDepth");
+                            builder.create("SceneColor", sceneColorDesc);
+                            builder.create("SceneDepth", sceneDepthDesc);
                         },
-                        std::bind(&RenderSystem::RenderSceneVK, this, std::placeholders::_1)
+                        std::bind(&RenderSystem::RenderSceneVK, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                        GetSceneRecordItemCount(), SCENE_DRAWS_PER_RECORDING
                     );
                 }
             }
             else
             {
-                rg->AddPass(
+                rg->AddParallelPass(
                     "ScenePass",
                     [&](RGPassBuilder& builder) 
                     {
                         builder.writes("BackBuffer");
-                        builder.writes("SceneDepth");
+                        builder.create("SceneDepth", sceneDepthDesc);
                     },
-                    std::bind(&RenderSystem::RenderSceneVK, this, std::placeholders::_1)
+                    std::bind(&RenderSystem::RenderSceneVK, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                    GetSceneRecordItemCount(), SCENE_DRAWS_PER_RECORDING
+                );
+            }
+
+            if (mUseGpuOcclusion)
+            {
+                // The graph moves the depth buffer to read-only for the compute reduction
+                rg->AddPass(
+                    "HiZBuildPass",
+                    [&](RGPassBuilder& builder)
+                    {
+                        builder.reads("SceneDepth", VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+                    },
+                    std::bind(&RenderSystem::BuildHiZVK, this, std::placeholders::_1)
                 );
             }
         }
@@ -298,9 +676,72 @@ namespace Radis
 
     void RenderSystem::FrameEnd()
     {
+        if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL)
+        {
+            // Vulkan advances the frame in PresentSystem::FrameEnd
+            auto rr = ecs->GetResource<RenderingResource>();
+            rr->frameRing->EndFrame();
+            rr->currentFrameIndex = (rr->currentFrameIndex + 1) % SwapChain::MAX_FRAMES_IN_FLIGHT;
+        }
+    }
+
+    void RenderSystem::CopyGrownRingVK(VkCommandBuffer cmd)
+    {
+        auto rr = ecs->GetResource<RenderingResource>();
+
+        ScopedDebugLabel ringDebugLabel(rr->device.get(), cmd, "Copy Grown Ring", glm::vec4(0.5f, 0.5f, 1.0f, 1.0f));
+
+        static_cast<VKRingBuffer*>(rr->frameRing.get())->RecordPendingCopies(cmd);
     }
 
-    void RenderSystem::RenderSceneVK(VkCommandBuffer cmd)
+    void RenderSystem::UploadInstancesVK(VkCommandBuffer cmd)
+    {
+        auto rr = ecs->GetResource<RenderingResource>();
+
+        ScopedDebugLabel uploadDebugLabel(rr->device.get(), cmd, "Upload Instances", glm::vec4(0.5f, 0.5f, 1.0f, 1.0f));
+
+        VKInstanceTable* table = static_cast<VKInstanceTable*>(rr->instanceTable.get());
+        table->RecordUpload(cmd, *static_cast<VKRingBuffer*>(rr->frameRing.get()));
+    }
+
+    void RenderSystem::CullSceneVK(VkCommandBuffer cmd)
+    {
+        auto rr = ecs->GetResource<RenderingResource>();
+
+        ScopedDebugLabel cullDebugLabel(rr->device.get(), cmd, "Occlusion Cull", glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+
+        // The depth buffer is a render graph transient, its view is only known once the graph
+        // executes. Nothing recorded before this pass uses the pyramid, so it can be recreated here.
+        const RGResource& depth = rr->renderGraph->GetResource(rr->renderGraph->GetResourceHandle("SceneDepth"));
+        rr->occlusionCuller->Prepare(depth.imageView, depth.extent);
+
+        // Survivors are compacted into this frame's visible slots, over what the CPU wrote there
+        const Buffer& visibleSlots = static_cast<VKRingBuffer*>(rr->frameRing.get())->GetBuffer(rr->currentFrameIndex);
+        rr->occlusionCuller->Cull(cmd, rr->currentFrameIndex, rr->indirectBuffers[rr->currentFrameIndex], visibleSlots, mInstanceOffset, mCullInstanceCount);
+    }
+
+    void RenderSystem::BuildHiZVK(VkCommandBuffer cmd)
+    {
+        auto rr = ecs->GetResource<RenderingResource>();
+
+        ScopedDebugLabel hizDebugLabel(rr->device.get(), cmd, "Build Hi-Z", glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+
+        rr->occlusionCuller->BuildHiZ(cmd, mSceneProjectionView);
+    }
+
+    uint32_t RenderSystem::GetSceneRecordItemCount() const
+    {
+        // The indirect paths are a single call the graph records inline, only the per-draw
+        // fallback is worth splitting across threads
+        auto rr = ecs->GetResource<RenderingResource>();
+        if (rr->device->SupportsDrawIndirectCount() || rr->device->SupportsMultiDrawIndirect())
+        {
+            return 1;
+        }
+        return static_cast<uint32_t>(mDrawCommands.size());
+    }
+
+    void RenderSystem::RenderSceneVK(VkCommandBuffer cmd, uint32_t begin, uint32_t end)
     {
         auto rr = ecs->GetResource<RenderingResource>();
         AnimationLibrary* al = rr->animationLibrary.get();
@@ -323,33 +764,27 @@ namespace Radis
         VkRect2D scissor{ {0, 0}, rr->swapChain->GetSwapChainExtent() };
         vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-        auto& registry = ecs->GetRegistry();
-
         UnifiedMeshes* uMeshes = rr->modelLibrary->GetUnifiedMesh();
         uMeshes->GetUnifiedMesh()->Bind(cmd);
 
-        int baseIndex = 0;
-        Model* cubeModel = ml->TryAddGetModel("Assets/Models/cube.obj");
-        auto& cubeMeshData = uMeshes->GetMeshInfo(cubeModel->mMeshes[0]->GetID());
-        
-        uint32_t debugDrawCount = DebugDrawResource::GetInstanceDataSize();
-        vkCmdDrawIndexed(cmd, cubeMeshData.indexCount, debugDrawCount, cubeMeshData.firstIndex, cubeMeshData.vertexOffset, baseIndex);
-        baseIndex += debugDrawCount;
-        
-        auto entityView = registry.view<ModelComponent, TransformComponent>();
-        for (auto& entityHandle : entityView)
+        // Everything in one call, recording cost doesn't grow with the scene. Without multi-draw
+        // each recording issues its own [begin, end) range of the draws.
+        const Buffer& indirect = rr->indirectBuffers[rr->currentFrameIndex];
+        const uint32_t drawCount = static_cast<uint32_t>(mDrawCommands.size());
+        constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        if (rr->device->SupportsDrawIndirectCount())
         {
-            Entity entity(&registry, entityHandle);
-            ModelComponent& mc = entity.GetComponent<ModelComponent>();
-            Model* model = rr->modelLibrary->GetModel(mc.ModelPath);
-            if (!model) continue;
-
-            for (auto& mesh : model->mMeshes)
+            vkCmdDrawIndexedIndirectCount(cmd, indirect.buffer, RenderingResource::INDIRECT_COMMANDS_OFFSET, indirect.buffer, 0, RenderingResource::MAX_INDIRECT_DRAWS, stride);
+        }
+        else if (rr->device->SupportsMultiDrawIndirect())
+        {
+            vkCmdDrawIndexedIndirect(cmd, indirect.buffer, RenderingResource::INDIRECT_COMMANDS_OFFSET, drawCount, stride);
+        }
+        else
+        {
+            for (uint32_t i = begin; i < std::min(end, drawCount); ++i)
             {
-                auto& meshData = uMeshes->GetMeshInfo(mesh->GetID());
-                vkCmdDrawIndexed(cmd, meshData.indexCount, 1, meshData.firstIndex, meshData.vertexOffset, baseIndex);
-
-                ++baseIndex;
+                vkCmdDrawIndexedIndirect(cmd, indirect.buffer, RenderingResource::INDIRECT_COMMANDS_OFFSET + i * stride, 1, stride);
             }
         }
     }
@@ -383,65 +818,30 @@ namespace Radis
         }
 
 
-        GLShader::SetupInstanceSSBO();
-        GLuint iSSBO = GLShader::GetInstanceSSBO();
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, iSSBO);
-        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, mInstanceData.size() * sizeof(InstanceUniforms), mInstanceData.data());
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        
+        // Instance table (1), then bones (2), lights (4), the visible instance slots (5) and the
+        // light grid (6) from this frame's ring slot
+        auto ar = ecs->GetResource<AnimationResource>();
+        static_cast<const GLInstanceTable*>(rr->instanceTable.get())->Bind(1);
+        const GLRingBuffer* ring = static_cast<const GLRingBuffer*>(rr->frameRing.get());
+        ring->BindRange(2, ar->boneOffset, ar->boneCount * sizeof(VQS));
+        ring->BindRange(4, mLightOffset, mLightBytes);
+        ring->BindRange(5, mInstanceOffset, mInstanceCount * sizeof(uint32_t));
+        ring->BindRange(6, mLightGridOffset, mLightGridBytes);
+
         GLShader::SetupTextureSSBO();
         GLuint textureSSBO = GLShader::GetTextureSSBO();
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, textureSSBO);
         glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, textureData.size() * sizeof(uint64_t), textureData.data());
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-        GLShader::SetupLightSSBO();
-        GLuint lightSSBO = GLShader::GetLightSSBO();
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightSSBO);
-        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, mLightBuffer.size(), mLightBuffer.data());
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-
         UnifiedMeshes* uMeshes = rr->modelLibrary->GetUnifiedMesh();
         uMeshes->GetUnifiedMesh()->Bind();
 
-        int baseIndex = 0;
-        Model* cubeModel = ml->GetModel("Assets/Models/cube.obj");
-        auto& cubeMeshData = uMeshes->GetMeshInfo(cubeModel->mMeshes[0]->GetID());
-
-        uint32_t debugDrawCount = DebugDrawResource::GetInstanceDataSize();
-        glDrawElementsInstancedBaseVertexBaseInstance(
-            GL_TRIANGLES,
-            static_cast<GLsizei>(cubeMeshData.indexCount),
-            GL_UNSIGNED_INT,
-            (void*)(sizeof(uint32_t) * cubeMeshData.firstIndex),
-            debugDrawCount,
-            cubeMeshData.vertexOffset,
-            baseIndex
-        );
-        baseIndex += debugDrawCount;
-        
-        auto& registry = ecs->GetRegistry();
-        registry.view<ModelComponent, TransformComponent>().each([&](auto entityHandle, ModelComponent& mc, TransformComponent& tc)
-        {
-            Model* model = rr->modelLibrary->GetModel(mc.ModelPath);
-            if (!model) return;
-
-            for (auto& mesh : model->mMeshes)
-            {
-                auto& meshData = uMeshes->GetMeshInfo(mesh->GetID());
-                glDrawElementsInstancedBaseVertexBaseInstance(
-                    GL_TRIANGLES,
-                    static_cast<GLsizei>(meshData.indexCount),
-                    GL_UNSIGNED_INT,
-                    (void*)(sizeof(uint32_t) * meshData.firstIndex),
-                    1,
-                    meshData.vertexOffset,
-                    baseIndex
-                );
-
-                ++baseIndex;
-            }
-        });
+        GLShader::SetupIndirectBuffer(RenderingResource::MAX_INDIRECT_DRAWS);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, GLShader::GetIndirectBuffer());
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, mDrawCommands.size() * sizeof(VkDrawIndexedIndirectCommand), mDrawCommands.data());
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(mDrawCommands.size()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
         if (Engine::GetEditorEnabled())
         {
@@ -456,17 +856,17 @@ namespace Radis
 
         ScopedDebugLabel rtDebugLabel(rr->device.get(), cmd, "Raytrace Scene", glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
      
-        // Update TLAS with mInstanceData
+        // Update TLAS with this frame's instances, the custom index is the instance table slot
         {
             std::vector<VkAccelerationStructureInstanceKHR> tlasInstances;
-            tlasInstances.reserve(mInstanceData.size());
-            for (size_t i = 0; i < mInstanceData.size(); ++i)
+            tlasInstances.reserve(mSortKeys.size());
+            for (size_t i = 0; i < mSortKeys.size(); ++i)
             {
-                const auto& instanceData = mInstanceData[i];
+                const MeshCandidate& candidate = mMeshCandidates[mSortKeys[i] & SORT_KEY_CANDIDATE_MASK];
                 VkAccelerationStructureInstanceKHR asInstance{};
-                asInstance.transform = toTransformMatrixKHR(instanceData.model);  // Position of the instance
-                asInstance.instanceCustomIndex = static_cast<uint32_t>(i); // gl_InstanceCustomIndexEXT
-                asInstance.accelerationStructureReference = rr->blasAccel[instanceData.meshID].address;
+                asInstance.transform = toTransformMatrixKHR(candidate.transform);  // Position of the instance
+                asInstance.instanceCustomIndex = candidate.slot; // gl_InstanceCustomIndexEXT
+                asInstance.accelerationStructureReference = rr->blasAccel[candidate.mesh->GetID()].address;
                 asInstance.instanceShaderBindingTableRecordOffset = 0;  // We will use the same hit group for all objects
                 asInstance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;  // No culling - double sided
                 asInstance.mask = 0xFF;
@@ -494,6 +894,17 @@ namespace Radis
         // Ray trace pipeline
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, rp->GetPipeline());
 
+        // The outputs are render graph transients, their views are only known now. This frame's
+        // fence has been waited on, so its set isn't in use.
+        const RGResource& colorOutput = rr->renderGraph->GetResource(rr->renderGraph->GetResourceHandle("RTColor"));
+        const RGResource& heatmapOutput = rr->renderGraph->GetResource(rr->renderGraph->GetResourceHandle("RTHeatmap"));
+        VkDescriptorImageInfo colorInfo{ VK_NULL_HANDLE, colorOutput.imageView, VK_IMAGE_LAYOUT_GENERAL };
+        VkDescriptorImageInfo heatmapInfo{ VK_NULL_HANDLE, heatmapOutput.imageView, VK_IMAGE_LAYOUT_GENERAL };
+        DescriptorWriter(*rr->rtUniform->GetDescriptorLayout(), *rr->rtUniform->GetDescriptorPool())
+            .WriteImage(1, &colorInfo)
+            .WriteImage(2, &heatmapInfo)
+            .Overwrite(rr->rtUniform->GetDescriptorSets()[rr->currentFrameIndex]);
+
         // Bind the descriptor sets for the graphics pipeline (making textures available to the shaders)
         rr->cameraUniform->Bind(cmd, rp->GetLayout(), rr->currentFrameIndex, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR);
         rr->rtUniform->Bind(cmd, rp->GetLayout(), rr->currentFrameIndex, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR);
@@ -501,24 +912,6 @@ namespace Radis
         // Ray trace
         const VkExtent2D& size = rr->swapChain->GetSwapChainExtent();
         vkCmdTraceRaysKHR(cmd, &rp->GetRaygenRegion(), &rp->GetMissRegion(), &rp->GetHitRegion(), &rp->GetCallableRegion(), size.width, size.height, 1);
-
-        VkMemoryBarrier2 memoryBarrier = {
-            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
-            .pNext = nullptr,
-            .srcStageMask = VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR,
-            .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
-            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
-            .dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT
-        };
-
-        VkDependencyInfo dependencyInfo = {
-            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            .pNext = nullptr,
-            .memoryBarrierCount = 1,
-            .pMemoryBarriers = &memoryBarrier
-        };
-
-        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
     }
 
     float RenderSystem::GetAspectRatio()
@@ -533,4 +926,14 @@ namespace Radis
         glm::uvec2 extant = wr->window->GetExtent();
         return static_cast<float>(extant.x) / static_cast<float>(extant.y);
     }
+
+    float RenderSystem::GetViewportHeight()
+    {
+        if (Engine::GetEditorEnabled())
+        {
+            return ecs->GetResource<EditorResource>()->sceneWindowHeight;
+        }
+
+        return static_cast<float>(ecs->GetResource<WindowResource>()->window->GetExtent().y);
+    }
 }
@@ -2,9 +2,15 @@
 
 #include "../ISystem.h"
 #include "Graphics/Vulkan/Uniform/ShaderTypes.h"
+#include "Graphics/Common/UnifiedMesh.h"
+#include "Graphics/Common/Frustum.h"
+#include "Graphics/Common/LightGrid.h"
 
 namespace Radis
 {
+    struct ModelComponent;
+    class InstanceTable;
+
     class RenderSystem : public ISystem
     {
     public:
@@ -19,18 +25,84 @@ namespace Radis
 
 
     private:
-        void RenderSceneVK(VkCommandBuffer cmd);
+        void OnInstanceDestroyed(entt::registry& registry, entt::entity entity);
+        void OnModelRemoved(entt::registry& registry, entt::entity entity);
+
+        void CopyGrownRingVK(VkCommandBuffer cmd);
+        void UploadInstancesVK(VkCommandBuffer cmd);
+        void CullSceneVK(VkCommandBuffer cmd);
+        // Records draws [begin, end) of the scene pass, called once per parallel recording
+        void RenderSceneVK(VkCommandBuffer cmd, uint32_t begin, uint32_t end);
+        uint32_t GetSceneRecordItemCount() const;
+        void BuildHiZVK(VkCommandBuffer cmd);
         void RaytraceSceneVK(VkCommandBuffer cmd);
         void RenderSceneGL();
 
         float GetAspectRatio();
+        float GetViewportHeight();
 
         std::vector<MeshDataUniform> mRTMeshData{};
         std::vector<uint32_t> mRTMeshIndices{};
 
-        std::vector<InstanceUniforms> mInstanceData{};
-        std::vector<LightUniform> mLightData{};
-        std::vector<uint8_t> mLightBuffer{};
+        // Every mesh of every model this frame, before culling. Parallel to mCullBatch.
+        struct MeshCandidate
+        {
+            const IMesh* mesh;
+            glm::mat4 transform;
+            uint32_t boneOffset;
+            uint32_t slot;       // in the instance table
+        };
+        std::vector<MeshCandidate> mMeshCandidates{};
+        CullBatch mCullBatch{};
+
+        // One instanced draw per unique visible mesh LOD, written to the indirect buffer and issued
+        // with a single call. Instances are sorted by mesh ID and LOD so each command covers a
+        // contiguous run of the visible slot list, cluster culled instances add one per meshlet run.
+        // The debug cubes are always the first command.
+        static constexpr uint32_t SORT_KEY_LOD_SHIFT = 28;
+        static constexpr uint64_t SORT_KEY_CANDIDATE_MASK = (1ull << SORT_KEY_LOD_SHIFT) - 1;
+        std::vector<uint64_t> mSortKeys{};   // meshID << 32 | lod << SORT_KEY_LOD_SHIFT | candidate index
+        std::vector<VkDrawIndexedIndirectCommand> mDrawCommands{};
+        static constexpr uint32_t SCENE_DRAWS_PER_RECORDING = 256; // per secondary command buffer
+
+        // What each visible slot after the debug cubes draws, in sort key order: a whole mesh LOD,
+        // or one run of meshlets that survived cluster culling. Cluster runs of the same instance
+        // repeat its slot and get a command of their own.
+        struct DrawEntry
+        {
+            uint32_t candidate;
+            uint32_t indexCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            bool clustered;
+            uint32_t command;    // in mDrawCommands
+        };
+        std::vector<DrawEntry> mDrawEntries{};
+        std::vector<ClusterRun> mClusterRuns{};
+        uint32_t mDebugInstanceCount = 0;    // debug draw instances at the front of the visible slots
+
+        // Instance table bookkeeping. Entities hold their slots in RenderInstanceComponent, the
+        // debug cubes share one region that only grows.
+        uint32_t mInstanceGeneration = 0;    // ModelLibrary generation the slots were written against
+        uint32_t mDebugFirstSlot = UINT32_MAX;
+        uint32_t mDebugSlotCount = 0;
+
+        // GPU occlusion culling uploads the mesh commands empty, the cull shader fills in their
+        // instance counts and compacts the survivors' slots to the front of each command's range
+        bool mUseGpuOcclusion = false;
+        uint32_t mCullInstanceCount = 0;
+        glm::mat4 mSceneProjectionView{ 1.0f };
+
+        // This frame's visible instance slots and light data in the frame ring buffer
+        uint32_t mInstanceOffset = 0;
+        uint32_t mInstanceCount = 0;
+        uint32_t mLightOffset = 0;
+        uint32_t mLightBytes = 0;
+        uint32_t mLightGridOffset = 0;
+        uint32_t mLightGridBytes = 0;
+
+        std::vector<LightUniform> mLights{};
+        LightGrid mLightGrid{};
     };
 }
 
@@ -2,7 +2,6 @@
 #include "SwapRendererSystem.h"
 
 #include "ECS/Resources/renderingResource.h"
-#include "ECS/Resources/EditorResource.h"
 #include "ECS/Resources/WindowResource.h"
 #include "ECS/Resources/SwapRendererResource.h"
 #include "../InputSystem.h"
@@ -18,6 +17,8 @@ namespace Radis
 {
     void SwapRendererSystem::Init()
     {
+        Access().Read<SwapRendererResource>();
+
         auto sr = ecs->GetResource<SwapRendererResource>();
 
         bool canVulkan = Engine::GetVulkanSupported();
@@ -44,19 +45,4 @@ namespace Radis
             sr->swapRequested = false;
         }
     }
-
-    void SwapRendererSystem::FrameEnd()
-    {
-        auto er = ecs->GetResource<EditorResource>();
-        if (er->entityToDelete)
-        {
-            if (er->selectedEntity == er->entityToDelete)
-            {
-                er->selectedEntity = {};
-            }
-
-            ecs->RemoveEntity(er->entityToDelete);
-            er->entityToDelete = {};
-        }
-    }
 }
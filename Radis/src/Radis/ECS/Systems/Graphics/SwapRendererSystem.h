@@ -13,6 +13,5 @@ namespace Radis
 
         void Init() override;
         void FrameStart() override;
-        void FrameEnd() override;
     };
 }
\ No newline at end of file
@@ -1,2 +1,39 @@
 #include <PCH/pch.h>
-#include "ISystem.h"
\ No newline at end of file
+#include "ISystem.h"
+
+namespace Radis
+{
+    static bool Intersects(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b)
+    {
+        for (const auto& type : a)
+        {
+            if (std::find(b.begin(), b.end(), type) != b.end()) return true;
+        }
+        return false;
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+    {
+        if (!mDeclared || !other.mDeclared) return true;
+
+        // Structural changes invalidate every view, so they conflict with anything touching components.
+        if (mStructural && (other.mStructural || !other.mStorages.empty())) return true;
+        if (other.mStructural && !mStorages.empty()) return true;
+
+        return Intersects(mWrites, other.mWrites)
+            || Intersects(mWrites, other.mReads)
+            || Intersects(mReads, other.mWrites)
+            || Intersects(mAppends, other.mReads)
+            || Intersects(mAppends, other.mWrites)
+            || Intersects(mReads, other.mAppends)
+            || Intersects(mWrites, other.mAppends);
+    }
+
+    void SystemAccess::AssureStorage(entt::registry& registry) const
+    {
+        for (auto assure : mStorages)
+        {
+            assure(registry);
+        }
+    }
+}
@@ -1,7 +1,74 @@
 #pragma once
 
-namespace Radis 
+#include "../Resources/IResource.h"
+
+namespace Radis
 {
+    // What a system touches during Update. The ECS uses this to run systems that don't
+    // conflict at the same time; conflicting systems keep their registration order.
+    // A system that never declares anything is exclusive and runs alone.
+    class SystemAccess
+    {
+    public:
+        template<typename... Ts>
+        SystemAccess& Read()
+        {
+            (Add<Ts>(mReads), ...);
+            mDeclared = true;
+            return *this;
+        }
+
+        template<typename... Ts>
+        SystemAccess& Write()
+        {
+            (Add<Ts>(mWrites), ...);
+            mDeclared = true;
+            return *this;
+        }
+
+        // Commutative writes (e.g. pushing debug draws into an internally locked list). Appenders
+        // may run together, but are still ordered against plain readers and writers.
+        template<typename... Ts>
+        SystemAccess& Append()
+        {
+            (Add<Ts>(mAppends), ...);
+            mDeclared = true;
+            return *this;
+        }
+
+        // Creates/destroys entities or adds/removes components during Update.
+        SystemAccess& Structural() { mStructural = true; mDeclared = true; return *this; }
+
+        // Has to run on the main thread (GLFW, ImGui, OpenGL context).
+        SystemAccess& MainThread() { mMainThread = true; return *this; }
+
+        bool IsDeclared() const { return mDeclared; }
+        bool IsMainThread() const { return mMainThread; }
+        bool ConflictsWith(const SystemAccess& other) const;
+
+        // entt creates storage lazily on first view/get, which isn't safe from several threads.
+        void AssureStorage(entt::registry& registry) const;
+
+    private:
+        template<typename T>
+        void Add(std::vector<std::type_index>& set)
+        {
+            set.emplace_back(typeid(T));
+            if constexpr (!std::is_base_of_v<IResource, T>)
+            {
+                mStorages.push_back(+[](entt::registry& registry) { registry.storage<T>(); });
+            }
+        }
+
+        std::vector<std::type_index> mReads;
+        std::vector<std::type_index> mWrites;
+        std::vector<std::type_index> mAppends;
+        std::vector<void(*)(entt::registry&)> mStorages;
+        bool mDeclared = false;
+        bool mStructural = false;
+        bool mMainThread = false;
+    };
+
     class ISystem
     {
     public:
@@ -10,17 +77,26 @@ namespace Radis
 
         virtual void Init() {};
         virtual void FrameStart() {};
+        virtual void FixedUpdate(float fixedDt) {};   // simulation step, EngineSpec::simRate times per second
         virtual void Update(float dt) {};
         virtual void FrameEnd() {};
         virtual void Exit() {};
 
         const std::string& GetDebugName() const { return mDebugName; }
+        const SystemAccess& GetAccess() const { return mAccess; }
+
+        // Checked every frame, so systems whose affinity depends on the backend can override it.
+        virtual bool RunsOnMainThread() const { return mAccess.IsMainThread(); }
 
     protected:
         friend class ECS;
         ECS* ecs;
 
+        // Declare in Init(), the ECS builds its schedule right after.
+        SystemAccess& Access() { return mAccess; }
+
     private:
         std::string mDebugName;
+        SystemAccess mAccess;
     };
 }
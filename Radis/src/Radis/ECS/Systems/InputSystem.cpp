@@ -41,6 +41,8 @@ namespace Radis {
 
 	void InputSystem::Init()
 	{
+		Access().Write<InputResource>().MainThread();
+
 		InputSystem::pwindow = ecs->GetResource<WindowResource>()->window->GetGLFWwindow();
 
 		glfwSetKeyCallback(InputSystem::pwindow, keyPressCallback);
@@ -9,13 +9,33 @@ namespace Radis
 {
     void PhysicsSystem::Init()
     {
+        Access()
+            .Write<SoftBodyComponent>()
+            .Append<DebugDrawResource>();
     }
-    
-    void PhysicsSystem::Update(float dt)
+
+    void PhysicsSystem::FixedUpdate(float fixedDt)
     {
-        if (dt > 0.05f) dt = 0.05f;
-        dt = 0.0001f;
+        m_accumulatedTime += fixedDt;
+
+        // Explicit RK2 on the default cube (k = 50, c = 10, up to 14 springs per particle)
+        // diverges above h ~= 0.022s, so substep with margin whatever the sim rate is.
+        constexpr float MAX_SOFT_BODY_STEP = 1.0f / 120.0f;
+        const uint32_t substeps = std::max(1u, static_cast<uint32_t>(std::ceil(fixedDt / MAX_SOFT_BODY_STEP)));
+        const float h = fixedDt / static_cast<float>(substeps);
+
+        auto& registry = ecs->GetRegistry();
+        registry.view<SoftBodyComponent>().each([&](auto entity, SoftBodyComponent& softBody)
+        {
+            // Integrate with RK2.
+            for (uint32_t step = 0; step < substeps; ++step)
+                IntegrateSoftBodyRK2(softBody, h);
+        });
+    }
 
+    void PhysicsSystem::Update(float dt)
+    {
+        // Goes through the command buffer, so Physics doesn't have to be structural.
         static bool first = true;
         if (first)
         {
@@ -23,15 +43,10 @@ namespace Radis
             first = false;
         }
 
-        m_accumulatedTime += dt;
-
+        // Drawn once per rendered frame, however many steps ran
         auto& registry = ecs->GetRegistry();
         registry.view<SoftBodyComponent>().each([&](auto entity, SoftBodyComponent& softBody)
         {
-            // Integrate with RK2.
-            IntegrateSoftBodyRK2(softBody, dt);
-
-            // Draw body
             DebugDrawSoftBody(softBody);
         });
     }
@@ -43,9 +58,8 @@ namespace Radis
 
     void PhysicsSystem::CreateSoftBodyCube()
     {
-        // Create entity & add soft-body component.
-        Entity entity = ecs->AddEntity("SoftBodyCube");
-        SoftBodyComponent& softBody = entity.AddComponent<SoftBodyComponent>();
+        // Built here, the entity and component are added when the ECS plays back its commands.
+        SoftBodyComponent softBody;
 
         // Cube layout: 4 x 4 x 4 = 64 points
         const std::uint32_t nx = 4;
@@ -145,6 +159,10 @@ namespace Radis
 
         softBody.particles[leftTopFront].anchorPosition = softBody.particles[leftTopFront].position;
         softBody.particles[rightTopFront].anchorPosition = softBody.particles[rightTopFront].position;
+
+        EntityCommandBuffer& commands = ecs->Commands();
+        auto entity = commands.CreateEntity("SoftBodyCube");
+        commands.AddComponent<SoftBodyComponent>(entity, std::move(softBody));
     }
 
     void PhysicsSystem::IntegrateSoftBodyRK2(SoftBodyComponent& softBody, float dt)
@@ -260,6 +278,7 @@ namespace Radis
             const float stretch = length - spring.restLength;
             const float relativeSpeed = glm::dot(vb - va, dir);
 
+            // Force on b, pulls it back towards a when stretched.
             const glm::vec3 force =
                 -spring.stiffness * stretch * dir
                 - spring.damping * relativeSpeed * dir;
@@ -269,12 +288,12 @@ namespace Radis
 
             if (!pa.isAnchor && pa.inverseMass > 0.0f)
             {
-                outAccelerations[ia] += force * pa.inverseMass;
+                outAccelerations[ia] -= force * pa.inverseMass;
             }
 
             if (!pb.isAnchor && pb.inverseMass > 0.0f)
             {
-                outAccelerations[ib] -= force * pb.inverseMass;
+                outAccelerations[ib] += force * pb.inverseMass;
             }
         }
 
@@ -13,6 +13,7 @@ namespace Radis
         ~PhysicsSystem() {}
 
         void Init() override;
+        void FixedUpdate(float fixedDt) override;
         void Update(float dt) override;
         void FrameEnd() override;
 
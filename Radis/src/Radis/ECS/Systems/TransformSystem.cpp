@@ -0,0 +1,265 @@
+#include <PCH/pch.h>
+#include "TransformSystem.h"
+
+#include "ECS/ECS.h"
+#include "ECS/Components/Components.h"
+
+#include "Jobs/JobSystem.h"
+
+namespace Radis
+{
+    // Parent links only count when the parent has a transform of its own.
+    static bool HasTransformParent(const entt::registry& registry, entt::entity entity)
+    {
+        const auto* hc = registry.try_get<HierarchyComponent>(entity);
+        return hc && hc->Parent != entt::null && registry.all_of<WorldTransformComponent>(hc->Parent);
+    }
+
+    void TransformSystem::ComposeBatch::Resize(size_t count)
+    {
+        translation.resize(count);
+        scale.resize(count);
+        rotX.resize(count); rotY.resize(count); rotZ.resize(count);
+        sinX.resize(count); sinY.resize(count); sinZ.resize(count);
+        cosX.resize(count); cosY.resize(count); cosZ.resize(count);
+        world.resize(count);
+    }
+
+    void TransformSystem::Init()
+    {
+        Access()
+            .Read<TransformComponent>()
+            .Write<WorldTransformComponent>();
+
+        entt::registry& registry = ecs->GetRegistry();
+        registry.on_construct<TransformComponent>().connect<&entt::registry::emplace_or_replace<WorldTransformComponent>>();
+        registry.on_construct<HierarchyComponent>().connect<&TransformSystem::OnHierarchyChanged>(this);
+        registry.on_update<HierarchyComponent>().connect<&TransformSystem::OnHierarchyChanged>(this);
+        registry.on_destroy<HierarchyComponent>().connect<&TransformSystem::OnHierarchyChanged>(this);
+        registry.on_construct<WorldTransformComponent>().connect<&TransformSystem::OnWorldTransformChanged>(this);
+        registry.on_destroy<WorldTransformComponent>().connect<&TransformSystem::OnWorldTransformChanged>(this);
+
+        // Entities created before the hook was connected
+        for (auto entityHandle : registry.view<TransformComponent>(entt::exclude<WorldTransformComponent>))
+        {
+            registry.emplace<WorldTransformComponent>(entityHandle);
+        }
+    }
+
+    void TransformSystem::Update(float dt)
+    {
+        entt::registry& registry = ecs->GetRegistry();
+        auto view = registry.view<TransformComponent, WorldTransformComponent>();
+        ++mFrame;
+
+        // Links changed: every linked entity rebuilds, which also resets World on new roots.
+        if (mHierarchyDirty)
+        {
+            for (auto [entityHandle, hc, wtc] : registry.view<HierarchyComponent, WorldTransformComponent>().each())
+            {
+                wtc.BuiltScale = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+            }
+        }
+
+        // Components are edited in place through references, so on_update never fires -
+        // compare against the TRS each matrix was built from instead.
+        auto& batch = mBatch;
+        batch.entities.clear();
+        for (auto [entityHandle, tc, wtc] : view.each())
+        {
+            if (tc.Translation != wtc.BuiltTranslation || tc.Rotation != wtc.BuiltRotation || tc.Scale != wtc.BuiltScale)
+            {
+                batch.entities.push_back(entityHandle);
+            }
+        }
+
+        const size_t count = batch.entities.size();
+
+        batch.Resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TransformComponent& tc = view.get<TransformComponent>(batch.entities[i]);
+            batch.translation[i] = tc.Translation;
+            batch.scale[i] = tc.Scale;
+            batch.rotX[i] = tc.Rotation.x;
+            batch.rotY[i] = tc.Rotation.y;
+            batch.rotZ[i] = tc.Rotation.z;
+        }
+
+        JobSystem::ParallelFor(count, 1024, [&batch](size_t begin, size_t end)
+        {
+            Compose(batch, begin, end);
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TransformComponent& tc = view.get<TransformComponent>(batch.entities[i]);
+            WorldTransformComponent& wtc = view.get<WorldTransformComponent>(batch.entities[i]);
+            wtc.Local = batch.world[i];
+            wtc.LocalFrame = mFrame;
+            wtc.BuiltTranslation = tc.Translation;
+            wtc.BuiltRotation = tc.Rotation;
+            wtc.BuiltScale = tc.Scale;
+
+            if (!HasTransformParent(registry, batch.entities[i]))
+            {
+                wtc.World = wtc.Local;
+            }
+        }
+
+        if (mHierarchyDirty)
+        {
+            RebuildHierarchy(registry);
+        }
+        PropagateHierarchy(registry);
+    }
+
+    void TransformSystem::OnHierarchyChanged(entt::registry& registry, entt::entity entity)
+    {
+        mHierarchyDirty = true;
+
+        // Covers HierarchyComponent being removed, where the view above no longer sees the entity.
+        if (auto* wtc = registry.try_get<WorldTransformComponent>(entity))
+        {
+            wtc->BuiltScale = glm::vec3(std::numeric_limits<float>::quiet_NaN());
+        }
+    }
+
+    void TransformSystem::OnWorldTransformChanged(entt::registry& registry, entt::entity entity)
+    {
+        if (registry.all_of<HierarchyComponent>(entity))
+        {
+            mHierarchyDirty = true;
+        }
+    }
+
+    void TransformSystem::RebuildHierarchy(entt::registry& registry)
+    {
+        mHierarchyDirty = false;
+        mNodes.clear();
+        mNodeParent.clear();
+        mLevelOffsets.clear();
+
+        for (auto [entityHandle, hc] : registry.view<HierarchyComponent>().each())
+        {
+            if (hc.FirstChild != entt::null && registry.all_of<WorldTransformComponent>(entityHandle) && !HasTransformParent(registry, entityHandle))
+            {
+                mNodes.push_back(entityHandle);
+                mNodeParent.push_back(NO_PARENT);
+            }
+        }
+
+        mLevelOffsets.push_back(0);
+        for (size_t levelBegin = 0; levelBegin < mNodes.size();)
+        {
+            const size_t levelEnd = mNodes.size();
+            mLevelOffsets.push_back(levelEnd);
+
+            for (size_t i = levelBegin; i < levelEnd; ++i)
+            {
+                entt::entity child = registry.get<HierarchyComponent>(mNodes[i]).FirstChild;
+                while (child != entt::null)
+                {
+                    // A child without a transform breaks the chain; its own children are roots.
+                    if (registry.all_of<WorldTransformComponent>(child))
+                    {
+                        mNodes.push_back(child);
+                        mNodeParent.push_back(static_cast<uint32_t>(i));
+                    }
+                    child = registry.get<HierarchyComponent>(child).NextSibling;
+                }
+            }
+            levelBegin = levelEnd;
+        }
+
+        mNodeLocal.resize(mNodes.size());
+        mNodeWorld.resize(mNodes.size());
+        mNodeChanged.resize(mNodes.size());
+    }
+
+    void TransformSystem::PropagateHierarchy(entt::registry& registry)
+    {
+        if (mNodes.empty()) return;
+
+        auto& worlds = registry.storage<WorldTransformComponent>();
+
+        // Levels run in order; entities within a level only read their parent's slot from the
+        // level before, so each level is split across workers.
+        for (size_t level = 0; level + 1 < mLevelOffsets.size(); ++level)
+        {
+            const size_t levelBegin = mLevelOffsets[level];
+            const size_t levelEnd = mLevelOffsets[level + 1];
+
+            JobSystem::ParallelFor(levelEnd - levelBegin, 256, [&, levelBegin](size_t begin, size_t end)
+            {
+                for (size_t i = levelBegin + begin; i < levelBegin + end; ++i)
+                {
+                    WorldTransformComponent& wtc = worlds.get(mNodes[i]);
+                    bool changed = wtc.LocalFrame == mFrame;
+                    if (changed)
+                    {
+                        mNodeLocal[i] = wtc.Local;
+                    }
+
+                    const uint32_t parent = mNodeParent[i];
+                    if (parent == NO_PARENT)
+                    {
+                        if (changed) mNodeWorld[i] = mNodeLocal[i];
+                    }
+                    else
+                    {
+                        changed = changed || mNodeChanged[parent];
+                        if (changed)
+                        {
+                            mNodeWorld[i] = mNodeWorld[parent] * mNodeLocal[i];
+                            wtc.World = mNodeWorld[i];
+                        }
+                    }
+                    mNodeChanged[i] = changed;
+                }
+            });
+        }
+    }
+
+    void TransformSystem::Compose(ComposeBatch& batch, size_t begin, size_t end)
+    {
+        // Half-angle sin/cos over plain float arrays, no dependencies between iterations
+        for (size_t i = begin; i < end; ++i)
+        {
+            batch.sinX[i] = std::sin(batch.rotX[i] * 0.5f);
+            batch.cosX[i] = std::cos(batch.rotX[i] * 0.5f);
+            batch.sinY[i] = std::sin(batch.rotY[i] * 0.5f);
+            batch.cosY[i] = std::cos(batch.rotY[i] * 0.5f);
+            batch.sinZ[i] = std::sin(batch.rotZ[i] * 0.5f);
+            batch.cosZ[i] = std::cos(batch.rotZ[i] * 0.5f);
+        }
+
+        // Same result as GetTransform() (translate * toMat4(quat(euler)) * scale) without the mat4 products
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float sx = batch.sinX[i], cx = batch.cosX[i];
+            const float sy = batch.sinY[i], cy = batch.cosY[i];
+            const float sz = batch.sinZ[i], cz = batch.cosZ[i];
+
+            // glm::quat(eulerAngles)
+            const float w = cx * cy * cz + sx * sy * sz;
+            const float x = sx * cy * cz - cx * sy * sz;
+            const float y = cx * sy * cz + sx * cy * sz;
+            const float z = cx * cy * sz - sx * sy * cz;
+
+            // glm::mat3_cast
+            const float xx = x * x, yy = y * y, zz = z * z;
+            const float xy = x * y, xz = x * z, yz = y * z;
+            const float wx = w * x, wy = w * y, wz = w * z;
+
+            const glm::vec3& s = batch.scale[i];
+            const glm::vec3& t = batch.translation[i];
+
+            glm::mat4& m = batch.world[i];
+            m[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * s.x;
+            m[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * s.y;
+            m[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * s.z;
+            m[3] = glm::vec4(t, 1.0f);
+        }
+    }
+}
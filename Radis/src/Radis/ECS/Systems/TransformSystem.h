@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ISystem.h"
+
+namespace Radis
+{
+    // Keeps WorldTransformComponent in sync with TransformComponent and HierarchyComponent. Only
+    // entities whose TRS changed since the last build are recomposed, so a static scene costs one
+    // compare per entity. Parented entities are then propagated level by level from the roots.
+    class TransformSystem : public ISystem
+    {
+    public:
+        TransformSystem() : ISystem("TransformSystem") {};
+        ~TransformSystem() {}
+
+        void Init();
+        void Update(float dt);
+
+    private:
+        // Dirty entities gathered into flat arrays so the compose loops vectorize.
+        // Kept between frames to avoid reallocating.
+        struct ComposeBatch
+        {
+            std::vector<entt::entity> entities;
+            std::vector<glm::vec3> translation;
+            std::vector<glm::vec3> scale;
+            std::vector<float> rotX, rotY, rotZ;
+            std::vector<float> sinX, sinY, sinZ;
+            std::vector<float> cosX, cosY, cosZ;
+            std::vector<glm::mat4> world;
+
+            void Resize(size_t count);
+        };
+
+        static void Compose(ComposeBatch& batch, size_t begin, size_t end);
+
+        void OnHierarchyChanged(entt::registry& registry, entt::entity entity);
+        void OnWorldTransformChanged(entt::registry& registry, entt::entity entity);
+        void RebuildHierarchy(entt::registry& registry);
+        void PropagateHierarchy(entt::registry& registry);
+
+        ComposeBatch mBatch;
+        uint32_t mFrame = 0;
+
+        // Every entity that has, or is, a parent, in breadth-first order so each level is
+        // contiguous and only reads the one before it. Rebuilt when links change.
+        static constexpr uint32_t NO_PARENT = ~0u;
+        std::vector<entt::entity> mNodes;
+        std::vector<uint32_t> mNodeParent;   // index into mNodes, NO_PARENT for roots
+        std::vector<size_t> mLevelOffsets;   // level i is [mLevelOffsets[i], mLevelOffsets[i + 1])
+        std::vector<glm::mat4> mNodeLocal;
+        std::vector<glm::mat4> mNodeWorld;
+        std::vector<uint8_t> mNodeChanged;
+        bool mHierarchyDirty = true;
+    };
+}
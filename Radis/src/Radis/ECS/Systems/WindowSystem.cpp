@@ -7,6 +7,11 @@
 
 namespace Radis
 {
+    void WindowSystem::Init()
+    {
+        Access().Read<WindowResource>().MainThread();
+    }
+
     void WindowSystem::Update(float dt)
     {
         auto wr = ecs->GetResource<WindowResource>();
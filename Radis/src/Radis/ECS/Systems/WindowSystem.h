@@ -10,6 +10,7 @@ namespace Radis
         WindowSystem() : ISystem("WindowSystem") {};
         ~WindowSystem() {}
 
+        void Init() override;
         void Update(float dt) override;
         void FrameEnd() override;
     };
@@ -10,6 +10,7 @@
 #include "ECS/Systems/Graphics/RenderSystem.h"
 #include "ECS/Systems/Graphics/SwapRendererSystem.h"
 #include "ECS/Systems/Physics/PhysicsSystem.h"
+#include "ECS/Systems/TransformSystem.h"
 
 #include "ECS/Resources/InputResource.h"
 #include "ECS/Resources/WindowResource.h"
@@ -20,9 +21,11 @@
 #include "ECS/Resources/AnimationResource.h"
 #include "ECS/Resources/DebugDrawResource.h"
 #include "ECS/Resources/SwapRendererResource.h"
+#include "ECS/Resources/TimeResource.h"
 #include "ECS/Resources/Networking/NetworkingResource.h"
 
 #include "Utils/FrameRate.h"
+#include "Jobs/JobSystem.h"
 #include "Graphics/Vulkan/Core/Device.h"
 
 #include "Utils/Utils.h"
@@ -44,21 +47,41 @@ namespace Radis
  
         mEditorEnabled = mSpecs.launchWithEditor;
         Logger::Init();
+        JobSystem::Initialize();
 
         RadisLaunch::EngineSpec launchArgs = LoadConfig(argc, argv, &mDevBuild);
         if (!mDevBuild) mSpecs = launchArgs;
 
         SetGraphicsAPI(mSpecs.graphicsAPI);
 
+        // Headless: no window, input, GPU or editor. Only simulation systems are added and the
+        // rendering resource keeps just the CPU side of the model/texture/animation libraries.
+        const bool headless = IsHeadless();
+        if (headless)
+        {
+            mEditorEnabled = false;
+            RADIS_INFO("Running headless (GraphicsAPI::None)");
+        }
+
         // Systems -------------------------
-        mEcs.AddSystem<WindowSystem>();
-        mEcs.AddSystem<InputSystem>();
+        if (!headless)
+        {
+            mEcs.AddSystem<WindowSystem>();
+            mEcs.AddSystem<InputSystem>();
+            mEcs.AddSystem<SwapRendererSystem>();
+        }
 
-        mEcs.AddSystem<SwapRendererSystem>();
+        mEcs.AddSystem<TransformSystem>();
         mEcs.AddSystem<AnimationSystem>();
-        mEcs.AddSystem<PresentSystem>();
+        if (!headless)
+        {
+            mEcs.AddSystem<PresentSystem>();
+        }
         mEcs.AddSystem<PhysicsSystem>();
-        mEcs.AddSystem<RenderSystem>();
+        if (!headless)
+        {
+            mEcs.AddSystem<RenderSystem>();
+        }
         if (mEditorEnabled)
         {
             mEcs.AddSystem<EditorSystem>();
@@ -68,41 +91,49 @@ namespace Radis
 
         // Resources -----------------------
         // mEcs.AddResource<NetworkingResource>(mSpecs.serverAddress, mSpecs.serverPort);
-        mEcs.AddResource<SwapRendererResource>();
-        mEcs.AddResource<WindowResource>(mSpecs.width, mSpecs.height, mSpecs.name);
-
-        auto wr = mEcs.GetResource<WindowResource>();
-        mEcs.AddResource<InputResource>(wr->window->GetGLFWwindow());
-        mEcs.AddResource<RenderingResource>(wr->window.get());
-        mEcs.AddResource<RaytracingResource>();
-
-        bool canVulkan = Engine::GetVulkanSupported();
-        bool isVulkan = (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan);
-        bool swapVulkan = !canVulkan && isVulkan;
+        if (headless)
         {
-            auto srr = mEcs.GetResource<SwapRendererResource>();
-            if (swapVulkan)
-            {
-                srr->SwapBackend(&mEcs, true);
-            }
+            mEcs.AddResource<RenderingResource>(nullptr);
         }
-
-        if (mEditorEnabled)
+        else
         {
-            if (mSpecs.graphicsAPI == GraphicsAPI::Vulkan && !swapVulkan)
+            mEcs.AddResource<SwapRendererResource>();
+            mEcs.AddResource<WindowResource>(mSpecs.width, mSpecs.height, mSpecs.name);
+
+            auto wr = mEcs.GetResource<WindowResource>();
+            mEcs.AddResource<InputResource>(wr->window->GetGLFWwindow());
+            mEcs.AddResource<RenderingResource>(wr->window.get());
+            mEcs.AddResource<RaytracingResource>();
+
+            bool canVulkan = Engine::GetVulkanSupported();
+            bool isVulkan = (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan);
+            bool swapVulkan = !canVulkan && isVulkan;
             {
-                auto rr = mEcs.GetResource<RenderingResource>();
-                mEcs.AddResource<EditorResource>(rr->device.get(), rr->swapChain.get(), wr->window->GetGLFWwindow(), wr->window->GetDPIScale());
+                auto srr = mEcs.GetResource<SwapRendererResource>();
+                if (swapVulkan)
+                {
+                    srr->SwapBackend(&mEcs, true);
+                }
             }
-            else /*if (mSpecs.graphicsAPI == GraphicsAPI::OpenGL)*/
+
+            if (mEditorEnabled)
             {
-                mEcs.AddResource<EditorResource>(wr->window->GetGLFWwindow(), wr->window->GetDPIScale());
+                if (mSpecs.graphicsAPI == GraphicsAPI::Vulkan && !swapVulkan)
+                {
+                    auto rr = mEcs.GetResource<RenderingResource>();
+                    mEcs.AddResource<EditorResource>(rr->device.get(), rr->swapChain.get(), wr->window->GetGLFWwindow(), wr->window->GetDPIScale());
+                }
+                else /*if (mSpecs.graphicsAPI == GraphicsAPI::OpenGL)*/
+                {
+                    mEcs.AddResource<EditorResource>(wr->window->GetGLFWwindow(), wr->window->GetDPIScale());
+                }
             }
         }
 
         mEcs.AddResource<SerializationResource>();
         mEcs.AddResource<AnimationResource>();
         mEcs.AddResource<DebugDrawResource>();
+        mEcs.AddResource<TimeResource>();
         // ---------------------------------
 
         // Initialize ECS
@@ -118,13 +149,53 @@ namespace Radis
     {
         mEcs.GetResource<SerializationResource>()->Deserialize(Assets::ScenesPath + sceneName + ".json");
 
+        // Simulation runs in fixed steps independent of the render rate. Long frames are clamped
+        // and capped at MAX_FIXED_STEPS so a hitch can't snowball into ever longer frames.
+        constexpr float MAX_FRAME_TIME = 0.25f;
+        constexpr uint32_t MAX_FIXED_STEPS = 8;
+        const float fixedDt = 1.0f / static_cast<float>(mSpecs.simRate > 0 ? mSpecs.simRate : 60);
+        float accumulator = 0.0f;
+
+        auto time = mEcs.GetResource<TimeResource>();
+        time->fixedDeltaTime = fixedDt;
+
+        // Headless frames don't wait on the clock; each one advances a fixed 1/fps so a run of
+        // frameCount frames simulates the same time however fast the machine is.
+        const bool headless = IsHeadless();
+        const float headlessDt = 1.0f / static_cast<float>(mSpecs.fps > 0 ? mSpecs.fps : 60);
+
+        // Set from launch.json ("frameCount"), e.g. for headless test runs
+        const uint32_t frameCount = mSpecs.frameCount;
+
         FrameRateController frameRateController(mSpecs.fps);
-        while (!mEcs.GetResource<WindowResource>()->window->ShouldClose() && mRunning) 
+        for (uint32_t frame = 0; mRunning && (frameCount == 0 || frame < frameCount); ++frame)
         {
-            float dt = frameRateController.WaitForNextFrame();
+            // Looked up every frame, a renderer swap replaces the window resource
+            if (!headless && mEcs.GetResource<WindowResource>()->window->ShouldClose()) break;
+
+            float dt = headless ? headlessDt : frameRateController.WaitForNextFrame();
             Profiler::BeginFrame();
 
+            time->deltaTime = dt;
+            accumulator += std::min(dt, MAX_FRAME_TIME);
+
             mEcs.FrameStart();
+
+            time->stepsThisFrame = 0;
+            while (accumulator >= fixedDt && time->stepsThisFrame < MAX_FIXED_STEPS)
+            {
+                mEcs.FixedUpdate(fixedDt);
+                accumulator -= fixedDt;
+                time->simulationTime += fixedDt;
+                ++time->fixedStepCount;
+                ++time->stepsThisFrame;
+            }
+            if (time->stepsThisFrame == MAX_FIXED_STEPS)
+            {
+                accumulator = std::fmod(accumulator, fixedDt); // drop the backlog, keep alpha below 1
+            }
+            time->alpha = accumulator / fixedDt;
+
             mEcs.Update(dt);
             mEcs.FrameEnd();
 
@@ -144,6 +215,7 @@ namespace Radis
         }
 
         mEcs.Exit();
+        JobSystem::Shutdown();
 
         return EXIT_SUCCESS;
     }
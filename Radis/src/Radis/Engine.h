@@ -18,7 +18,9 @@ namespace Radis
 		/*********************************************************************
 		 * param:  sceneName: The name of the scene to run. (read from assets/scenes)
 		 * 
-		 * brief: Run the engine with the specified scene.
+		 * brief: Run the engine with the specified scene. EngineSpec::frameCount
+		 *        bounds the run, 0 runs until closed. With GraphicsAPI::None
+		 *        frames are stepped back to back at 1/fps instead of waiting.
 		 *********************************************************************/
 		int Run(const std::string& sceneName);
 		int Exit();
@@ -31,6 +33,7 @@ namespace Radis
 		static void ForceVulkanUnsupportedSwap() { mVulkanSupported = false; }
         static bool GetVulkanSupported() { return mVulkanSupported; }
         static bool GetEditorEnabled() { return mEditorEnabled; }
+        static bool IsHeadless() { return mGraphicsAPI == GraphicsAPI::None; }
 
 	private:
 		// Engine Specs
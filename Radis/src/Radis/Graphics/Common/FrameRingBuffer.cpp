@@ -0,0 +1,62 @@
+#include <PCH/pch.h>
+#include "FrameRingBuffer.h"
+
+namespace Radis
+{
+    FrameRingBuffer::FrameRingBuffer(uint32_t frameCount, uint32_t alignment, uint32_t maxFrameCapacity)
+        : mSlots(frameCount)
+        , mAlignment(std::max(alignment, 16u))
+        , mMaxFrameCapacity(std::max(maxFrameCapacity, INITIAL_FRAME_CAPACITY))
+    {
+    }
+
+    void FrameRingBuffer::CreateSlots()
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(mSlots.size()); ++i)
+        {
+            mSlots[i].mapping = Reallocate(i, INITIAL_FRAME_CAPACITY, 0);
+            mSlots[i].capacity = INITIAL_FRAME_CAPACITY;
+        }
+    }
+
+    void FrameRingBuffer::BeginFrame(uint32_t frameIndex)
+    {
+        mFrameIndex = frameIndex;
+        mSlots[mFrameIndex].head = 0;
+    }
+
+    RingAllocation FrameRingBuffer::Allocate(uint32_t size)
+    {
+        Slot& slot = mSlots[mFrameIndex];
+
+        // mAlignment is a power of two (Vulkan guarantees it for the offset limits)
+        const uint64_t offset = (static_cast<uint64_t>(slot.head) + mAlignment - 1) & ~static_cast<uint64_t>(mAlignment - 1);
+        const uint64_t end = offset + size;
+
+        if (end > slot.capacity)
+        {
+            uint64_t capacity = slot.capacity;
+            while (capacity < end)
+            {
+                capacity *= 2;
+            }
+
+            if (capacity > mMaxFrameCapacity)
+            {
+                if (end > mMaxFrameCapacity)
+                {
+                    RADIS_ERROR("Frame ring buffer can't fit {} more bytes ({} of {} used)", size, slot.head, mMaxFrameCapacity);
+                    return {};
+                }
+                capacity = mMaxFrameCapacity;
+            }
+
+            RADIS_INFO("Growing frame ring buffer slot {} to {} bytes", mFrameIndex, capacity);
+            slot.mapping = Reallocate(mFrameIndex, static_cast<uint32_t>(capacity), slot.head);
+            slot.capacity = static_cast<uint32_t>(capacity);
+        }
+
+        slot.head = static_cast<uint32_t>(end);
+        return { slot.mapping + offset, static_cast<uint32_t>(offset), size };
+    }
+}
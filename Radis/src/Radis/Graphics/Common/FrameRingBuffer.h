@@ -0,0 +1,70 @@
+#pragma once
+
+namespace Radis
+{
+    // Where an allocation landed in the current frame's slot. data is only valid until the next
+    // Allocate (growing moves the slot), offset stays valid for the rest of the frame.
+    struct RingAllocation
+    {
+        uint8_t* data = nullptr;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    // Frame-scoped linear allocator for the data shaders read once per frame (instances, bones,
+    // lights). Every frame in flight owns a persistently mapped slot that is rewound in BeginFrame,
+    // systems write straight into it and the draws bind it by offset. A slot that runs out of room
+    // doubles, keeping what was already written this frame. The backends own the actual buffers.
+    class FrameRingBuffer
+    {
+    public:
+        static constexpr uint32_t INITIAL_FRAME_CAPACITY = 4u << 20;
+
+        virtual ~FrameRingBuffer() = default;
+
+        FrameRingBuffer(const FrameRingBuffer&) = delete;
+        FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+
+        // Rewinds frameIndex's slot, the GPU must be done with what it held
+        virtual void BeginFrame(uint32_t frameIndex);
+        // After the last draw reading this frame's slot was issued
+        virtual void EndFrame() {}
+
+        // Aligned for use as a storage buffer offset, data is nullptr if the slot can't grow that far
+        RingAllocation Allocate(uint32_t size);
+
+        template<typename T>
+        T* Allocate(uint32_t count, uint32_t& offset)
+        {
+            const RingAllocation allocation = Allocate(count * static_cast<uint32_t>(sizeof(T)));
+            offset = allocation.offset;
+            return reinterpret_cast<T*>(allocation.data);
+        }
+
+        uint32_t GetFrameIndex() const { return mFrameIndex; }
+        uint32_t GetFrameCapacity(uint32_t frameIndex) const { return mSlots[frameIndex].capacity; }
+        uint32_t GetFrameUsed() const { return mSlots[mFrameIndex].head; }
+
+    protected:
+        FrameRingBuffer(uint32_t frameCount, uint32_t alignment, uint32_t maxFrameCapacity);
+
+        // Replaces the slot's storage with newCapacity bytes that start with its first usedBytes and
+        // returns the new mapping. Creates the slot when its capacity is still 0.
+        virtual uint8_t* Reallocate(uint32_t frameIndex, uint32_t newCapacity, uint32_t usedBytes) = 0;
+
+        // Called by the backend constructors once Reallocate can run
+        void CreateSlots();
+
+        struct Slot
+        {
+            uint8_t* mapping = nullptr;
+            uint32_t capacity = 0;
+            uint32_t head = 0;
+        };
+
+        std::vector<Slot> mSlots;
+        uint32_t mFrameIndex = 0;
+        uint32_t mAlignment;
+        uint32_t mMaxFrameCapacity;
+    };
+}
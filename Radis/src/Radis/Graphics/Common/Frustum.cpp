@@ -0,0 +1,156 @@
+#include <PCH/pch.h>
+#include "Frustum.h"
+#include "Graphics/RHI/IMesh.h"
+
+namespace Radis
+{
+    Frustum Frustum::FromMatrix(const glm::mat4& projectionView)
+    {
+        // Gribb/Hartmann: planes are sums/differences of the matrix rows
+        const glm::mat4 m = glm::transpose(projectionView);
+
+        Frustum frustum;
+        frustum.planes[0] = m[3] + m[0]; // left
+        frustum.planes[1] = m[3] - m[0]; // right
+        frustum.planes[2] = m[3] + m[1]; // bottom
+        frustum.planes[3] = m[3] - m[1]; // top
+        frustum.planes[4] = m[2];        // near (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+        frustum.planes[5] = m[3] - m[2]; // far
+
+        for (glm::vec4& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool Frustum::ContainsSphere(const glm::vec3& center, float radius) const
+    {
+        for (const glm::vec4& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CullBatch::Resize(size_t count)
+    {
+        centerX.resize(count); centerY.resize(count); centerZ.resize(count);
+        radius.resize(count);
+        extentX.resize(count); extentY.resize(count); extentZ.resize(count);
+        visible.resize(count);
+    }
+
+    void CullBatch::Set(size_t index, const glm::mat4& model, const glm::vec3& localCenter, const glm::vec3& localExtent, float localRadius)
+    {
+        const glm::vec3 center = glm::vec3(model * glm::vec4(localCenter, 1.f));
+
+        // Box extents of the rotated box, |M| * e
+        const glm::vec3 axisX = glm::vec3(model[0]);
+        const glm::vec3 axisY = glm::vec3(model[1]);
+        const glm::vec3 axisZ = glm::vec3(model[2]);
+        const glm::vec3 extent = glm::abs(axisX) * localExtent.x + glm::abs(axisY) * localExtent.y + glm::abs(axisZ) * localExtent.z;
+
+        const float maxScale = std::sqrt(std::max({ glm::dot(axisX, axisX), glm::dot(axisY, axisY), glm::dot(axisZ, axisZ) }));
+
+        centerX[index] = center.x;
+        centerY[index] = center.y;
+        centerZ[index] = center.z;
+        radius[index] = localRadius * maxScale;
+        extentX[index] = extent.x;
+        extentY[index] = extent.y;
+        extentZ[index] = extent.z;
+    }
+
+    void CullBatch::SetAlwaysVisible(size_t index)
+    {
+        // Finite so 0 * extent stays 0 instead of NaN
+        constexpr float huge = std::numeric_limits<float>::max();
+        centerX[index] = centerY[index] = centerZ[index] = 0.f;
+        radius[index] = huge;
+        extentX[index] = extentY[index] = extentZ[index] = huge;
+    }
+
+    void CullAgainstFrustum(const Frustum& frustum, CullBatch& batch, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            batch.visible[i] = 1;
+        }
+
+        // One plane at a time over the whole range, branch free so each pass vectorizes
+        for (const glm::vec4& plane : frustum.planes)
+        {
+            const float nx = plane.x, ny = plane.y, nz = plane.z, d = plane.w;
+            const float ax = std::abs(nx), ay = std::abs(ny), az = std::abs(nz);
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float distance = nx * batch.centerX[i] + ny * batch.centerY[i] + nz * batch.centerZ[i] + d;
+                const float boxRadius = ax * batch.extentX[i] + ay * batch.extentY[i] + az * batch.extentZ[i];
+                const float reach = std::min(boxRadius, batch.radius[i]);
+                batch.visible[i] &= static_cast<uint8_t>(distance + reach >= 0.f);
+            }
+        }
+    }
+
+    uint32_t CullMeshlets(const Frustum& frustum, const glm::vec3& cameraPosition, bool cullBackfaces,
+        const glm::mat4& model, const std::vector<Meshlet>& meshlets, std::vector<ClusterRun>& outRuns)
+    {
+        const glm::vec3 axisX = glm::vec3(model[0]);
+        const glm::vec3 axisY = glm::vec3(model[1]);
+        const glm::vec3 axisZ = glm::vec3(model[2]);
+        const float scaleX = glm::length(axisX);
+        const float scaleY = glm::length(axisY);
+        const float scaleZ = glm::length(axisZ);
+        const float maxScale = std::max({ scaleX, scaleY, scaleZ });
+        const float minScale = std::min({ scaleX, scaleY, scaleZ });
+
+        // Rotation and uniform scale keep the cone angle. A mirroring transform flips the winding the
+        // rasterizer sees, so the facing flips with it.
+        const bool testCones = cullBackfaces && minScale > 0.f && maxScale - minScale <= maxScale * 0.01f;
+        const glm::mat3 normalMatrix = glm::mat3(model) * (glm::determinant(glm::mat3(model)) < 0.f ? -1.f : 1.f);
+
+        uint32_t culledCount = 0;
+        for (const Meshlet& meshlet : meshlets)
+        {
+            const glm::vec3 center = glm::vec3(model * glm::vec4(meshlet.center, 1.f));
+            const float radius = meshlet.radius * maxScale;
+
+            bool visible = true;
+            for (const glm::vec4& plane : frustum.planes)
+            {
+                visible &= glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+            }
+
+            // A cutoff of 1 or more means the normals spread too far for any view to see only backs
+            if (visible && testCones && meshlet.coneCutoff < 1.f)
+            {
+                const glm::vec3 apex = glm::vec3(model * glm::vec4(meshlet.coneApex, 1.f));
+                const glm::vec3 axis = glm::normalize(normalMatrix * meshlet.coneAxis);
+                const glm::vec3 view = apex - cameraPosition;
+                const float viewLength = glm::length(view);
+                visible = viewLength <= 0.f || glm::dot(view, axis) < meshlet.coneCutoff * viewLength;
+            }
+
+            if (!visible)
+            {
+                ++culledCount;
+                continue;
+            }
+
+            if (!outRuns.empty() && outRuns.back().firstIndex + outRuns.back().indexCount == meshlet.firstIndex)
+            {
+                outRuns.back().indexCount += meshlet.indexCount;
+            }
+            else
+            {
+                outRuns.push_back({ meshlet.firstIndex, meshlet.indexCount });
+            }
+        }
+        return culledCount;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+namespace Radis
+{
+    struct Meshlet;
+
+    // View frustum as six inward-facing, normalized planes (xyz = normal, w = distance).
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> planes{};
+
+        // Extracts the planes from a projection * view matrix (0..1 clip depth).
+        static Frustum FromMatrix(const glm::mat4& projectionView);
+
+        // Whether the sphere lies entirely inside, nothing within it can be frustum culled
+        bool ContainsSphere(const glm::vec3& center, float radius) const;
+    };
+
+    // World-space bounding volumes laid out as flat arrays so the plane tests vectorize.
+    // Each entry is a sphere and an AABB sharing the same center; the tighter of the two
+    // is used per plane.
+    struct CullBatch
+    {
+        std::vector<float> centerX, centerY, centerZ;
+        std::vector<float> radius;
+        std::vector<float> extentX, extentY, extentZ;
+        std::vector<uint8_t> visible;
+
+        void Resize(size_t count);
+        size_t Size() const { return visible.size(); }
+
+        // Transforms local bounds (box center/half-size and sphere radius) by model and stores them at index.
+        void Set(size_t index, const glm::mat4& model, const glm::vec3& localCenter, const glm::vec3& localExtent, float localRadius);
+        // Always passes the test, for volumes that can't be bounded up front (skinned meshes).
+        void SetAlwaysVisible(size_t index);
+    };
+
+    // Writes visible[i] for entries [begin, end).
+    void CullAgainstFrustum(const Frustum& frustum, CullBatch& batch, size_t begin, size_t end);
+
+    // Consecutive surviving meshlets merged into one index range, relative to the mesh's LOD 0
+    struct ClusterRun
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    // CPU reference cluster culling for one instance of a mesh. Drops the meshlets whose bounding
+    // sphere is outside the frustum and, with cullBackfaces, those whose normal cone faces away
+    // from the camera, then appends the survivors to outRuns. Backface rejection is only correct
+    // for geometry the rasterizer would cull anyway, and is skipped under non-uniform scale where
+    // the cone doesn't survive the transform. Returns how many meshlets were culled.
+    uint32_t CullMeshlets(const Frustum& frustum, const glm::vec3& cameraPosition, bool cullBackfaces,
+        const glm::mat4& model, const std::vector<Meshlet>& meshlets, std::vector<ClusterRun>& outRuns);
+}
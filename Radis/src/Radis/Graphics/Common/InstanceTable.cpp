@@ -0,0 +1,123 @@
+#include <PCH/pch.h>
+#include "InstanceTable.h"
+#include "FrameRingBuffer.h"
+
+namespace Radis
+{
+    void InstanceTable::CreateStorage()
+    {
+        Reallocate(INITIAL_CAPACITY);
+        mAllocator.Grow(INITIAL_CAPACITY);
+        mData.resize(INITIAL_CAPACITY);
+        mDirty.resize(INITIAL_CAPACITY, 0);
+    }
+
+    uint32_t InstanceTable::Allocate(uint32_t count)
+    {
+        uint32_t firstSlot = mAllocator.Allocate(count);
+        if (firstSlot == INVALID_SLOT && count > 0)
+        {
+            uint32_t capacity = std::max(GetCapacity(), 1u);
+            while (capacity - mAllocator.GetEnd() < count)
+            {
+                capacity *= 2;
+            }
+
+            RADIS_INFO("Growing instance table to {} slots", capacity);
+            const bool kept = Reallocate(capacity);
+            mAllocator.Grow(capacity);
+            mData.resize(capacity);
+            mDirty.resize(capacity, 0);
+
+            if (!kept)
+            {
+                for (uint32_t slot = 0; slot < mAllocator.GetEnd(); ++slot)
+                {
+                    MarkDirty(slot);
+                }
+            }
+
+            firstSlot = mAllocator.Allocate(count);
+        }
+
+        if (firstSlot != INVALID_SLOT)
+        {
+            for (uint32_t slot = firstSlot; slot < firstSlot + count; ++slot)
+            {
+                MarkDirty(slot);
+            }
+        }
+        return firstSlot;
+    }
+
+    void InstanceTable::Free(uint32_t firstSlot, uint32_t count)
+    {
+        mAllocator.Free(firstSlot, count);
+    }
+
+    void InstanceTable::Clear()
+    {
+        mAllocator = RangeAllocator(GetCapacity());
+        std::fill(mDirty.begin(), mDirty.end(), 0);
+        mDirtySlots.clear();
+    }
+
+    void InstanceTable::Write(uint32_t slot, const InstanceUniforms& data)
+    {
+        if (memcmp(&mData[slot], &data, sizeof(InstanceUniforms)) == 0)
+        {
+            return;
+        }
+
+        mData[slot] = data;
+        MarkDirty(slot);
+    }
+
+    void InstanceTable::MarkDirty(uint32_t slot)
+    {
+        if (mDirty[slot]) return;
+        mDirty[slot] = 1;
+        mDirtySlots.push_back(slot);
+    }
+
+    void InstanceTable::Flush(FrameRingBuffer& ring)
+    {
+        mRuns.clear();
+        mLastUploadCount = 0;
+
+        if (!mDirtySlots.empty())
+        {
+            uint32_t ringOffset = 0;
+            InstanceUniforms* staged = ring.Allocate<InstanceUniforms>(static_cast<uint32_t>(mDirtySlots.size()), ringOffset);
+            if (!staged)
+            {
+                // Stays dirty, retried next frame
+                Upload(ring, mRuns);
+                return;
+            }
+
+            // Sorted so neighbouring slots become one copy
+            std::sort(mDirtySlots.begin(), mDirtySlots.end());
+            for (uint32_t i = 0; i < static_cast<uint32_t>(mDirtySlots.size()); ++i)
+            {
+                const uint32_t slot = mDirtySlots[i];
+                staged[i] = mData[slot];
+                mDirty[slot] = 0;
+
+                if (!mRuns.empty() && mRuns.back().firstSlot + mRuns.back().count == slot)
+                {
+                    ++mRuns.back().count;
+                }
+                else
+                {
+                    mRuns.push_back({ ringOffset + i * static_cast<uint32_t>(sizeof(InstanceUniforms)), slot, 1 });
+                }
+            }
+
+            mLastUploadCount = static_cast<uint32_t>(mDirtySlots.size());
+            mDirtySlots.clear();
+        }
+
+        Upload(ring, mRuns);
+    }
+}
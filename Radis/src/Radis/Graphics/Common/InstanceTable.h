@@ -0,0 +1,73 @@
+#pragma once
+
+#include "RangeAllocator.h"
+#include "Graphics/Vulkan/Uniform/ShaderTypes.h"
+
+namespace Radis
+{
+    class FrameRingBuffer;
+
+    // Persistent GPU table of InstanceUniforms. Instances keep their slots across frames and only
+    // rewrite them when something they were built from changes; Flush then uploads just the
+    // dirty slots through the frame ring, so a static scene uploads nothing. Draws reach the
+    // table through a per-frame list of slot indices. The backends own the actual buffer.
+    class InstanceTable
+    {
+    public:
+        static constexpr uint32_t INVALID_SLOT = RangeAllocator::INVALID_OFFSET;
+        static constexpr uint32_t INITIAL_CAPACITY = 4096;
+
+        virtual ~InstanceTable() = default;
+
+        InstanceTable(const InstanceTable&) = delete;
+        InstanceTable& operator=(const InstanceTable&) = delete;
+
+        // count contiguous slots, growing the table when it is full. New slots are always uploaded
+        // on their first Flush.
+        uint32_t Allocate(uint32_t count);
+        void Free(uint32_t firstSlot, uint32_t count);
+        // Frees every slot
+        void Clear();
+
+        // Marks slot for upload if data differs from what it holds
+        void Write(uint32_t slot, const InstanceUniforms& data);
+
+        // Copies this frame's dirty slots into the ring and queues their upload. Once per frame,
+        // after the last Write.
+        void Flush(FrameRingBuffer& ring);
+
+        uint32_t GetCapacity() const { return mAllocator.GetCapacity(); }
+        uint32_t GetUsed() const { return mAllocator.GetUsed(); }
+        uint32_t GetLastUploadCount() const { return mLastUploadCount; }
+
+    protected:
+        InstanceTable() = default;
+
+        // A run of consecutive slots staged contiguously in the current frame's ring slot
+        struct UploadRun
+        {
+            uint32_t ringOffset;
+            uint32_t firstSlot;
+            uint32_t count;
+        };
+
+        // Replaces the GPU storage with newCapacity slots. Returns whether the old contents were
+        // kept, every allocated slot gets uploaded again when they weren't.
+        virtual bool Reallocate(uint32_t newCapacity) = 0;
+        // Queues or issues this frame's copies from the ring, runs is empty when nothing changed
+        virtual void Upload(FrameRingBuffer& ring, const std::vector<UploadRun>& runs) = 0;
+
+        // Called by the backend constructors once Reallocate can run
+        void CreateStorage();
+
+    private:
+        void MarkDirty(uint32_t slot);
+
+        RangeAllocator mAllocator;
+        std::vector<InstanceUniforms> mData; // what the GPU holds once the dirty slots are uploaded
+        std::vector<uint8_t> mDirty;
+        std::vector<uint32_t> mDirtySlots;
+        std::vector<UploadRun> mRuns;
+        uint32_t mLastUploadCount = 0;
+    };
+}
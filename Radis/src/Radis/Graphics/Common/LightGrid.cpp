@@ -0,0 +1,193 @@
+#include <PCH/pch.h>
+#include "LightGrid.h"
+
+namespace Radis
+{
+    void LightGrid::UpdateClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane)
+    {
+        if (projection == mBoundsProjection && nearPlane == mBoundsNear && farPlane == mBoundsFar && !mMinX.empty())
+        {
+            return;
+        }
+        mBoundsProjection = projection;
+        mBoundsNear = nearPlane;
+        mBoundsFar = farPlane;
+
+        mMinX.resize(CLUSTER_COUNT); mMinY.resize(CLUSTER_COUNT); mMinZ.resize(CLUSTER_COUNT);
+        mMaxX.resize(CLUSTER_COUNT); mMaxY.resize(CLUSTER_COUNT); mMaxZ.resize(CLUSTER_COUNT);
+
+        // A view-space point at depth d lands on ndc.xy = xy * scale / d, scale is signed (Vulkan flips y)
+        const float scaleX = projection[0][0];
+        const float scaleY = projection[1][1];
+        const float depthRatio = farPlane / nearPlane;
+
+        for (uint32_t slice = 0; slice < DEPTH_SLICES; ++slice)
+        {
+            const float sliceNear = nearPlane * std::pow(depthRatio, static_cast<float>(slice) / DEPTH_SLICES);
+            const float sliceFar = nearPlane * std::pow(depthRatio, static_cast<float>(slice + 1) / DEPTH_SLICES);
+
+            for (uint32_t tileY = 0; tileY < TILES_Y; ++tileY)
+            {
+                const float ndcY0 = -1.f + 2.f * tileY / TILES_Y;
+                const float ndcY1 = -1.f + 2.f * (tileY + 1) / TILES_Y;
+                const std::array<float, 4> y = { ndcY0 * sliceNear / scaleY, ndcY0 * sliceFar / scaleY, ndcY1 * sliceNear / scaleY, ndcY1 * sliceFar / scaleY };
+
+                for (uint32_t tileX = 0; tileX < TILES_X; ++tileX)
+                {
+                    const float ndcX0 = -1.f + 2.f * tileX / TILES_X;
+                    const float ndcX1 = -1.f + 2.f * (tileX + 1) / TILES_X;
+                    const std::array<float, 4> x = { ndcX0 * sliceNear / scaleX, ndcX0 * sliceFar / scaleX, ndcX1 * sliceNear / scaleX, ndcX1 * sliceFar / scaleX };
+
+                    const uint32_t cluster = (slice * TILES_Y + tileY) * TILES_X + tileX;
+                    mMinX[cluster] = *std::min_element(x.begin(), x.end());
+                    mMaxX[cluster] = *std::max_element(x.begin(), x.end());
+                    mMinY[cluster] = *std::min_element(y.begin(), y.end());
+                    mMaxY[cluster] = *std::max_element(y.begin(), y.end());
+                    mMinZ[cluster] = -sliceFar; // view space looks down -z
+                    mMaxZ[cluster] = -sliceNear;
+                }
+            }
+        }
+    }
+
+    void LightGrid::Build(const LightUniform* lights, uint32_t lightCount, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane)
+    {
+        UpdateClusterBounds(projection, nearPlane, farPlane);
+
+        const float scaleX = projection[0][0];
+        const float scaleY = projection[1][1];
+        const float logRatio = std::log(farPlane / nearPlane);
+        const float sliceScale = DEPTH_SLICES / logRatio;
+        const float sliceBias = -DEPTH_SLICES * std::log(nearPlane) / logRatio;
+
+        auto SliceOf = [&](float depth)
+        {
+            const float slice = std::floor(std::log(depth) * sliceScale + sliceBias);
+            return static_cast<uint32_t>(std::clamp(slice, 0.f, static_cast<float>(DEPTH_SLICES - 1)));
+        };
+        auto TileOf = [](float ndc, uint32_t tileCount)
+        {
+            const float tile = std::floor((ndc * 0.5f + 0.5f) * tileCount);
+            return static_cast<uint32_t>(std::clamp(tile, 0.f, static_cast<float>(tileCount - 1)));
+        };
+
+        mCounts.assign(CLUSTER_COUNT, 0);
+        mReferences.clear();
+        mDirectional.clear();
+
+        for (uint32_t lightIndex = 0; lightIndex < lightCount; ++lightIndex)
+        {
+            const LightUniform& light = lights[lightIndex];
+            if (light.type == 0)
+            {
+                mDirectional.push_back(lightIndex);
+                continue;
+            }
+
+            glm::vec3 center = light.position;
+            float radius = light.radius;
+            if (light.type == 2 && light.outerCone > 0.f)
+            {
+                // Tightest sphere around the lit cone, narrow cones are much smaller than their range
+                const float cosAngle = std::min(light.outerCone, 1.f);
+                const float sinAngle = std::sqrt(1.f - cosAngle * cosAngle);
+                if (cosAngle >= glm::one_over_root_two<float>())
+                {
+                    radius = light.radius / (2.f * cosAngle);
+                    center = light.position + light.direction * radius;
+                }
+                else
+                {
+                    center = light.position + light.direction * (light.radius * cosAngle);
+                    radius = light.radius * sinAngle;
+                }
+            }
+
+            const glm::vec3 viewCenter = glm::vec3(view * glm::vec4(center, 1.f));
+            const float depth = -viewCenter.z;
+            if (radius <= 0.f || depth + radius < nearPlane || depth - radius > farPlane)
+            {
+                continue;
+            }
+
+            const float depthNear = std::max(depth - radius, nearPlane);
+            const float depthFar = std::min(depth + radius, farPlane);
+
+            // Screen rectangle of the sphere's view-space box, its corners bound its projection
+            float ndcMinX = FLT_MAX, ndcMaxX = -FLT_MAX, ndcMinY = FLT_MAX, ndcMaxY = -FLT_MAX;
+            for (const float cornerDepth : { depthNear, depthFar })
+            {
+                for (const float offset : { -radius, radius })
+                {
+                    const float ndcX = (viewCenter.x + offset) * scaleX / cornerDepth;
+                    const float ndcY = (viewCenter.y + offset) * scaleY / cornerDepth;
+                    ndcMinX = std::min(ndcMinX, ndcX); ndcMaxX = std::max(ndcMaxX, ndcX);
+                    ndcMinY = std::min(ndcMinY, ndcY); ndcMaxY = std::max(ndcMaxY, ndcY);
+                }
+            }
+            if (ndcMaxX < -1.f || ndcMinX > 1.f || ndcMaxY < -1.f || ndcMinY > 1.f)
+            {
+                continue;
+            }
+
+            const uint32_t tileX0 = TileOf(ndcMinX, TILES_X), tileX1 = TileOf(ndcMaxX, TILES_X);
+            const uint32_t tileY0 = TileOf(ndcMinY, TILES_Y), tileY1 = TileOf(ndcMaxY, TILES_Y);
+            const uint32_t slice0 = SliceOf(depthNear), slice1 = SliceOf(depthFar);
+            const float radiusSquared = radius * radius;
+
+            for (uint32_t slice = slice0; slice <= slice1; ++slice)
+            {
+                for (uint32_t tileY = tileY0; tileY <= tileY1; ++tileY)
+                {
+                    // Sphere against each box of the row, branch free so it vectorizes
+                    const uint32_t rowStart = (slice * TILES_Y + tileY) * TILES_X;
+                    for (uint32_t tileX = tileX0; tileX <= tileX1; ++tileX)
+                    {
+                        const uint32_t cluster = rowStart + tileX;
+                        const float dx = std::max({ mMinX[cluster] - viewCenter.x, 0.f, viewCenter.x - mMaxX[cluster] });
+                        const float dy = std::max({ mMinY[cluster] - viewCenter.y, 0.f, viewCenter.y - mMaxY[cluster] });
+                        const float dz = std::max({ mMinZ[cluster] - viewCenter.z, 0.f, viewCenter.z - mMaxZ[cluster] });
+                        mRowHits[tileX] = static_cast<uint8_t>(dx * dx + dy * dy + dz * dz <= radiusSquared);
+                    }
+
+                    for (uint32_t tileX = tileX0; tileX <= tileX1; ++tileX)
+                    {
+                        if (!mRowHits[tileX]) continue;
+                        ++mCounts[rowStart + tileX];
+                        mReferences.push_back({ rowStart + tileX, lightIndex });
+                    }
+                }
+            }
+        }
+
+        // Cluster table, directional lights, then each cluster's list at the offset its table entry points to
+        const uint32_t directionalStart = CLUSTER_COUNT * 2;
+        const uint32_t listStart = directionalStart + static_cast<uint32_t>(mDirectional.size());
+        mIndexCount = static_cast<uint32_t>(mReferences.size());
+        mCells.resize(listStart + mIndexCount);
+
+        uint32_t offset = listStart;
+        for (uint32_t cluster = 0; cluster < CLUSTER_COUNT; ++cluster)
+        {
+            mCells[cluster * 2 + 0] = offset;
+            mCells[cluster * 2 + 1] = 0;
+            offset += mCounts[cluster];
+        }
+        std::copy(mDirectional.begin(), mDirectional.end(), mCells.begin() + directionalStart);
+        for (const glm::uvec2& reference : mReferences)
+        {
+            uint32_t& count = mCells[reference.x * 2 + 1];
+            mCells[mCells[reference.x * 2] + count] = reference.y;
+            ++count;
+        }
+
+        mHeader.gridSize = glm::uvec4(TILES_X, TILES_Y, DEPTH_SLICES, static_cast<uint32_t>(mDirectional.size()));
+        mHeader.depthParams = glm::vec4(sliceScale, sliceBias, nearPlane, farPlane);
+    }
+
+    void LightGrid::Write(uint8_t* destination) const
+    {
+        memcpy(destination, &mHeader, sizeof(LightGridHeader));
+        memcpy(destination + sizeof(LightGridHeader), mCells.data(), mCells.size() * sizeof(uint32_t));
+    }
+}
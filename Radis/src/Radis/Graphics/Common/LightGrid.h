@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Graphics/Vulkan/Uniform/ShaderTypes.h"
+
+namespace Radis
+{
+    // Clustered light culling. The view frustum is cut into TILES_X * TILES_Y screen tiles and
+    // DEPTH_SLICES exponentially spaced depth slices, and every cluster lists the point and spot
+    // lights whose bounds reach it. Shaders find their cluster from the world position and shade
+    // only that list, directional lights are listed once for all of them. Rebuilt on the CPU each
+    // frame, the caller copies it into the frame ring (see LightGridHeader for the layout).
+    class LightGrid
+    {
+    public:
+        static constexpr uint32_t TILES_X = 16;
+        static constexpr uint32_t TILES_Y = 9;
+        static constexpr uint32_t DEPTH_SLICES = 24;
+        static constexpr uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * DEPTH_SLICES;
+
+        // projection is a symmetric perspective projection, nearPlane/farPlane the ones it was built with
+        void Build(const LightUniform* lights, uint32_t lightCount, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane);
+
+        // The header followed by the cells, as the shaders' LightGrid buffer reads it
+        uint32_t GetByteSize() const { return static_cast<uint32_t>(sizeof(LightGridHeader) + mCells.size() * sizeof(uint32_t)); }
+        void Write(uint8_t* destination) const;
+
+        // Light references summed over the clusters, directional lights not included
+        uint32_t GetIndexCount() const { return mIndexCount; }
+
+    private:
+        // View-space cluster boxes only depend on the projection, rebuilt when it changes
+        void UpdateClusterBounds(const glm::mat4& projection, float nearPlane, float farPlane);
+
+        // Cluster boxes as flat arrays so the per-row sphere tests vectorize
+        std::vector<float> mMinX, mMinY, mMinZ;
+        std::vector<float> mMaxX, mMaxY, mMaxZ;
+        glm::mat4 mBoundsProjection{ 0.f };
+        float mBoundsNear = 0.f;
+        float mBoundsFar = 0.f;
+
+        LightGridHeader mHeader{};
+        std::vector<uint32_t> mCells;        // (first, count) per cluster, the directional lights, then the cluster lists
+        std::vector<uint32_t> mCounts;       // per cluster
+        std::vector<glm::uvec2> mReferences; // (cluster, light) pairs found by the tests, bucketed into mCells
+        std::vector<uint32_t> mDirectional;
+        std::array<uint8_t, TILES_X> mRowHits{};
+        uint32_t mIndexCount = 0;
+    };
+}
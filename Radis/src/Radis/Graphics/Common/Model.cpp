@@ -10,10 +10,11 @@
 #include "Engine.h"
 
 #include "Assets/Serialization/ModelSerializer.h"
+#include "Jobs/JobSystem.h"
 
 namespace Radis
 {
-    Model::Model(Device& device, const std::string& filePath, bool fromDM, bool toDM)
+    Model::Model(Device& device, const std::string& filePath, bool fromDM, bool toDM, const MeshLODSettings& lodSettings)
     {
         std::filesystem::path pathObj(filePath);
         mDirectory = pathObj.parent_path().string();
@@ -30,6 +31,12 @@ namespace Radis
         }
         
         NormalizeModel();
+
+        // Imports and older .dm files, cooked before saving so .dm loads skip it
+        if (!mCooked)
+        {
+            CookMeshes(lodSettings);
+        }
         
         if (toDM)
         {
@@ -42,6 +49,55 @@ namespace Radis
     {
     }
 
+    void Model::CookMeshes(const MeshLODSettings& lodSettings)
+    {
+        std::vector<MeshStatistics> before(mMeshes.size());
+        std::vector<MeshStatistics> after(mMeshes.size());
+
+        JobSystem::ParallelFor(mMeshes.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                IMesh& mesh = *mMeshes[i];
+                before[i] = mesh.Analyze();
+                mesh.Optimize();
+                mesh.BuildMeshlets();
+                mesh.ComputeBounds(); // unreferenced vertices are gone
+                after[i] = mesh.Analyze();
+                mesh.GenerateLODs(lodSettings);
+            }
+        });
+        mCooked = true;
+
+        // Whole model figures, each mesh weighted by its index count
+        auto Average = [&](const std::vector<MeshStatistics>& stats)
+        {
+            MeshStatistics total;
+            size_t indexCount = 0;
+            for (size_t i = 0; i < stats.size(); ++i)
+            {
+                const float weight = static_cast<float>(mMeshes[i]->mIndices.size());
+                total.acmr += stats[i].acmr * weight;
+                total.atvr += stats[i].atvr * weight;
+                total.overdraw += stats[i].overdraw * weight;
+                total.overfetch += stats[i].overfetch * weight;
+                indexCount += mMeshes[i]->mIndices.size();
+            }
+
+            const float inverse = indexCount > 0 ? 1.f / static_cast<float>(indexCount) : 0.f;
+            total.acmr *= inverse;
+            total.atvr *= inverse;
+            total.overdraw *= inverse;
+            total.overfetch *= inverse;
+            return total;
+        };
+
+        const MeshStatistics oldStats = Average(before);
+        const MeshStatistics newStats = Average(after);
+        RADIS_INFO("Optimized {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overdraw {:.3f} -> {:.3f}, overfetch {:.3f} -> {:.3f}",
+            mModelName, oldStats.acmr, newStats.acmr, oldStats.atvr, newStats.atvr, oldStats.overdraw, newStats.overdraw, oldStats.overfetch, newStats.overfetch);
+    }
+
     void Model::LoadMeshes(const std::string& filepath)
     {
         mScene = importer.ReadFile(filepath, aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_GlobalScale | aiProcess_OptimizeGraph);
@@ -77,18 +133,7 @@ namespace Radis
 
     IMesh& Model::ProcessMesh(aiMesh* mesh, const glm::mat4& transform)
     {
-        std::unique_ptr<IMesh>* newMeshPtrRaw = nullptr;
-
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-        {
-            newMeshPtrRaw = &mMeshes.emplace_back(std::make_unique<VKMesh>());
-        }
-        else
-        {
-            newMeshPtrRaw = &mMeshes.emplace_back(std::make_unique<GLMesh>());
-        }
-
-        IMesh& newMesh = **newMeshPtrRaw;
+        IMesh& newMesh = *mMeshes.emplace_back(IMesh::Create());
 
         glm::vec3 meshMin(std::numeric_limits<float>::max());
         glm::vec3 meshMax(std::numeric_limits<float>::lowest());
@@ -136,6 +181,7 @@ namespace Radis
 
         ProcessMaterials(mesh, newMesh);
         ExtractBoneWeights(newMesh.mVertices, mesh);
+        newMesh.ComputeBounds();
 
         return newMesh;
     }
@@ -16,7 +16,7 @@ namespace Radis
         Model(const Model&) = delete;
         Model& operator=(const Model&) = delete;
 
-        Model(Device& device, const std::string& filePath, bool fromDM = false, bool toDM = false);
+        Model(Device& device, const std::string& filePath, bool fromDM = false, bool toDM = false, const MeshLODSettings& lodSettings = {});
         ~Model();
 
         std::vector<std::unique_ptr<IMesh>> mMeshes;
@@ -49,11 +49,14 @@ namespace Radis
         void ProcessEmissive(aiMaterial* material, IMesh& newMesh);
 
         void NormalizeModel();
+        // Vertex cache, overdraw and fetch optimization then LOD generation, logs the before/after statistics
+        void CookMeshes(const MeshLODSettings& lodSettings);
         void ExtractBoneWeights(std::vector<Vertex>& vertices, aiMesh* mesh);
 
         friend class ModelSerializer;
         glm::vec3 mAABBmin;
         glm::vec3 mAABBmax;
+        bool mCooked = false; // meshes already went through CookMeshes, set by .dm loads
 
         friend class ModelLibrary;
         bool mAddedTexture = false;
@@ -42,7 +42,7 @@ namespace Radis
             return it->second;
         }
 
-        std::unique_ptr<Model> model = std::make_unique<Model>(mDevice, filePath, fromDM, toDM);
+        std::unique_ptr<Model> model = std::make_unique<Model>(mDevice, filePath, fromDM, toDM, mLODSettings);
         for (auto& mesh : model->mMeshes)
         {
             mesh->CreateVertexBuffers(&mDevice);
@@ -76,10 +76,13 @@ namespace Radis
         Model* model = mModels[modelIndex].get();
         if (!model) return;
 
+        std::vector<IMesh*> meshes;
+        meshes.reserve(model->mMeshes.size());
         for (auto& mesh : model->mMeshes)
         {
-            mUnifiedMesh->AddMesh(mDevice, *mesh);
+            meshes.push_back(mesh.get());
         }
+        mUnifiedMesh->AddMeshes(&mDevice, meshes);
     }
 
     Model* ModelLibrary::GetModel(uint32_t index)
@@ -131,6 +134,7 @@ namespace Radis
         {
             if (model->mAddedTexture) continue;
             model->mAddedTexture = true;
+            ++mGeneration;
 
             auto LoadOrGetTexture = [&](uint32_t& currentIndex, const std::string& path, std::vector<unsigned char>& data, const std::string& embeddedName)
             {
@@ -182,6 +186,8 @@ namespace Radis
             {
                 std::vector<Vertex> oldVertices = mesh->mVertices;
                 std::vector<uint32_t> oldIndices = mesh->mIndices;
+                std::vector<MeshLOD> oldLODs = std::move(mesh->mLODs);
+                std::vector<Meshlet> oldMeshlets = std::move(mesh->mMeshlets);
                 uint32_t oldMeshID = mesh->GetID();
                 uint32_t oldDiffuseTextureIndex = mesh->albedoTextureIndex;
                 uint32_t oldNormalTextureIndex = mesh->normalTextureIndex;
@@ -195,19 +201,14 @@ namespace Radis
                 glm::vec4 oldEmissiveFactor = mesh->emissiveFactor;
 
                 mesh.reset();
-
-                if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL)
-                {
-                    mesh = std::make_unique<GLMesh>(false);
-                }
-                else if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-                {
-                    mesh = std::make_unique<VKMesh>(false);
-                }
+                mesh = IMesh::Create(false);
 
                 mesh->mMeshID = oldMeshID;
                 mesh->mVertices = oldVertices;
                 mesh->mIndices = oldIndices;
+                mesh->mLODs = std::move(oldLODs);
+                mesh->mMeshlets = std::move(oldMeshlets);
+                mesh->ComputeBounds();
                 mesh->albedoTextureIndex = oldDiffuseTextureIndex;
                 mesh->normalTextureIndex = oldNormalTextureIndex;
                 mesh->metalnessTextureIndex = oldMetalnessTextureIndex;
@@ -225,23 +226,24 @@ namespace Radis
         }
 
         {
-            std::vector<Vertex> oldVertices = mUnifiedMesh->GetUnifiedMesh()->mVertices;
-            std::vector<uint32_t> oldIndices = mUnifiedMesh->GetUnifiedMesh()->mIndices;
-
-            mUnifiedMesh->GetUnifiedMesh().reset();
-            if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL)
+            // Rebuild the arena from the per-mesh copies, the unified CPU mirror may have been dropped
+            const bool keepCPUCopies = mUnifiedMesh->GetKeepCPUCopies();
+            const bool cpuCopiesRequired = mUnifiedMesh->GetCPUCopiesRequired();
+            mUnifiedMesh = std::make_unique<UnifiedMeshes>();
+            mUnifiedMesh->SetKeepCPUCopies(keepCPUCopies);
+            mUnifiedMesh->SetCPUCopiesRequired(cpuCopiesRequired);
+
+            std::vector<IMesh*> meshes;
+            for (auto& model : mModels)
             {
-                mUnifiedMesh->GetUnifiedMesh() = std::make_unique<GLMesh>(false);
-            }
-            else if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
-            {
-                mUnifiedMesh->GetUnifiedMesh() = std::make_unique<VKMesh>(false);
+                for (auto& mesh : model->mMeshes)
+                {
+                    meshes.push_back(mesh.get());
+                }
             }
-
-            mUnifiedMesh->GetUnifiedMesh()->mVertices = oldVertices;
-            mUnifiedMesh->GetUnifiedMesh()->mIndices = oldIndices;
-            mUnifiedMesh->GetUnifiedMesh()->CreateVertexBuffers(device);
-            mUnifiedMesh->GetUnifiedMesh()->CreateIndexBuffers(device);
+            mUnifiedMesh->AddMeshes(device, meshes);
         }
+
+        ++mGeneration;
     }
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "../Vulkan/Core/Device.h"
+#include "../RHI/IMesh.h"
 #include "Assets/CaseInsensitiveHash.h"
 
 namespace Radis
@@ -41,6 +42,14 @@ namespace Radis
 		void ClearAllBuffers(class Device* device);
 		void RecreateAllBuffers(class Device* device);
 
+        // Bumped when mesh texture indices are assigned and when the buffers are recreated for
+        // another backend. Instance data built against an older generation is stale.
+        uint32_t GetGeneration() const { return mGeneration; }
+
+        // Simplification targets for models added from here on
+        void SetLODSettings(const MeshLODSettings& settings) { mLODSettings = settings; }
+        const MeshLODSettings& GetLODSettings() const { return mLODSettings; }
+
 	private:
 		friend class Model;
 
@@ -53,6 +62,8 @@ namespace Radis
         TextureLibrary& mTextureLibrary;
 
         uint32_t mLastModelLoaded = INVALID_MODEL_INDEX;
+        uint32_t mGeneration = 0;
+        MeshLODSettings mLODSettings;
 	};
 
 } // namespace Radis
\ No newline at end of file
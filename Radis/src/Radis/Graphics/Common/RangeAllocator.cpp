@@ -0,0 +1,97 @@
+#include <PCH/pch.h>
+#include "RangeAllocator.h"
+
+namespace Radis
+{
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+    {
+        Grow(capacity);
+    }
+
+    uint32_t RangeAllocator::Allocate(uint32_t count)
+    {
+        if (count == 0)
+        {
+            return INVALID_OFFSET;
+        }
+
+        for (auto it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it)
+        {
+            if (it->second < count) continue;
+
+            const uint32_t offset = it->first;
+            const uint32_t remaining = it->second - count;
+            mFreeBlocks.erase(it);
+            if (remaining > 0)
+            {
+                mFreeBlocks.emplace(offset + count, remaining);
+            }
+
+            mUsed += count;
+            return offset;
+        }
+
+        return INVALID_OFFSET;
+    }
+
+    void RangeAllocator::Free(uint32_t offset, uint32_t count)
+    {
+        if (offset == INVALID_OFFSET || count == 0)
+        {
+            return;
+        }
+
+        InsertFreeBlock(offset, count);
+        mUsed -= std::min(mUsed, count);
+    }
+
+    void RangeAllocator::InsertFreeBlock(uint32_t offset, uint32_t count)
+    {
+        auto next = mFreeBlocks.lower_bound(offset);
+
+        // Merge with the block right after
+        if (next != mFreeBlocks.end() && offset + count == next->first)
+        {
+            count += next->second;
+            next = mFreeBlocks.erase(next);
+        }
+
+        // Merge with the block right before
+        if (next != mFreeBlocks.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset)
+            {
+                prev->second += count;
+                return;
+            }
+        }
+
+        mFreeBlocks.emplace(offset, count);
+    }
+
+    void RangeAllocator::Grow(uint32_t newCapacity)
+    {
+        if (newCapacity <= mCapacity)
+        {
+            return;
+        }
+
+        InsertFreeBlock(mCapacity, newCapacity - mCapacity);
+        mCapacity = newCapacity;
+    }
+
+    uint32_t RangeAllocator::GetEnd() const
+    {
+        // The last free block reaching the capacity is the untouched tail
+        if (!mFreeBlocks.empty())
+        {
+            const auto& last = *mFreeBlocks.rbegin();
+            if (last.first + last.second == mCapacity)
+            {
+                return last.first;
+            }
+        }
+        return mCapacity;
+    }
+}
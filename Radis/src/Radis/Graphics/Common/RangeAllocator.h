@@ -0,0 +1,34 @@
+#pragma once
+
+namespace Radis
+{
+    // First-fit free-list over [0, capacity) elements. Freed ranges are merged with their
+    // neighbours so the arena doesn't fragment into slivers. Bookkeeping only, the caller
+    // owns the memory the offsets point into.
+    class RangeAllocator
+    {
+    public:
+        static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+        explicit RangeAllocator(uint32_t capacity = 0);
+
+        // Returns the offset of count free elements, INVALID_OFFSET if no block is big enough
+        uint32_t Allocate(uint32_t count);
+        void Free(uint32_t offset, uint32_t count);
+
+        // Adds the space between the old and new capacity as a free block
+        void Grow(uint32_t newCapacity);
+
+        uint32_t GetCapacity() const { return mCapacity; }
+        uint32_t GetUsed() const { return mUsed; }
+        // One past the highest allocated element
+        uint32_t GetEnd() const;
+
+    private:
+        void InsertFreeBlock(uint32_t offset, uint32_t count);
+
+        std::map<uint32_t, uint32_t> mFreeBlocks; // offset -> count, ordered for merging
+        uint32_t mCapacity = 0;
+        uint32_t mUsed = 0;
+    };
+}
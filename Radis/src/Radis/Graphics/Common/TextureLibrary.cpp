@@ -129,6 +129,12 @@ namespace Radis
             {
                 newTexture = std::make_unique<GLTexture>(mTexturesData[index]);
             }
+            else
+            {
+                // Headless: nothing to upload to, keep only the size/format metadata
+                mTexturesData[index].pixels.clear();
+                mTexturesData[index].pixels.shrink_to_fit();
+            }
 
             mTextures[index] = std::move(newTexture);
         }
@@ -178,29 +184,6 @@ namespace Radis
         return index;
     }
 
-    void TextureLibrary::ResizeStorageImage(const std::string& imageName, uint32_t newWidth, uint32_t newHeight)
-    {
-        auto it = mTextureMap.find(imageName);
-        if (it == mTextureMap.end())
-        {
-            return;
-        }
-
-        mNeedTextureDescriptorUpdate = true;
-
-        uint32_t index = it->second;
-
-        TextureData& tex = mTexturesData[index];
-        tex.width = newWidth;
-        tex.height = newHeight;
-
-        // vkFreeDescriptorSets(device->GetDevice(), mImageDescriptorPool, 1, &static_cast<VKTexture*>(mTextures[index].get())->mDescriptorSet);
-        mTextures[index].reset();
-
-        mTextures[index] = std::make_unique<VKTexture>(*device, tex);
-        CreateDescriptorSet(static_cast<VKTexture*>(mTextures[index].get()), tex.finalLayout);
-    }
-
     uint32_t TextureLibrary::CreateTexture(const std::string& imageName, uint32_t width, uint32_t height, VkFormat imageFormat, VkImageTiling tiling, VkImageUsageFlags usage, VkImageLayout finalLayout)
     {
         if (Engine::GetGraphicsAPI() != GraphicsAPI::Vulkan)
@@ -241,38 +224,6 @@ namespace Radis
         return index;
     }
 
-    void TextureLibrary::ResizeTexture(const std::string& imageName, uint32_t newWidth, uint32_t newHeight)
-    {
-        auto it = mTextureMap.find(imageName);
-        if (it == mTextureMap.end())
-        {
-            return;
-        }
-
-        mNeedReuploadRTImage = true; // This seems related to RT, you may want to check this logic
-
-        uint32_t index = it->second;
-
-        TextureData& tex = mTexturesData[index];
-        tex.width = newWidth;
-        tex.height = newHeight;
-
-        // Check if the old texture had a descriptor set before we destroy it
-        VKTexture* oldTexture = static_cast<VKTexture*>(mTextures[index].get());
-        bool hadShaderDescriptor = (oldTexture && oldTexture->mDescriptorSet != VK_NULL_HANDLE);
-
-        // vkFreeDescriptorSets... (your commented-out line)
-        mTextures[index].reset();
-
-        mTextures[index] = std::make_unique<VKTexture>(*device, tex);
-
-        // If it had a descriptor set before, recreate one
-        if (hadShaderDescriptor)
-        {
-            CreateDescriptorSet(static_cast<VKTexture*>(mTextures[index].get()), tex.finalLayout);
-        }
-    }
-
     ITexture* TextureLibrary::GetTexture(uint32_t index)
     {
         if (index < mTextures.size()) {
@@ -442,8 +393,6 @@ namespace Radis
                 VKTexture* vktex = static_cast<VKTexture*>(itex);
                 if (vktex)
                 {
-                    if (vktex->mData.name == "SceneTexture") continue;
-                    if (vktex->mData.name == "SceneDepth") continue;
                     imageInfos[j].imageView = vktex->GetImageView();
                 }
             }
@@ -504,42 +453,4 @@ namespace Radis
             mTextureMap[textureData.name] = index;
         }
     }
-
-    void TextureLibrary::UpdateRTUniform(RenderingResource& rr)
-    {
-        if (!mNeedReuploadRTImage) return;
-        mNeedReuploadRTImage = false;
-
-        std::vector<VKTexture*> rtTextures(SwapChain::MAX_FRAMES_IN_FLIGHT * 2);
-
-        // Loop and create one texture for each frame
-        for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
-        {
-            std::string texName = "RTColorImage_" + std::to_string(i);
-            rtTextures[i] = static_cast<VKTexture*>(rr.textureLibrary->GetTexture(texName));
-        }
-        for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
-        {
-            std::string texName = "RTHeatmapImage_" + std::to_string(i);
-            rtTextures[i + SwapChain::MAX_FRAMES_IN_FLIGHT] = static_cast<VKTexture*>(rr.textureLibrary->GetTexture(texName));
-        }
-
-        VkDescriptorImageInfo outImageInfo{};
-        outImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // storage image layout
-        outImageInfo.sampler = VK_NULL_HANDLE; // storage images donft use samplers
-        VkDescriptorImageInfo heatmapImageInfo{};
-        heatmapImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // storage image layout
-        heatmapImageInfo.sampler = VK_NULL_HANDLE; // storage images donft use samplers
-
-        for (int frameIndex = 0; frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT; ++frameIndex) 
-        {
-            outImageInfo.imageView = rtTextures[frameIndex]->GetImageView();
-            heatmapImageInfo.imageView = rtTextures[frameIndex + SwapChain::MAX_FRAMES_IN_FLIGHT]->GetImageView();
-
-            DescriptorWriter writer(*rr.rtUniform->GetDescriptorLayout(), *rr.rtUniform->GetDescriptorPool());
-            writer.WriteImage(1, &outImageInfo);
-            writer.WriteImage(2, &heatmapImageInfo);
-            writer.Overwrite(rr.rtUniform->GetDescriptorSets()[frameIndex]);
-        }
-    }
 }
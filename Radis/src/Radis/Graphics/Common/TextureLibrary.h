@@ -20,7 +20,6 @@ namespace Radis
         bool LoadQueuedTextures();
 
 		uint32_t CreateStorageImage(const std::string& imageName, uint32_t width, uint32_t height, VkFormat imageFormat, VkImageUsageFlags usage, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_GENERAL);
-		void ResizeStorageImage(const std::string& imageName, uint32_t newWidth, uint32_t newHeight);
 
 		uint32_t CreateTexture(
 			const std::string& imageName,
@@ -32,8 +31,6 @@ namespace Radis
 			VkImageLayout finalLayout
 		);
 
-		void ResizeTexture(const std::string& imageName, uint32_t newWidth, uint32_t newHeight);
-
 		ITexture* GetTexture(uint32_t textureID);
 		ITexture* GetTexture(const std::string& texturePath);
 		ITexture* GetTextureByIndex(uint32_t index);
@@ -46,7 +43,6 @@ namespace Radis
 
 		void ClearAllBuffers(class Device* device);
 		void RecreateAllBuffers(class Device* device);
-		void UpdateRTUniform(struct RenderingResource& renderData);
 
 		void CreateTextureSampler();
 		void CreateDescriptors();
@@ -67,7 +63,6 @@ namespace Radis
 
         std::vector<TextureLoadData> mPendingTextureLoads;
         uint32_t mNextIndex = 0;
-        bool mNeedReuploadRTImage = false;
         bool mNeedTextureDescriptorUpdate = false;
 	};
 
@@ -7,6 +7,8 @@
 // ktx2
 #include "ktx.h"
 
+#include "Jobs/JobSystem.h"
+
 namespace Radis
 {
     bool TextureLoader::IsKTX2Path(const std::string& path)
@@ -241,30 +243,21 @@ namespace Radis
     {
         if (loadData.empty()) return;
 
-        std::vector<std::future<bool>> futures;
-        futures.reserve(loadData.size());
-
-        for (auto& entry : loadData)
+        // One texture per job; decode times vary a lot, so let the workers balance it.
+        JobSystem::ParallelFor(loadData.size(), 1, [&loadData](size_t begin, size_t end)
         {
-            futures.emplace_back(std::async(std::launch::async, [&entry]()
+            for (size_t i = begin; i < end; ++i)
             {
+                auto& entry = loadData[i];
                 if (entry.data != nullptr && entry.size > 0)
                 {
-                    return TextureLoader::FromMemory(entry.data, entry.size, entry.path, entry.outTexture);
+                    TextureLoader::FromMemory(entry.data, entry.size, entry.path, entry.outTexture);
                 }
                 else if (!entry.path.empty())
                 {
-                    return TextureLoader::FromFile(entry.path, entry.outTexture);
+                    TextureLoader::FromFile(entry.path, entry.outTexture);
                 }
-
-                return false;
-            }));
-        }
-
-        // Wait for all tasks to complete
-        for (auto& f : futures)
-        {
-            f.get();
-        }
+            }
+        });
     }
 }
@@ -9,37 +9,193 @@
 namespace Radis
 {
     UnifiedMeshes::UnifiedMeshes()
+        : mUnifiedMesh(IMesh::Create(false))
     {
-        if (Engine::GetGraphicsAPI() == GraphicsAPI::Vulkan)
+    }
+
+    UnifiedMeshes::~UnifiedMeshes()
+    {
+    }
+
+    bool UnifiedMeshes::AllocateRanges(uint32_t vertexCount, uint32_t indexCount, uint32_t& firstVertex, uint32_t& firstIndex)
+    {
+        firstVertex = mVertexRanges.Allocate(vertexCount);
+        while (firstVertex == RangeAllocator::INVALID_OFFSET)
         {
-            mUnifiedMesh = std::make_unique<VKMesh>(false);
+            const uint64_t capacity = std::max<uint64_t>(mVertexRanges.GetCapacity() * 2ull, INITIAL_VERTEX_CAPACITY);
+            if (capacity > UINT32_MAX)
+            {
+                return false;
+            }
+            mVertexRanges.Grow(static_cast<uint32_t>(capacity));
+            firstVertex = mVertexRanges.Allocate(vertexCount);
         }
-        else if (Engine::GetGraphicsAPI() == GraphicsAPI::OpenGL)
+
+        firstIndex = mIndexRanges.Allocate(indexCount);
+        while (firstIndex == RangeAllocator::INVALID_OFFSET)
         {
-            mUnifiedMesh = std::make_unique<GLMesh>(false);
+            const uint64_t capacity = std::max<uint64_t>(mIndexRanges.GetCapacity() * 2ull, INITIAL_INDEX_CAPACITY);
+            if (capacity > UINT32_MAX)
+            {
+                mVertexRanges.Free(firstVertex, vertexCount);
+                return false;
+            }
+            mIndexRanges.Grow(static_cast<uint32_t>(capacity));
+            firstIndex = mIndexRanges.Allocate(indexCount);
         }
+
+        return true;
     }
 
-    UnifiedMeshes::~UnifiedMeshes()
+    void UnifiedMeshes::AddMeshes(Device* device, const std::vector<IMesh*>& meshes)
     {
+        std::vector<MeshRangeUpload> uploads;
+        uploads.reserve(meshes.size());
+        // LOD 0 and the LOD index lists back to back, only for meshes that have LODs
+        std::vector<std::vector<uint32_t>> chainedIndices;
+        chainedIndices.reserve(meshes.size());
+        std::vector<std::vector<PackedVertex>> packedVertices;
+        std::vector<std::vector<SkinVertex>> skinVertices;
+        packedVertices.reserve(meshes.size());
+        skinVertices.reserve(meshes.size());
+
+        for (IMesh* mesh : meshes)
+        {
+            // Re-adding a mesh replaces its old ranges
+            RemoveMesh(mesh->mMeshID);
+
+            const uint32_t vertexCount = static_cast<uint32_t>(mesh->mVertices.size());
+            const uint32_t lod0IndexCount = static_cast<uint32_t>(mesh->mIndices.size());
+            if (vertexCount == 0 || lod0IndexCount == 0)
+            {
+                // Still registered, drawing it just draws nothing
+                mMeshInfos[mesh->mMeshID] = { MeshInfo{} };
+                continue;
+            }
+
+            uint32_t indexCount = lod0IndexCount;
+            for (const MeshLOD& lod : mesh->mLODs)
+            {
+                indexCount += static_cast<uint32_t>(lod.indices.size());
+            }
+
+            uint32_t firstVertex = 0;
+            uint32_t firstIndex = 0;
+            if (!AllocateRanges(vertexCount, indexCount, firstVertex, firstIndex))
+            {
+                RADIS_ERROR("Unified mesh arena is full, mesh {} not added", mesh->mMeshID);
+                mMeshInfos[mesh->mMeshID] = { MeshInfo{} };
+                continue;
+            }
+
+            std::vector<MeshInfo>& lodInfos = mMeshInfos[mesh->mMeshID];
+            lodInfos.clear();
+            lodInfos.reserve(1 + mesh->mLODs.size());
+
+            MeshInfo meshInfo;
+            meshInfo.indexCount = lod0IndexCount;
+            meshInfo.firstIndex = firstIndex;
+            meshInfo.vertexOffset = static_cast<int32_t>(firstVertex);
+            meshInfo.vertexCount = vertexCount;
+            lodInfos.push_back(meshInfo);
+
+            if (!mesh->mMeshlets.empty())
+            {
+                mMeshlets[mesh->mMeshID] = mesh->mMeshlets;
+            }
+
+            const uint32_t* indices = mesh->mIndices.data();
+            if (!mesh->mLODs.empty())
+            {
+                std::vector<uint32_t>& chain = chainedIndices.emplace_back();
+                chain.reserve(indexCount);
+                chain.insert(chain.end(), mesh->mIndices.begin(), mesh->mIndices.end());
+
+                for (const MeshLOD& lod : mesh->mLODs)
+                {
+                    meshInfo.firstIndex = firstIndex + static_cast<uint32_t>(chain.size());
+                    meshInfo.indexCount = static_cast<uint32_t>(lod.indices.size());
+                    meshInfo.lodError = lod.error;
+                    lodInfos.push_back(meshInfo);
+                    chain.insert(chain.end(), lod.indices.begin(), lod.indices.end());
+                }
+                indices = chain.data();
+            }
+
+            std::vector<PackedVertex>& packed = packedVertices.emplace_back();
+            std::vector<SkinVertex>& skin = skinVertices.emplace_back();
+            mesh->PackVertices(packed, skin);
+
+            uploads.push_back({ packed.data(), skin.data(), vertexCount, firstVertex, indices, indexCount, firstIndex });
+        }
+
+        if (uploads.empty())
+        {
+            return;
+        }
+
+        // Grows the GPU buffers to match the allocators, a no-op when nothing grew
+        mUnifiedMesh->ReserveBuffers(device, mVertexRanges.GetCapacity(), mIndexRanges.GetCapacity());
+        mUnifiedMesh->UploadRanges(device, uploads);
+
+        if (mKeepCPUCopies)
+        {
+            std::vector<PackedVertex>& vertices = mPackedVertices;
+            std::vector<uint32_t>& indices = mUnifiedMesh->mIndices;
+            vertices.resize(std::max<size_t>(vertices.size(), mVertexRanges.GetEnd()));
+            indices.resize(std::max<size_t>(indices.size(), mIndexRanges.GetEnd()));
+
+            for (const MeshRangeUpload& upload : uploads)
+            {
+                std::copy_n(upload.vertices, upload.vertexCount, vertices.begin() + upload.firstVertex);
+                std::copy_n(upload.indices, upload.indexCount, indices.begin() + upload.firstIndex);
+            }
+        }
     }
 
     void UnifiedMeshes::AddMesh(Device& device, IMesh& mesh)
     {
-        mUnifiedMesh->DestroyBuffers();
+        AddMeshes(&device, { &mesh });
+    }
 
-        MeshInfo meshInfo;
-        meshInfo.indexCount = static_cast<uint32_t>(mesh.mIndices.size());
-        meshInfo.firstIndex = static_cast<uint32_t>(mUnifiedMesh->mIndices.size());
-        meshInfo.vertexOffset = static_cast<int32_t>(mUnifiedMesh->mVertices.size());
+    void UnifiedMeshes::RemoveMesh(uint32_t meshID)
+    {
+        auto it = mMeshInfos.find(meshID);
+        if (it == mMeshInfos.end())
+        {
+            return;
+        }
 
-        mUnifiedMesh->mVertices.insert(mUnifiedMesh->mVertices.end(), mesh.mVertices.begin(), mesh.mVertices.end());
-        mUnifiedMesh->mIndices.insert(mUnifiedMesh->mIndices.end(), mesh.mIndices.begin(), mesh.mIndices.end());
+        // LOD 0 starts the index range, the LODs fill the rest of it
+        const MeshInfo& meshInfo = it->second.front();
+        uint32_t indexCount = 0;
+        for (const MeshInfo& lod : it->second)
+        {
+            indexCount += lod.indexCount;
+        }
+        mVertexRanges.Free(static_cast<uint32_t>(meshInfo.vertexOffset), meshInfo.vertexCount);
+        mIndexRanges.Free(meshInfo.firstIndex, indexCount);
+        mMeshInfos.erase(it);
+        mMeshlets.erase(meshID);
+    }
 
-        mUnifiedMesh->CreateVertexBuffers(&device);
-        mUnifiedMesh->CreateIndexBuffers(&device);
+    void UnifiedMeshes::SetKeepCPUCopies(bool keep)
+    {
+        if (!keep && mCPUCopiesRequired)
+        {
+            RADIS_WARN("Keeping the unified mesh CPU copies, ray tracing builds its mesh data from them");
+            return;
+        }
 
-        mMeshInfos[mesh.mMeshID] = meshInfo;
+        mKeepCPUCopies = keep;
+        if (!keep)
+        {
+            // Ranges added from here on are GPU only, a mirror with holes in it is worse than none
+            mPackedVertices.clear();
+            mPackedVertices.shrink_to_fit();
+            mUnifiedMesh->mIndices.clear();
+            mUnifiedMesh->mIndices.shrink_to_fit();
+        }
     }
 
-} // namespace Radis
\ No newline at end of file
+} // namespace Radis
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/RHI/IMesh.h"
+#include "RangeAllocator.h"
 
 namespace Radis
 {
@@ -11,22 +12,68 @@ namespace Radis
         uint32_t indexCount;
         uint32_t firstIndex;
         int32_t  vertexOffset;
+        uint32_t vertexCount;
+        float lodError = 0.f; // object space, see MeshLOD
     };
 
+    // Every mesh's geometry suballocated out of one device-local vertex/index arena, so the
+    // scene binds a single pair of buffers. Adding meshes uploads only their ranges, the arena
+    // doubles (keeping its contents) when it runs out of room. A mesh's LODs share its vertex
+    // range, their index lists follow LOD 0's in one contiguous index range. Vertices are stored
+    // packed, as a PackedVertex and a SkinVertex stream over the same vertex ranges. Meshes with
+    // meshlets keep their bounds here for cluster culling.
     class UnifiedMeshes
     {
     public:
+        static constexpr uint32_t INITIAL_VERTEX_CAPACITY = 1u << 18;
+        static constexpr uint32_t INITIAL_INDEX_CAPACITY = 1u << 20;
+
         UnifiedMeshes();
         ~UnifiedMeshes();
 
+        // Batch upload, one transfer for all of them
+        void AddMeshes(Device* device, const std::vector<IMesh*>& meshes);
         void AddMesh(Device& device, IMesh& mesh);
+        // Frees the mesh's ranges for reuse. No frame in flight may still draw it.
+        void RemoveMesh(uint32_t meshID);
+
+        // The CPU mirror in GetPackedVertices() and GetUnifiedMesh()->mIndices, ray tracing builds its mesh data from it
+        void SetKeepCPUCopies(bool keep);
+        bool GetKeepCPUCopies() const { return mKeepCPUCopies; }
+        // While required, SetKeepCPUCopies(false) is refused
+        void SetCPUCopiesRequired(bool required) { mCPUCopiesRequired = required; }
+        bool GetCPUCopiesRequired() const { return mCPUCopiesRequired; }
 
         std::unique_ptr<IMesh>& GetUnifiedMesh() { return mUnifiedMesh; }
-        const MeshInfo& GetMeshInfo(uint32_t meshID) const { return mMeshInfos.at(meshID); }
+        const std::vector<PackedVertex>& GetPackedVertices() const { return mPackedVertices; }
+        // lod is clamped to the coarsest one the mesh has. Meshes that couldn't be added (empty,
+        // or the arena was full) have a single empty entry, so every added ID resolves.
+        const MeshInfo& GetMeshInfo(uint32_t meshID, uint32_t lod = 0) const
+        {
+            const std::vector<MeshInfo>& lods = mMeshInfos.at(meshID);
+            return lods[std::min<size_t>(lod, lods.size() - 1)];
+        }
+        uint32_t GetLODCount(uint32_t meshID) const { return static_cast<uint32_t>(mMeshInfos.at(meshID).size()); }
+        // LOD 0 clusters, index ranges relative to GetMeshInfo(meshID).firstIndex. Null if the mesh has none.
+        const std::vector<Meshlet>* GetMeshlets(uint32_t meshID) const
+        {
+            auto it = mMeshlets.find(meshID);
+            return it != mMeshlets.end() ? &it->second : nullptr;
+        }
         uint32_t GetMeshCount() const { return static_cast<uint32_t>(mMeshInfos.size()); }
 
     private:
+        // Grows the arena until both requests fit, returns false if an allocator can't grow further
+        bool AllocateRanges(uint32_t vertexCount, uint32_t indexCount, uint32_t& firstVertex, uint32_t& firstIndex);
+
         std::unique_ptr<IMesh> mUnifiedMesh;
-        std::unordered_map<uint32_t, MeshInfo> mMeshInfos;
+        std::vector<PackedVertex> mPackedVertices;
+        std::unordered_map<uint32_t, std::vector<MeshInfo>> mMeshInfos; // meshID -> LOD 0 onward
+        std::unordered_map<uint32_t, std::vector<Meshlet>> mMeshlets;
+
+        RangeAllocator mVertexRanges;
+        RangeAllocator mIndexRanges;
+        bool mKeepCPUCopies = true;
+        bool mCPUCopiesRequired = false;
     };
 }
@@ -0,0 +1,34 @@
+#include <PCH/pch.h>
+#include "HeadlessMesh.h"
+
+namespace Radis
+{
+    HeadlessMesh::HeadlessMesh(bool assignID)
+        : IMesh(assignID)
+    {
+    }
+
+    // device will be nullptr
+    void HeadlessMesh::CreateVertexBuffers(Device* device)
+    {
+        mVertexCount = static_cast<uint32_t>(mVertices.size());
+        mTriangleCount = mVertexCount / 3;
+        mHasIndexBuffer = !mIndices.empty();
+    }
+
+    void HeadlessMesh::ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity)
+    {
+        mVertexCapacity = std::max(vertexCapacity, mVertexCapacity);
+        mIndexCapacity = std::max(indexCapacity, mIndexCapacity);
+        mHasIndexBuffer = true;
+    }
+
+    void HeadlessMesh::CreateIndexBuffers(Device* device)
+    {
+        mIndexCount = static_cast<uint32_t>(mIndices.size());
+        if (mHasIndexBuffer)
+        {
+            mTriangleCount = mIndexCount / 3;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Graphics/RHI/IMesh.h"
+
+namespace Radis
+{
+    // Forward reference
+    class Device;
+
+    // Used with GraphicsAPI::None: keeps the CPU-side geometry and counts, never touches a GPU.
+    class HeadlessMesh : public IMesh {
+    public:
+        HeadlessMesh(bool assignID = true);
+        ~HeadlessMesh() = default;
+
+        void CreateVertexBuffers(Device* device) override;
+        void CreateIndexBuffers(Device* device) override;
+        void DestroyBuffers() override {}
+
+        void ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity) override;
+        void UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads) override {}
+
+        void Bind(VkCommandBuffer commandBuffer = nullptr) override {}
+        void Draw(VkCommandBuffer commandBuffer = nullptr, uint32_t baseIndex = 0) override {}
+    };
+}
@@ -0,0 +1,67 @@
+#include <PCH/pch.h>
+#include "GLInstanceTable.h"
+#include "GLRingBuffer.h"
+
+namespace Radis
+{
+    GLInstanceTable::GLInstanceTable()
+    {
+        CreateStorage();
+    }
+
+    GLInstanceTable::~GLInstanceTable()
+    {
+        if (mBuffer)
+        {
+            glDeleteBuffers(1, &mBuffer);
+        }
+    }
+
+    void GLInstanceTable::Bind(GLuint bindingPoint) const
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, mBuffer);
+    }
+
+    bool GLInstanceTable::Reallocate(uint32_t newCapacity)
+    {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newCapacity) * sizeof(InstanceUniforms), nullptr, 0);
+
+        if (mBuffer)
+        {
+            glBindBuffer(GL_COPY_READ_BUFFER, mBuffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(GetCapacity()) * sizeof(InstanceUniforms));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glDeleteBuffers(1, &mBuffer);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        mBuffer = buffer;
+        return true;
+    }
+
+    void GLInstanceTable::Upload(FrameRingBuffer& ring, const std::vector<UploadRun>& runs)
+    {
+        if (runs.empty())
+        {
+            return;
+        }
+
+        const GLRingBuffer& glRing = static_cast<const GLRingBuffer&>(ring);
+        glBindBuffer(GL_COPY_READ_BUFFER, glRing.GetBuffer(glRing.GetFrameIndex()));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+        for (const UploadRun& run : runs)
+        {
+            glCopyBufferSubData(
+                GL_COPY_READ_BUFFER,
+                GL_COPY_WRITE_BUFFER,
+                run.ringOffset,
+                static_cast<GLintptr>(run.firstSlot) * sizeof(InstanceUniforms),
+                static_cast<GLsizeiptr>(run.count) * sizeof(InstanceUniforms));
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Graphics/Common/InstanceTable.h"
+
+namespace Radis
+{
+    // Immutable buffer storage the draws read instances from. Uploads are GPU copies out of the
+    // frame ring, GL orders them against the draws that read the table before and after.
+    class GLInstanceTable : public InstanceTable
+    {
+    public:
+        GLInstanceTable();
+        ~GLInstanceTable();
+
+        void Bind(GLuint bindingPoint) const;
+
+    protected:
+        bool Reallocate(uint32_t newCapacity) override;
+        void Upload(FrameRingBuffer& ring, const std::vector<UploadRun>& runs) override;
+
+    private:
+        GLuint mBuffer = 0;
+    };
+}
@@ -6,6 +6,90 @@
 
 namespace Radis
 {
+    namespace
+    {
+        // Attribute pointers for a full Vertex VBO bound to GL_ARRAY_BUFFER, with the VAO bound.
+        // Per mesh buffers only, the arena holds the packed streams.
+        void SetupVertexLayout()
+        {
+            // location 0: position (vec3)
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+            // location 1: color (vec3)
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+
+            // location 2: normal (vec3)
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+            // location 3: uv (vec2)
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+
+            // location 4: bone IDs (ivec4)
+            glEnableVertexAttribArray(4);
+            glVertexAttribIPointer(4, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
+
+            // location 5: weights (vec4)
+            glEnableVertexAttribArray(5);
+            glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
+        }
+
+        // Attribute pointers for the arena's PackedVertex and SkinVertex streams, with the VAO bound
+        void SetupPackedVertexLayout(GLuint vertexBuffer, GLuint skinBuffer)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+
+            // location 0: position (unorm16 xyz)
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+
+            // location 1: color (unorm8 rgb)
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, color));
+
+            // location 2: octahedral normal (snorm16 xy)
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+
+            // location 3: uv (half xy)
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+
+            glBindBuffer(GL_ARRAY_BUFFER, skinBuffer);
+
+            // location 4: bone IDs (u8 x4)
+            glEnableVertexAttribArray(4);
+            glVertexAttribIPointer(4, 4, GL_UNSIGNED_BYTE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, boneIDs));
+
+            // location 5: weights (unorm8 x4)
+            glEnableVertexAttribArray(5);
+            glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, weights));
+        }
+
+        // New buffer of newSize bytes holding the first oldSize bytes of oldBuffer (if any), which is deleted
+        GLuint GrowBuffer(GLuint oldBuffer, GLsizeiptr oldSize, GLsizeiptr newSize)
+        {
+            GLuint newBuffer = 0;
+            glGenBuffers(1, &newBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW);
+
+            if (oldBuffer)
+            {
+                glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &oldBuffer);
+            }
+
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            return newBuffer;
+        }
+    }
+
     GLMesh::GLMesh(bool assignID)
         : IMesh(assignID)
     {
@@ -32,29 +116,7 @@ namespace Radis
         glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(Vertex), mVertices.data(), GL_STATIC_DRAW);
 
         // ---- Vertex layout ----
-        // location 0: position (vec3)
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-        // location 1: color (vec3)
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-
-        // location 2: normal (vec3)
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-        // location 3: uv (vec2)
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-
-        // location 4: bone IDs (ivec4)
-        glEnableVertexAttribArray(4);
-        glVertexAttribIPointer(4, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-
-        // location 5: weights (vec4)
-        glEnableVertexAttribArray(5);
-        glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, weights));
+        SetupVertexLayout();
 
         glBindVertexArray(0);
     }
@@ -73,6 +135,61 @@ namespace Radis
         glBindVertexArray(0);
     }
 
+    void GLMesh::ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity)
+    {
+        if (vertexCapacity <= mVertexCapacity && indexCapacity <= mIndexCapacity)
+        {
+            return;
+        }
+        vertexCapacity = std::max(vertexCapacity, mVertexCapacity);
+        indexCapacity = std::max(indexCapacity, mIndexCapacity);
+
+        if (!mVAO)
+        {
+            glGenVertexArrays(1, &mVAO);
+        }
+
+        mVBO = GrowBuffer(mVBO, mVertexCapacity * sizeof(PackedVertex), vertexCapacity * sizeof(PackedVertex));
+        mSkinVBO = GrowBuffer(mSkinVBO, mVertexCapacity * sizeof(SkinVertex), vertexCapacity * sizeof(SkinVertex));
+        mEBO = GrowBuffer(mEBO, mIndexCapacity * sizeof(uint32_t), indexCapacity * sizeof(uint32_t));
+
+        // Attribute pointers and the element buffer are captured at setup, point them at the new buffers
+        glBindVertexArray(mVAO);
+        SetupPackedVertexLayout(mVBO, mSkinVBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        mVertexCapacity = vertexCapacity;
+        mIndexCapacity = indexCapacity;
+        mHasIndexBuffer = true;
+    }
+
+    void GLMesh::UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mVBO);
+        for (const MeshRangeUpload& upload : uploads)
+        {
+            if (upload.vertexCount == 0) continue;
+            glBufferSubData(GL_COPY_WRITE_BUFFER, upload.firstVertex * sizeof(PackedVertex), upload.vertexCount * sizeof(PackedVertex), upload.vertices);
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mSkinVBO);
+        for (const MeshRangeUpload& upload : uploads)
+        {
+            if (upload.vertexCount == 0) continue;
+            glBufferSubData(GL_COPY_WRITE_BUFFER, upload.firstVertex * sizeof(SkinVertex), upload.vertexCount * sizeof(SkinVertex), upload.skin);
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mEBO);
+        for (const MeshRangeUpload& upload : uploads)
+        {
+            if (upload.indexCount == 0) continue;
+            glBufferSubData(GL_COPY_WRITE_BUFFER, upload.firstIndex * sizeof(uint32_t), upload.indexCount * sizeof(uint32_t), upload.indices);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
     void GLMesh::DestroyBuffers()
     {
         if (mEBO) {
@@ -83,10 +200,16 @@ namespace Radis
             glDeleteBuffers(1, &mVBO);
             mVBO = 0;
         }
+        if (mSkinVBO) {
+            glDeleteBuffers(1, &mSkinVBO);
+            mSkinVBO = 0;
+        }
         if (mVAO) {
             glDeleteVertexArrays(1, &mVAO);
             mVAO = 0;
         }
+        mVertexCapacity = 0;
+        mIndexCapacity = 0;
     }
 
     // all will be nullptr
@@ -16,8 +16,15 @@ namespace Radis
         void CreateIndexBuffers(Device* device) override;
         void DestroyBuffers() override;
 
+        void ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity) override;
+        void UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads) override;
+
         void Bind(VkCommandBuffer commandBuffer = nullptr) override;
         void Draw(VkCommandBuffer commandBuffer = nullptr, uint32_t baseIndex = 0) override;
+
+    private:
+        // Arena only: the SkinVertex stream next to the PackedVertex one in mVBO
+        GLuint mSkinVBO = 0;
     };
 }
 
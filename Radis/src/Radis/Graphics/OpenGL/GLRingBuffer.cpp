@@ -0,0 +1,107 @@
+#include <PCH/pch.h>
+#include "GLRingBuffer.h"
+
+namespace Radis
+{
+    namespace
+    {
+        GLint GetStorageOffsetAlignment()
+        {
+            GLint alignment = 0;
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            return alignment;
+        }
+
+        constexpr GLbitfield RING_STORAGE_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    }
+
+    GLRingBuffer::GLRingBuffer(uint32_t frameCount)
+        : FrameRingBuffer(frameCount, static_cast<uint32_t>(GetStorageOffsetAlignment()), UINT32_MAX / 2)
+        , mBuffers(frameCount, 0)
+        , mFences(frameCount, nullptr)
+    {
+        CreateSlots();
+    }
+
+    GLRingBuffer::~GLRingBuffer()
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(mBuffers.size()); ++i)
+        {
+            if (mFences[i])
+            {
+                glDeleteSync(mFences[i]);
+            }
+            if (mBuffers[i])
+            {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffers[i]);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+                glDeleteBuffers(1, &mBuffers[i]);
+            }
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void GLRingBuffer::BeginFrame(uint32_t frameIndex)
+    {
+        GLsync& fence = mFences[frameIndex];
+        if (fence)
+        {
+            // Flush on the first try so the fence is guaranteed to signal
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (result == GL_TIMEOUT_EXPIRED)
+            {
+                result = glClientWaitSync(fence, 0, 1'000'000);
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        FrameRingBuffer::BeginFrame(frameIndex);
+    }
+
+    void GLRingBuffer::EndFrame()
+    {
+        GLsync& fence = mFences[mFrameIndex];
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void GLRingBuffer::BindRange(GLuint bindingPoint, uint32_t offset, uint32_t size) const
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingPoint, mBuffers[mFrameIndex], offset, size);
+    }
+
+    uint8_t* GLRingBuffer::Reallocate(uint32_t frameIndex, uint32_t newCapacity, uint32_t usedBytes)
+    {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, RING_STORAGE_FLAGS);
+        uint8_t* mapping = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, newCapacity, RING_STORAGE_FLAGS));
+
+        GLuint& oldBuffer = mBuffers[frameIndex];
+        if (oldBuffer)
+        {
+            // Copied on the GPU, queued ahead of every draw that reads this frame's data
+            glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+            if (usedBytes > 0)
+            {
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+            }
+            glUnmapBuffer(GL_COPY_READ_BUFFER);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glDeleteBuffers(1, &oldBuffer);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        oldBuffer = buffer;
+        return mapping;
+    }
+}
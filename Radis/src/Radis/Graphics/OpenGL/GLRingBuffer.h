@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Graphics/Common/FrameRingBuffer.h"
+
+namespace Radis
+{
+    // Persistent, coherently mapped buffer storage per frame slot. GL has no frame fences of its
+    // own, so each slot is fenced in EndFrame and waited on when BeginFrame comes back around to it.
+    class GLRingBuffer : public FrameRingBuffer
+    {
+    public:
+        GLRingBuffer(uint32_t frameCount);
+        ~GLRingBuffer();
+
+        void BeginFrame(uint32_t frameIndex) override;
+        void EndFrame() override;
+
+        // Binds [offset, offset + size) of the current slot to a shader storage binding point
+        void BindRange(GLuint bindingPoint, uint32_t offset, uint32_t size) const;
+
+        GLuint GetBuffer(uint32_t frameIndex) const { return mBuffers[frameIndex]; }
+
+    protected:
+        uint8_t* Reallocate(uint32_t frameIndex, uint32_t newCapacity, uint32_t usedBytes) override;
+
+    private:
+        std::vector<GLuint> mBuffers;
+        std::vector<GLsync> mFences;
+    };
+}
@@ -11,10 +11,8 @@ namespace Radis {
     float GLShader::iTime = 0.0f;
     GLuint GLShader::uboMatrices = 0;
     GLuint GLShader::uboMatricesBindingPoint = 0;
-    GLuint GLShader::instanceSSBO = 0;
-    GLuint GLShader::animationSSBO = 0;
     GLuint GLShader::textureSSBO = 0;
-    GLuint GLShader::lightSSBO = 0;
+    GLuint GLShader::indirectBuffer = 0;
 
     int GLShader::CurrentID = 0;
     GLShader GLShader::activeShader = GLShader();
@@ -271,28 +269,6 @@ namespace Radis {
         return Uniforms.find(name) != Uniforms.end();
     }
 
-    void GLShader::SetupInstanceSSBO()
-    {
-        if (instanceSSBO != 0) return;
-
-        glGenBuffers(1, &instanceSSBO);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceSSBO);
-        uint32_t maxInstances = InstanceUniforms::MAX_INSTANCES;
-        glBufferData(GL_SHADER_STORAGE_BUFFER, maxInstances * sizeof(InstanceUniforms), nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, instanceSSBO);
-    }
-
-    void GLShader::SetupAnimationSSBO()
-    {
-        if (animationSSBO != 0) return;
-
-        glGenBuffers(1, &animationSSBO);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, animationSSBO);
-        uint32_t maxAnimations = AnimationUniforms::MAX_BONES;
-        glBufferData(GL_SHADER_STORAGE_BUFFER, maxAnimations * sizeof(AnimationUniforms), nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, animationSSBO);
-    }
-
     void GLShader::SetupTextureSSBO()
     {
         if (textureSSBO != 0) return;
@@ -304,15 +280,17 @@ namespace Radis {
         glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, textureSSBO);
     }
 
-    void GLShader::SetupLightSSBO()
+    void GLShader::SetupIndirectBuffer(uint32_t maxDraws)
     {
-        if (lightSSBO != 0) return;
+        if (indirectBuffer != 0) return;
+
+        // DrawElementsIndirectCommand has the same layout as VkDrawIndexedIndirectCommand
+        static_assert(sizeof(VkDrawIndexedIndirectCommand) == 5 * sizeof(GLuint));
 
-        glGenBuffers(1, &lightSSBO);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightSSBO);
-        uint32_t maxLights = LightUniform::MAX_LIGHTS;
-        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::vec4) + maxLights * sizeof(LightUniform), nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, lightSSBO);
+        glGenBuffers(1, &indirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, maxDraws * sizeof(VkDrawIndexedIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
     }
 
     bool GLShader::checkCompileErrors(unsigned int object, std::string type)
@@ -395,15 +373,11 @@ namespace Radis {
     void GLShader::CleanupUBO()
     {
         glDeleteBuffers(1, &uboMatrices);
-        glDeleteBuffers(1, &instanceSSBO);
-        glDeleteBuffers(1, &animationSSBO);
         glDeleteBuffers(1, &textureSSBO);
-        glDeleteBuffers(1, &lightSSBO);
+        glDeleteBuffers(1, &indirectBuffer);
         uboMatrices = 0;
-        instanceSSBO = 0;
-        animationSSBO = 0;
         textureSSBO = 0;
-        lightSSBO = 0;
+        indirectBuffer = 0;
 
         CurrentID = 0;
     }
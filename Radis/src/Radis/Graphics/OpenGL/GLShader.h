@@ -55,14 +55,11 @@ namespace Radis {
         static void SetShader(GLShader& shader) { activeShader = shader.Use(); }
         static GLShader& GetActiveShader() { return activeShader; }
 
-        static GLuint GetInstanceSSBO() { return instanceSSBO; }
-        static void SetupInstanceSSBO();
-        static GLuint GetAnimationSSBO() { return animationSSBO; }
-        static void SetupAnimationSSBO();
+        // Instances, bones and lights are bound from the frame ring buffer (GLRingBuffer)
         static GLuint GetTextureSSBO() { return textureSSBO; }
         static void SetupTextureSSBO();
-        static GLuint GetLightSSBO() { return lightSSBO; }
-        static void SetupLightSSBO();
+        static GLuint GetIndirectBuffer() { return indirectBuffer; }
+        static void SetupIndirectBuffer(uint32_t maxDraws);
 
     private:
         // checks if compilation or linking failed and if so, print the error logs
@@ -70,10 +67,8 @@ namespace Radis {
         bool loadShaderFromFile(const std::string& shaderFile);
 
         static GLShader activeShader;
-        static GLuint instanceSSBO;
-        static GLuint animationSSBO;
         static GLuint textureSSBO;
-        static GLuint lightSSBO;
+        static GLuint indirectBuffer;
     };
 
 }
\ No newline at end of file
@@ -1,11 +1,38 @@
 #include <PCH/pch.h>
 #include "IMesh.h"
 #include "Graphics/Vulkan/Core/Buffer.h"
+#include "Graphics/Vulkan/VKMesh.h"
+#include "Graphics/OpenGL/GLMesh.h"
+#include "Graphics/Headless/HeadlessMesh.h"
+#include "Engine.h"
+
+#include <meshoptimizer.h>
 
 namespace Radis
 {
     int IMesh::uniqueMeshIndex = 0;
 
+    namespace
+    {
+        // Octahedral mapping of a unit vector onto [-1, 1]^2
+        glm::vec2 OctEncode(const glm::vec3& n)
+        {
+            const float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (sum == 0.f)
+            {
+                return glm::vec2(0.f);
+            }
+
+            glm::vec2 p = glm::vec2(n.x, n.y) / sum;
+            if (n.z < 0.f)
+            {
+                const glm::vec2 sign(p.x >= 0.f ? 1.f : -1.f, p.y >= 0.f ? 1.f : -1.f);
+                p = (1.f - glm::abs(glm::vec2(p.y, p.x))) * sign;
+            }
+            return p;
+        }
+    }
+
     IMesh::IMesh(bool assignID)
         : mMeshID(0)
     {
@@ -14,4 +41,249 @@ namespace Radis
             mMeshID = uniqueMeshIndex++;
         }
     }
+
+    void IMesh::ComputeBounds()
+    {
+        if (mVertices.empty())
+        {
+            mAABBmin = mAABBmax = glm::vec3(0.f);
+            mBoundingRadius = 0.f;
+            return;
+        }
+
+        mAABBmin = glm::vec3(std::numeric_limits<float>::max());
+        mAABBmax = glm::vec3(std::numeric_limits<float>::lowest());
+        for (const Vertex& vertex : mVertices)
+        {
+            mAABBmin = glm::min(mAABBmin, vertex.position);
+            mAABBmax = glm::max(mAABBmax, vertex.position);
+        }
+
+        // Farthest vertex from the box center, tighter than the half diagonal
+        const glm::vec3 center = (mAABBmin + mAABBmax) * 0.5f;
+        float radiusSq = 0.f;
+        for (const Vertex& vertex : mVertices)
+        {
+            radiusSq = std::max(radiusSq, glm::dot(vertex.position - center, vertex.position - center));
+        }
+        mBoundingRadius = std::sqrt(radiusSq);
+    }
+
+    void IMesh::PackVertices(std::vector<PackedVertex>& outVertices, std::vector<SkinVertex>& outSkin) const
+    {
+        outVertices.resize(mVertices.size());
+        outSkin.resize(mVertices.size());
+
+        const glm::vec3 offset = GetQuantizationOffset();
+        const glm::vec3 inverseScale = 1.f / GetQuantizationScale();
+        bool clampedBones = false;
+
+        for (size_t i = 0; i < mVertices.size(); ++i)
+        {
+            const Vertex& vertex = mVertices[i];
+            PackedVertex& packed = outVertices[i];
+
+            const glm::vec3 position = glm::clamp((vertex.position - offset) * inverseScale, 0.f, 1.f);
+            packed.position = {
+                static_cast<uint16_t>(meshopt_quantizeUnorm(position.x, 16)),
+                static_cast<uint16_t>(meshopt_quantizeUnorm(position.y, 16)),
+                static_cast<uint16_t>(meshopt_quantizeUnorm(position.z, 16)),
+                0 };
+
+            const glm::vec2 normal = OctEncode(vertex.normal);
+            packed.normal = {
+                static_cast<int16_t>(meshopt_quantizeSnorm(normal.x, 16)),
+                static_cast<int16_t>(meshopt_quantizeSnorm(normal.y, 16)) };
+
+            packed.uv = { meshopt_quantizeHalf(vertex.uv.x), meshopt_quantizeHalf(vertex.uv.y) };
+
+            const glm::vec3 color = glm::clamp(vertex.color, 0.f, 1.f);
+            packed.color = {
+                static_cast<uint8_t>(meshopt_quantizeUnorm(color.r, 8)),
+                static_cast<uint8_t>(meshopt_quantizeUnorm(color.g, 8)),
+                static_cast<uint8_t>(meshopt_quantizeUnorm(color.b, 8)),
+                255 };
+
+            // Rounded weights, the error goes to the heaviest influence so they still add up to one
+            SkinVertex& skin = outSkin[i];
+            int total = 0;
+            int heaviest = 0;
+            for (int j = 0; j < Vertex::MAX_BONE_INFLUENCE; ++j)
+            {
+                const int boneID = vertex.boneIDs[j];
+                const bool valid = boneID >= 0 && boneID <= UINT8_MAX && vertex.weights[j] > 0.f;
+                clampedBones |= boneID > UINT8_MAX;
+
+                skin.boneIDs[j] = valid ? static_cast<uint8_t>(boneID) : 0;
+                skin.weights[j] = valid ? static_cast<uint8_t>(meshopt_quantizeUnorm(vertex.weights[j], 8)) : 0;
+                total += skin.weights[j];
+                heaviest = skin.weights[j] > skin.weights[heaviest] ? j : heaviest;
+            }
+            if (total > 0)
+            {
+                skin.weights[heaviest] = static_cast<uint8_t>(std::clamp(skin.weights[heaviest] + UINT8_MAX - total, 0, static_cast<int>(UINT8_MAX)));
+            }
+        }
+
+        if (clampedBones)
+        {
+            RADIS_WARN("Mesh {} uses bone IDs above {}, those influences are dropped", mMeshID, UINT8_MAX);
+        }
+    }
+
+    void IMesh::Optimize()
+    {
+        if (mVertices.empty() || mIndices.empty())
+        {
+            return;
+        }
+
+        const size_t indexCount = mIndices.size();
+        const size_t vertexCount = mVertices.size();
+
+        meshopt_optimizeVertexCache(mIndices.data(), mIndices.data(), indexCount, vertexCount);
+        // Trades up to 5% of the cache efficiency for less overdraw
+        meshopt_optimizeOverdraw(mIndices.data(), mIndices.data(), indexCount, &mVertices[0].position.x, vertexCount, sizeof(Vertex), 1.05f);
+
+        // Also drops vertices no index refers to
+        std::vector<Vertex> vertices(vertexCount);
+        const size_t usedCount = meshopt_optimizeVertexFetch(vertices.data(), mIndices.data(), indexCount, mVertices.data(), vertexCount, sizeof(Vertex));
+        vertices.resize(usedCount);
+        mVertices = std::move(vertices);
+    }
+
+    MeshStatistics IMesh::Analyze() const
+    {
+        MeshStatistics stats;
+        if (mVertices.empty() || mIndices.empty())
+        {
+            return stats;
+        }
+
+        const size_t indexCount = mIndices.size();
+        const size_t vertexCount = mVertices.size();
+
+        // 16 entry FIFO, the usual stand-in for a post-transform cache
+        const meshopt_VertexCacheStatistics cache = meshopt_analyzeVertexCache(mIndices.data(), indexCount, vertexCount, 16, 0, 0);
+        const meshopt_OverdrawStatistics overdraw = meshopt_analyzeOverdraw(mIndices.data(), indexCount, &mVertices[0].position.x, vertexCount, sizeof(Vertex));
+        const meshopt_VertexFetchStatistics fetch = meshopt_analyzeVertexFetch(mIndices.data(), indexCount, vertexCount, sizeof(Vertex));
+
+        stats.acmr = cache.acmr;
+        stats.atvr = cache.atvr;
+        stats.overdraw = overdraw.overdraw;
+        stats.overfetch = fetch.overfetch;
+        return stats;
+    }
+
+    void IMesh::BuildMeshlets(const MeshletSettings& settings)
+    {
+        mMeshlets.clear();
+        if (mVertices.empty() || mIndices.size() < static_cast<size_t>(settings.maxTriangles) * 3 * settings.minMeshlets)
+        {
+            return;
+        }
+
+        const float* positions = &mVertices[0].position.x;
+        const size_t vertexCount = mVertices.size();
+        const size_t maxMeshlets = meshopt_buildMeshletsBound(mIndices.size(), settings.maxVertices, settings.maxTriangles);
+
+        std::vector<meshopt_Meshlet> meshlets(maxMeshlets);
+        std::vector<uint32_t> meshletVertices(maxMeshlets * settings.maxVertices);
+        std::vector<uint8_t> meshletTriangles(maxMeshlets * settings.maxTriangles * 3);
+        const size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), meshletVertices.data(), meshletTriangles.data(),
+            mIndices.data(), mIndices.size(), positions, vertexCount, sizeof(Vertex), settings.maxVertices, settings.maxTriangles, settings.coneWeight);
+
+        if (meshletCount < settings.minMeshlets)
+        {
+            return;
+        }
+
+        // Back to plain indices, one range per meshlet, so the existing index buffer path can draw them
+        std::vector<uint32_t> indices;
+        indices.reserve(mIndices.size());
+        mMeshlets.reserve(meshletCount);
+        for (size_t i = 0; i < meshletCount; ++i)
+        {
+            const meshopt_Meshlet& source = meshlets[i];
+            uint32_t* localVertices = &meshletVertices[source.vertex_offset];
+            uint8_t* localTriangles = &meshletTriangles[source.triangle_offset];
+            meshopt_optimizeMeshlet(localVertices, localTriangles, source.triangle_count, source.vertex_count);
+
+            const meshopt_Bounds bounds = meshopt_computeMeshletBounds(localVertices, localTriangles, source.triangle_count,
+                positions, vertexCount, sizeof(Vertex));
+
+            Meshlet meshlet;
+            meshlet.firstIndex = static_cast<uint32_t>(indices.size());
+            meshlet.indexCount = source.triangle_count * 3;
+            meshlet.center = glm::vec3(bounds.center[0], bounds.center[1], bounds.center[2]);
+            meshlet.radius = bounds.radius;
+            meshlet.coneApex = glm::vec3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+            meshlet.coneAxis = glm::vec3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+            meshlet.coneCutoff = bounds.cone_cutoff;
+            mMeshlets.push_back(meshlet);
+
+            for (uint32_t index = 0; index < meshlet.indexCount; ++index)
+            {
+                indices.push_back(localVertices[localTriangles[index]]);
+            }
+        }
+
+        mIndices = std::move(indices);
+    }
+
+    void IMesh::GenerateLODs(const MeshLODSettings& settings)
+    {
+        mLODs.clear();
+        if (mVertices.empty() || mIndices.size() < settings.minIndexCount)
+        {
+            return;
+        }
+
+        const float* positions = &mVertices[0].position.x;
+        const size_t vertexCount = mVertices.size();
+        const float scale = meshopt_simplifyScale(positions, vertexCount, sizeof(Vertex));
+
+        size_t previousCount = mIndices.size();
+        for (uint32_t lod = 1; lod < MeshLODSettings::MAX_LODS; ++lod)
+        {
+            const size_t targetCount = static_cast<size_t>(previousCount * settings.indexRatio) / 3 * 3;
+            if (targetCount < settings.minIndexCount)
+            {
+                break;
+            }
+
+            // Always simplified from the full mesh so the error is against what LOD 0 shows
+            MeshLOD meshLOD;
+            meshLOD.indices.resize(mIndices.size());
+            float error = 0.f;
+            const size_t indexCount = meshopt_simplify(meshLOD.indices.data(), mIndices.data(), mIndices.size(),
+                positions, vertexCount, sizeof(Vertex), targetCount, settings.maxError[lod - 1], 0, &error);
+
+            if (indexCount == 0 || indexCount > previousCount * settings.minReduction)
+            {
+                break;
+            }
+
+            meshLOD.indices.resize(indexCount);
+            meshLOD.indices.shrink_to_fit();
+            meshopt_optimizeVertexCache(meshLOD.indices.data(), meshLOD.indices.data(), indexCount, vertexCount);
+            // Kept monotonic so selection can stop at the first LOD that is too coarse
+            meshLOD.error = std::max(error * scale, mLODs.empty() ? 0.f : mLODs.back().error);
+            mLODs.push_back(std::move(meshLOD));
+            previousCount = indexCount;
+        }
+    }
+
+    std::unique_ptr<IMesh> IMesh::Create(bool assignID)
+    {
+        switch (Engine::GetGraphicsAPI())
+        {
+        case GraphicsAPI::Vulkan:
+            return std::make_unique<VKMesh>(assignID);
+        case GraphicsAPI::OpenGL:
+            return std::make_unique<GLMesh>(assignID);
+        default:
+            return std::make_unique<HeadlessMesh>(assignID);
+        }
+    }
 }
@@ -19,10 +19,98 @@ namespace Radis
         std::array<int, MAX_BONE_INFLUENCE> boneIDs = { -1, -1, -1, -1 };
         std::array<float, MAX_BONE_INFLUENCE> weights = { 0.0f, 0.0f, 0.0f, 0.0f };
 
+        void SetBoneData(int boneID, float weight);
+    };
+
+    // What the unified geometry arena stores per vertex, in two streams. Vertex stays the import
+    // and .dm format, meshes are packed on their way into the arena (see IMesh::PackVertices).
+
+    // Static stream, binding 0. Positions are unorm16 inside the mesh's AABB and get scaled back
+    // by the instance's positionOffset/positionScale, normals are octahedral snorm16.
+    struct PackedVertex
+    {
+        std::array<uint16_t, 4> position; // xyz, w unused
+        std::array<int16_t, 2> normal;
+        std::array<uint16_t, 2> uv;       // half floats
+        std::array<uint8_t, 4> color;     // rgb unorm8, a unused
+
         static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
         static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
+    };
 
-        void SetBoneData(int boneID, float weight);
+    // Skinning stream, binding 1. Unused influences have weight 0, weights add up to 255.
+    struct SkinVertex
+    {
+        std::array<uint8_t, Vertex::MAX_BONE_INFLUENCE> boneIDs;
+        std::array<uint8_t, Vertex::MAX_BONE_INFLUENCE> weights; // unorm8
+    };
+
+    static_assert(sizeof(PackedVertex) == 20 && sizeof(SkinVertex) == 8, "Arena vertex streams must match the shaders");
+
+    // One mesh's data going into a range of an arena mesh (see IMesh::UploadRanges)
+    struct MeshRangeUpload
+    {
+        const PackedVertex* vertices;
+        const SkinVertex* skin;
+        uint32_t vertexCount;
+        uint32_t firstVertex;
+        const uint32_t* indices;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+    };
+
+    // Import-time simplification targets for IMesh::GenerateLODs
+    struct MeshLODSettings
+    {
+        static constexpr uint32_t MAX_LODS = 5; // LOD 0, the full mesh, included
+
+        // Each LOD aims for indexRatio of the previous one's indices but stops early rather than
+        // deviate from the full mesh by more than its maxError (relative to the mesh extent).
+        float indexRatio = 0.5f;
+        std::array<float, MAX_LODS - 1> maxError = { 0.002f, 0.005f, 0.01f, 0.02f };
+        // A LOD that keeps more than this much of the previous one isn't worth its indices, the chain ends there
+        float minReduction = 0.85f;
+        uint32_t minIndexCount = 192;
+    };
+
+    // How well a mesh's buffers suit the GPU, from meshoptimizer's analyzers (see IMesh::Analyze)
+    struct MeshStatistics
+    {
+        float acmr = 0.f;      // vertices transformed per triangle, 0.5 at best
+        float atvr = 0.f;      // vertices transformed per vertex, 1.0 at best
+        float overdraw = 0.f;  // pixels shaded per pixel covered, 1.0 at best
+        float overfetch = 0.f; // vertex bytes fetched per vertex buffer byte, 1.0 at best
+    };
+
+    // Import-time cluster limits for IMesh::BuildMeshlets, within common mesh shader output limits
+    struct MeshletSettings
+    {
+        uint32_t maxVertices = 64;
+        uint32_t maxTriangles = 124; // multiple of 4, meshoptimizer's limit
+        // How much the builder favours tight normal cones (backface rejection) over tight spheres
+        float coneWeight = 0.25f;
+        // Meshes that would split into fewer clusters aren't worth culling per cluster
+        uint32_t minMeshlets = 8;
+    };
+
+    // A cluster of LOD 0 triangles, stored as a contiguous index range with its culling bounds
+    struct Meshlet
+    {
+        uint32_t firstIndex = 0; // into mIndices
+        uint32_t indexCount = 0;
+        glm::vec3 center{ 0.f };
+        float radius = 0.f;
+        // Every triangle faces away from a viewer for which dot(normalize(apex - eye), axis) >= cutoff
+        glm::vec3 coneApex{ 0.f };
+        glm::vec3 coneAxis{ 0.f };
+        float coneCutoff = 1.f;
+    };
+
+    // A simplified index list over the mesh's own vertices
+    struct MeshLOD
+    {
+        std::vector<uint32_t> indices;
+        float error = 0.f; // object-space distance to the full mesh surface
     };
 
     class IMesh
@@ -31,21 +119,50 @@ namespace Radis
         IMesh(bool assignID = true);
         virtual ~IMesh() = default;
 
+        // Mesh implementation for the active graphics API
+        static std::unique_ptr<IMesh> Create(bool assignID = true);
+
         virtual void CreateVertexBuffers(Device* device) = 0;
         virtual void CreateIndexBuffers(Device* device) = 0;
         virtual void DestroyBuffers() = 0;
 
+        // Arena use (the unified mesh): fixed-capacity buffers that get filled a range at a time
+        // instead of being built from mVertices/mIndices. Growing keeps the uploaded contents.
+        virtual void ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity) = 0;
+        // Copies every range in one go, the buffers must already be big enough
+        virtual void UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads) = 0;
+
         virtual void Bind(VkCommandBuffer commandBuffer = nullptr) = 0;
         virtual void Draw(VkCommandBuffer commandBuffer, uint32_t baseIndex = 0) = 0;
 
         uint32_t GetID() const { return mMeshID; }
 
+        // Fills the bounds below from mVertices. Called once the vertices are loaded.
+        void ComputeBounds();
+
+        // Arena streams for mVertices, quantized against the current bounds
+        void PackVertices(std::vector<PackedVertex>& outVertices, std::vector<SkinVertex>& outSkin) const;
+        // Maps unorm16 arena positions back to mesh space: offset + position * scale
+        glm::vec3 GetQuantizationOffset() const { return mAABBmin; }
+        glm::vec3 GetQuantizationScale() const { return glm::max(mAABBmax - mAABBmin, glm::vec3(1e-6f)); }
+        // Reorders mIndices for the post-transform cache and overdraw, then mVertices into the order
+        // the indices first use them. Import time only, before GenerateLODs.
+        void Optimize();
+        MeshStatistics Analyze() const;
+        // Splits mIndices into clusters and rewrites it in cluster order so each Meshlet is one
+        // index range. Import time only, after Optimize; leaves mMeshlets empty for small meshes.
+        void BuildMeshlets(const MeshletSettings& settings = {});
+        // Fills mLODs from mVertices/mIndices with meshoptimizer, called before the mesh is uploaded
+        void GenerateLODs(const MeshLODSettings& settings = {});
+
     public:
         // Buffers
         bool mHasIndexBuffer = false;
         uint32_t mTriangleCount = 0;
         uint32_t mVertexCount = 0;
         uint32_t mIndexCount = 0;
+        uint32_t mVertexCapacity = 0; // arena meshes only
+        uint32_t mIndexCapacity = 0;
 
         Buffer mVertexBuffer;
         Buffer mIndexBuffer;
@@ -54,10 +171,17 @@ namespace Radis
         // Mesh data
         std::vector<Vertex> mVertices{};
         std::vector<uint32_t> mIndices{};
+        std::vector<MeshLOD> mLODs{}; // LOD 1 onward, coarsest last. LOD 0 is mIndices.
+        std::vector<Meshlet> mMeshlets{}; // LOD 0 clusters, covering mIndices in order
 
         // Unique mesh index
         uint32_t mMeshID = 0;
 
+        // Local-space bounds, the sphere is centered on the AABB
+        glm::vec3 mAABBmin{ 0.f };
+        glm::vec3 mAABBmax{ 0.f };
+        float mBoundingRadius = 0.f;
+
         // Tex data if from memory
         std::vector<unsigned char> mAlbedoTextureData{};
         std::vector<unsigned char> mNormalTextureData{};
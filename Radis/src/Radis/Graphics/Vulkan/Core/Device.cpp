@@ -370,6 +370,9 @@ namespace Radis
         REQUEST_FEATURE(vulkan12Features, supported12, bufferDeviceAddress);
         REQUEST_FEATURE(vulkan12Features, supported12, bufferDeviceAddressCaptureReplay);
         REQUEST_FEATURE(vulkan12Features, supported12, timelineSemaphore);
+        // Optional, only the Hi-Z occlusion culling needs it
+        vulkan12Features.samplerFilterMinmax = supported12.samplerFilterMinmax;
+        mSupportsSamplerFilterMinmax = supported12.samplerFilterMinmax;
 
         VkPhysicalDeviceVulkan11Features vulkan11Features = {};
         vulkan11Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES;
@@ -467,7 +470,9 @@ namespace Radis
         vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
 
         // Check for specific feature support
-        if (!supportedFeatures.drawIndirectCount) {
+        mSupportsDrawIndirectCount = supportedFeatures.drawIndirectCount;
+        mSupportsMultiDrawIndirect = features2.features.multiDrawIndirect;
+        if (!mSupportsDrawIndirectCount) {
             RADIS_ERROR("drawIndirectCount is not supported on this GPU!");
         }
     }
@@ -74,6 +74,9 @@ namespace Radis {
         void EndDebugLabel(VkCommandBuffer commandBuffer);
 
         bool SupportsVulkan() const { return mSupportsVulkan; }
+        bool SupportsDrawIndirectCount() const { return mSupportsDrawIndirectCount; }
+        bool SupportsMultiDrawIndirect() const { return mSupportsMultiDrawIndirect; }
+        bool SupportsSamplerFilterMinmax() const { return mSupportsSamplerFilterMinmax; }
 
     private:
         void createInstance();
@@ -127,6 +130,9 @@ namespace Radis {
         VkPhysicalDeviceAccelerationStructurePropertiesKHR mAsProperties{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR };
 
         bool mSupportsVulkan = true;
+        bool mSupportsDrawIndirectCount = false;
+        bool mSupportsMultiDrawIndirect = false;
+        bool mSupportsSamplerFilterMinmax = false;
         bool mRTFuncsAvailable = true;
         bool mDebugFuncsAvailable = true;
     };
@@ -0,0 +1,437 @@
+#include <PCH/pch.h>
+#include "OcclusionCuller.h"
+
+#include "Core/Device.h"
+#include "Core/Allocator.h"
+#include "Core/SwapChain.h"
+#include "Pipeline/ComputePipeline.h"
+#include "Uniform/Descriptors.h"
+
+namespace Radis
+{
+    namespace
+    {
+        struct BuildPushConstants
+        {
+            glm::vec2 dstSize;
+            glm::vec2 srcSize;
+        };
+
+        struct CullPushConstants
+        {
+            glm::mat4 projectionView;
+            glm::vec2 hizSize;
+            uint32_t instanceCount;
+            uint32_t visibleSlotOffset;
+            uint32_t useHiZ;
+        };
+
+        // Largest power of two below value, so each level 0 texel covers more than one and at
+        // most two depth texels per axis (exactly two for power of two targets).
+        uint32_t PyramidSize(uint32_t value)
+        {
+            uint32_t result = 1;
+            while (result * 2 < value) result *= 2;
+            return result;
+        }
+
+        constexpr uint32_t BUILD_GROUP_SIZE = 16;
+        constexpr uint32_t CULL_GROUP_SIZE = 64;
+    }
+
+    OcclusionCuller::OcclusionCuller(Device& device)
+        : mDevice(device)
+    {
+        mSupported = device.SupportsDrawIndirectCount() && device.SupportsSamplerFilterMinmax();
+        if (!mSupported)
+        {
+            RADIS_WARN("GPU occlusion culling needs drawIndirectCount and samplerFilterMinmax, falling back to frustum culling only");
+            return;
+        }
+
+        // Linear filtering with a MAX reduction returns the farthest of the 2x2 texels under a tap
+        VkSamplerReductionModeCreateInfo reductionInfo{};
+        reductionInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO;
+        reductionInfo.reductionMode = VK_SAMPLER_REDUCTION_MODE_MAX;
+
+        VkSamplerCreateInfo samplerInfo{};
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.pNext = &reductionInfo;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+        if (vkCreateSampler(device.GetDevice(), &samplerInfo, nullptr, &mMaxSampler) != VK_SUCCESS)
+        {
+            RADIS_CRITICAL("Failed to create Hi-Z sampler");
+        }
+
+        mBuildSetLayout = DescriptorSetLayout::Builder(device)
+            .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Build();
+
+        mCullSetLayout = DescriptorSetLayout::Builder(device)
+            .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .AddBinding(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .AddBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+            .Build();
+
+        mDescriptorPool = DescriptorPool::Builder(device)
+            .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_LEVELS + SwapChain::MAX_FRAMES_IN_FLIGHT)
+            .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_LEVELS)
+            .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * SwapChain::MAX_FRAMES_IN_FLIGHT)
+            .SetMaxSets(MAX_LEVELS + SwapChain::MAX_FRAMES_IN_FLIGHT)
+            .SetPoolFlags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+            .Build();
+
+        mBuildPipeline = std::make_unique<ComputePipeline>(device, "hiz_build.comp", std::vector<VkDescriptorSetLayout>{ mBuildSetLayout->GetDescriptorSetLayout() }, static_cast<uint32_t>(sizeof(BuildPushConstants)));
+        mCullPipeline = std::make_unique<ComputePipeline>(device, "occlusion_cull.comp", std::vector<VkDescriptorSetLayout>{ mCullSetLayout->GetDescriptorSetLayout() }, static_cast<uint32_t>(sizeof(CullPushConstants)));
+
+        mCullInputBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+        mVisibilityBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+        mCullSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+        mCullCapacity.resize(SwapChain::MAX_FRAMES_IN_FLIGHT, 0);
+        mLastCullCount.resize(SwapChain::MAX_FRAMES_IN_FLIGHT, 0);
+        for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
+        {
+            CreateCullBuffers(i, INITIAL_CULL_CAPACITY);
+            mDescriptorPool->AllocateDescriptor(mCullSetLayout->GetDescriptorSetLayout(), mCullSets[i]);
+        }
+    }
+
+    OcclusionCuller::~OcclusionCuller()
+    {
+        if (!mSupported)
+        {
+            return;
+        }
+
+        DestroyPyramid();
+
+        for (Buffer& buffer : mCullInputBuffers) Allocator::DestroyBuffer(buffer);
+        for (Buffer& buffer : mVisibilityBuffers) Allocator::DestroyBuffer(buffer);
+
+        mBuildPipeline.reset();
+        mCullPipeline.reset();
+        mDescriptorPool.reset();
+        mBuildSetLayout.reset();
+        mCullSetLayout.reset();
+        vkDestroySampler(mDevice.GetDevice(), mMaxSampler, nullptr);
+    }
+
+    OcclusionCuller::CullInstance* OcclusionCuller::BeginCullInstances(uint32_t frameIndex, uint32_t count)
+    {
+        if (count > mCullCapacity[frameIndex])
+        {
+            uint32_t capacity = mCullCapacity[frameIndex];
+            while (capacity < count)
+            {
+                capacity *= 2;
+            }
+
+            // This frame's fence has been waited on, nothing uses the old buffers anymore. Cull
+            // rewrites the set every frame.
+            RADIS_INFO("Growing occlusion cull buffers of frame {} to {} instances", frameIndex, capacity);
+            Allocator::DestroyBuffer(mCullInputBuffers[frameIndex]);
+            Allocator::DestroyBuffer(mVisibilityBuffers[frameIndex]);
+            CreateCullBuffers(frameIndex, capacity);
+            mLastCullCount[frameIndex] = 0;
+        }
+        return reinterpret_cast<CullInstance*>(mCullInputBuffers[frameIndex].mapping);
+    }
+
+    void OcclusionCuller::CreateCullBuffers(uint32_t frameIndex, uint32_t capacity)
+    {
+        Allocator::CreateBuffer(
+            mCullInputBuffers[frameIndex],
+            sizeof(CullInstance) * capacity,
+            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        );
+        Allocator::SetAllocationName(mCullInputBuffers[frameIndex].allocation, "Occlusion Cull Input");
+
+        // Read back by the CPU for the debug view
+        Allocator::CreateBuffer(
+            mVisibilityBuffers[frameIndex],
+            sizeof(uint32_t) * capacity,
+            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        );
+        Allocator::SetAllocationName(mVisibilityBuffers[frameIndex].allocation, "Occlusion Visibility");
+
+        mCullCapacity[frameIndex] = capacity;
+    }
+
+    void OcclusionCuller::Prepare(VkImageView depthView, VkExtent2D depthExtent)
+    {
+        if (!mSupported)
+        {
+            return;
+        }
+
+        const VkExtent2D pyramidExtent{ PyramidSize(depthExtent.width), PyramidSize(depthExtent.height) };
+        if (depthView == mSourceDepthView && pyramidExtent.width == mPyramidExtent.width && pyramidExtent.height == mPyramidExtent.height)
+        {
+            return;
+        }
+
+        // Frames in flight still sample the old pyramid
+        vkDeviceWaitIdle(mDevice.GetDevice());
+        DestroyPyramid();
+        CreatePyramid(depthView, depthExtent);
+    }
+
+    void OcclusionCuller::CreatePyramid(VkImageView depthView, VkExtent2D depthExtent)
+    {
+        // Power of two levels so each texel covers exactly 2x2 texels of the level above. Level 0
+        // covers up to 3x3 depth texels, hiz_build.comp reduces those explicitly.
+        mPyramidExtent = { PyramidSize(depthExtent.width), PyramidSize(depthExtent.height) };
+        mSourceExtent = depthExtent;
+        mLevelCount = 1;
+        while (mLevelCount < MAX_LEVELS && (std::max(mPyramidExtent.width, mPyramidExtent.height) >> mLevelCount) > 0) ++mLevelCount;
+        mSourceDepthView = depthView;
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R32_SFLOAT;
+        imageInfo.extent = { mPyramidExtent.width, mPyramidExtent.height, 1 };
+        imageInfo.mipLevels = mLevelCount;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        Allocator::CreateImageWithInfo(imageInfo, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, mPyramid, mPyramidAllocation);
+        Allocator::SetAllocationName(mPyramidAllocation, "Hi-Z Pyramid");
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = mPyramid;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = VK_FORMAT_R32_SFLOAT;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = mLevelCount;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(mDevice.GetDevice(), &viewInfo, nullptr, &mPyramidView) != VK_SUCCESS)
+        {
+            RADIS_CRITICAL("Failed to create Hi-Z pyramid view");
+        }
+
+        mLevelViews.resize(mLevelCount, VK_NULL_HANDLE);
+        mBuildSets.resize(mLevelCount, VK_NULL_HANDLE);
+        for (uint32_t level = 0; level < mLevelCount; ++level)
+        {
+            viewInfo.subresourceRange.baseMipLevel = level;
+            viewInfo.subresourceRange.levelCount = 1;
+            if (vkCreateImageView(mDevice.GetDevice(), &viewInfo, nullptr, &mLevelViews[level]) != VK_SUCCESS)
+            {
+                RADIS_CRITICAL("Failed to create Hi-Z level view");
+            }
+
+            VkDescriptorImageInfo srcInfo{};
+            srcInfo.sampler = mMaxSampler;
+            srcInfo.imageView = level == 0 ? depthView : mLevelViews[level - 1];
+            srcInfo.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+            VkDescriptorImageInfo dstInfo{};
+            dstInfo.imageView = mLevelViews[level];
+            dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            DescriptorWriter(*mBuildSetLayout, *mDescriptorPool)
+                .WriteImage(0, &srcInfo)
+                .WriteImage(1, &dstInfo)
+                .Build(mBuildSets[level]);
+        }
+
+        mPyramidInitialized = false;
+        mHistoryValid = false;
+    }
+
+    void OcclusionCuller::DestroyPyramid()
+    {
+        if (!mBuildSets.empty())
+        {
+            mDescriptorPool->FreeDescriptors(mBuildSets);
+            mBuildSets.clear();
+        }
+        for (VkImageView view : mLevelViews)
+        {
+            vkDestroyImageView(mDevice.GetDevice(), view, nullptr);
+        }
+        mLevelViews.clear();
+        if (mPyramidView != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(mDevice.GetDevice(), mPyramidView, nullptr);
+            mPyramidView = VK_NULL_HANDLE;
+        }
+        if (mPyramid != VK_NULL_HANDLE)
+        {
+            vmaDestroyImage(Allocator::GetAllocator(), mPyramid, mPyramidAllocation);
+            mPyramid = VK_NULL_HANDLE;
+            mPyramidAllocation = VK_NULL_HANDLE;
+        }
+        mPyramidExtent = { 0, 0 };
+        mSourceExtent = { 0, 0 };
+        mLevelCount = 0;
+        mSourceDepthView = VK_NULL_HANDLE;
+        mHistoryValid = false;
+    }
+
+    void OcclusionCuller::Cull(VkCommandBuffer cmd, uint32_t frameIndex, const Buffer& indirectBuffer, const Buffer& visibleSlotBuffer, uint32_t visibleSlotOffset, uint32_t instanceCount)
+    {
+        mLastCullCount[frameIndex] = instanceCount;
+        if (!mSupported || instanceCount == 0)
+        {
+            return;
+        }
+
+        RADIS_ASSERT(instanceCount <= mCullCapacity[frameIndex], "Cull input wasn't sized with BeginCullInstances");
+
+        RADIS_ASSERT(mPyramid != VK_NULL_HANDLE, "OcclusionCuller::Prepare must run before Cull");
+
+        // The pyramid is bound even without history (the shader doesn't sample it then), a null
+        // view would need robustness2's nullDescriptor. It has to be out of UNDEFINED for that.
+        if (!mPyramidInitialized)
+        {
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barrier.srcAccessMask = VK_ACCESS_2_NONE;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_NONE;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = mPyramid;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mLevelCount, 0, 1 };
+
+            VkDependencyInfo dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.imageMemoryBarrierCount = 1;
+            dependencyInfo.pImageMemoryBarriers = &barrier;
+            vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+            mPyramidInitialized = true;
+        }
+
+        // This frame's fence has been waited on, the set isn't in use anymore
+        VkDescriptorBufferInfo inputInfo{ mCullInputBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+        VkDescriptorBufferInfo commandsInfo{ indirectBuffer.buffer, 0, VK_WHOLE_SIZE };
+        VkDescriptorBufferInfo visibilityInfo{ mVisibilityBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE };
+        VkDescriptorImageInfo hizInfo{ mMaxSampler, mPyramidView, VK_IMAGE_LAYOUT_GENERAL };
+        VkDescriptorBufferInfo visibleSlotsInfo{ visibleSlotBuffer.buffer, 0, VK_WHOLE_SIZE };
+        DescriptorWriter(*mCullSetLayout, *mDescriptorPool)
+            .WriteBuffer(0, &inputInfo)
+            .WriteBuffer(1, &commandsInfo)
+            .WriteBuffer(2, &visibilityInfo)
+            .WriteImage(3, &hizInfo)
+            .WriteBuffer(4, &visibleSlotsInfo)
+            .Overwrite(mCullSets[frameIndex]);
+
+        CullPushConstants push{};
+        push.projectionView = mHistoryProjectionView;
+        push.hizSize = glm::vec2(static_cast<float>(mPyramidExtent.width), static_cast<float>(mPyramidExtent.height));
+        push.instanceCount = instanceCount;
+        push.visibleSlotOffset = visibleSlotOffset / sizeof(uint32_t);
+        push.useHiZ = mHistoryValid ? 1 : 0;
+
+        mCullPipeline->Bind(cmd);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, mCullPipeline->GetLayout(), 0, 1, &mCullSets[frameIndex], 0, nullptr);
+        vkCmdPushConstants(cmd, mCullPipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+        vkCmdDispatch(cmd, (instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+        // Commands are consumed by the scene draw, the slots by its vertex shader and visibility is
+        // read back by the CPU
+        VkMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_HOST_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_HOST_READ_BIT;
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.memoryBarrierCount = 1;
+        dependencyInfo.pMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+    }
+
+    void OcclusionCuller::BuildHiZ(VkCommandBuffer cmd, const glm::mat4& projectionView)
+    {
+        if (!mSupported || mPyramid == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        // The pyramid goes to GENERAL once, after that only the previous frame's cull reads have
+        // to finish before it is overwritten
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        barrier.oldLayout = mPyramidInitialized ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = mPyramid;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mLevelCount, 0, 1 };
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = 1;
+        dependencyInfo.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+        mPyramidInitialized = true;
+
+        mBuildPipeline->Bind(cmd);
+        glm::vec2 srcSize(static_cast<float>(mSourceExtent.width), static_cast<float>(mSourceExtent.height));
+        for (uint32_t level = 0; level < mLevelCount; ++level)
+        {
+            const uint32_t width = std::max(1u, mPyramidExtent.width >> level);
+            const uint32_t height = std::max(1u, mPyramidExtent.height >> level);
+
+            BuildPushConstants push{ glm::vec2(static_cast<float>(width), static_cast<float>(height)), srcSize };
+            srcSize = push.dstSize;
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, mBuildPipeline->GetLayout(), 0, 1, &mBuildSets[level], 0, nullptr);
+            vkCmdPushConstants(cmd, mBuildPipeline->GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+            vkCmdDispatch(cmd, (width + BUILD_GROUP_SIZE - 1) / BUILD_GROUP_SIZE, (height + BUILD_GROUP_SIZE - 1) / BUILD_GROUP_SIZE, 1);
+
+            // The next level (and next frame's cull after the last one) samples this one
+            VkImageMemoryBarrier2 levelBarrier{};
+            levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            levelBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            levelBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+            levelBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            levelBarrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+            levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.image = mPyramid;
+            levelBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1 };
+
+            VkDependencyInfo levelDependency{};
+            levelDependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            levelDependency.imageMemoryBarrierCount = 1;
+            levelDependency.pImageMemoryBarriers = &levelBarrier;
+            vkCmdPipelineBarrier2(cmd, &levelDependency);
+        }
+
+        mHistoryProjectionView = projectionView;
+        mHistoryValid = true;
+    }
+}
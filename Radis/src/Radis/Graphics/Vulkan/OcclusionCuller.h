@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Core/Buffer.h"
+#include "Uniform/ShaderTypes.h"
+
+namespace Radis
+{
+    class Device;
+    class ComputePipeline;
+    class DescriptorSetLayout;
+    class DescriptorPool;
+
+    // GPU occlusion culling against a Hi-Z depth pyramid built from the previous frame's depth.
+    // The CPU fills one CullInstance per frustum visible instance, Cull() compacts the survivors
+    // into the instanced draw command of their mesh LOD and BuildHiZ() reduces this frame's depth
+    // for the next one. Both are recorded from render graph passes.
+    class OcclusionCuller
+    {
+    public:
+        // Matches CullInstance in occlusion_cull.comp
+        struct CullInstance
+        {
+            glm::vec4 centerRadius;  // world space, w unused
+            glm::vec4 extents;       // world space AABB half extents, w unused
+            uint32_t command;        // index of its draw command in the indirect buffer
+            uint32_t slot;           // in the instance table
+            uint32_t flags;
+            uint32_t _pad;
+        };
+        static constexpr uint32_t CULL_ALWAYS_VISIBLE = 1;
+        static constexpr uint32_t INITIAL_CULL_CAPACITY = InstanceUniforms::MAX_INSTANCES;
+
+        OcclusionCuller(Device& device);
+        ~OcclusionCuller();
+
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+        bool IsSupported() const { return mSupported; }
+
+        // Recreates the pyramid when the depth target changed (resize). Call before recording
+        // the frame, it waits for the device when it has to recreate.
+        void Prepare(VkImageView depthView, VkExtent2D depthExtent);
+
+        // Mapped cull input for this frame slot with room for count entries, filled by the CPU before
+        // Cull is recorded. Grows the slot's buffers when they are too small, which drops the
+        // results of its last submission, so read those first.
+        CullInstance* BeginCullInstances(uint32_t frameIndex, uint32_t count);
+        // Cull input of the last submission of this frame slot
+        const CullInstance* GetCullInstances(uint32_t frameIndex) const { return reinterpret_cast<const CullInstance*>(mCullInputBuffers[frameIndex].mapping); }
+        // Results of the last submission of this frame slot, one entry per instance of its cull input.
+        // Only valid once that frame's fence has been waited on.
+        const uint32_t* GetVisibility(uint32_t frameIndex) const { return reinterpret_cast<const uint32_t*>(mVisibilityBuffers[frameIndex].mapping); }
+        uint32_t GetLastCullCount(uint32_t frameIndex) const { return mLastCullCount[frameIndex]; }
+
+        // Adds each visible instance to its command in indirectBuffer (count at offset 0, commands
+        // at 16) and writes its slot to visibleSlotBuffer at visibleSlotOffset (bytes) + the
+        // command's firstInstance + its index in the command.
+        void Cull(VkCommandBuffer cmd, uint32_t frameIndex, const Buffer& indirectBuffer, const Buffer& visibleSlotBuffer, uint32_t visibleSlotOffset, uint32_t instanceCount);
+
+        // Expects the depth image in DEPTH_STENCIL_READ_ONLY_OPTIMAL and visible to compute, the
+        // render graph transitions it for the pass that records this. projectionView is the matrix
+        // that depth was rendered with.
+        void BuildHiZ(VkCommandBuffer cmd, const glm::mat4& projectionView);
+
+    private:
+        void CreateCullBuffers(uint32_t frameIndex, uint32_t capacity);
+        void CreatePyramid(VkImageView depthView, VkExtent2D depthExtent);
+        void DestroyPyramid();
+
+        Device& mDevice;
+        bool mSupported = false;
+
+        std::unique_ptr<ComputePipeline> mBuildPipeline;
+        std::unique_ptr<ComputePipeline> mCullPipeline;
+        std::unique_ptr<DescriptorSetLayout> mBuildSetLayout;
+        std::unique_ptr<DescriptorSetLayout> mCullSetLayout;
+        std::unique_ptr<DescriptorPool> mDescriptorPool;
+        VkSampler mMaxSampler = VK_NULL_HANDLE;
+
+        // Pyramid, shared by every frame in flight since submissions on the queue are ordered
+        static constexpr uint32_t MAX_LEVELS = 16;
+        VkImage mPyramid = VK_NULL_HANDLE;
+        VmaAllocation mPyramidAllocation = VK_NULL_HANDLE;
+        VkImageView mPyramidView = VK_NULL_HANDLE;   // every level, sampled by the cull
+        std::vector<VkImageView> mLevelViews;         // one per level, build targets
+        std::vector<VkDescriptorSet> mBuildSets;      // level i reads level i - 1 (depth for 0)
+        VkExtent2D mPyramidExtent{ 0, 0 };
+        VkExtent2D mSourceExtent{ 0, 0 };             // depth target the pyramid is built from
+        uint32_t mLevelCount = 0;
+        VkImageView mSourceDepthView = VK_NULL_HANDLE;
+        bool mPyramidInitialized = false;             // moved out of UNDEFINED
+        bool mHistoryValid = false;                   // built at least once since creation
+        glm::mat4 mHistoryProjectionView{ 1.0f };
+
+        std::vector<Buffer> mCullInputBuffers;
+        std::vector<Buffer> mVisibilityBuffers;
+        std::vector<VkDescriptorSet> mCullSets;
+        std::vector<uint32_t> mCullCapacity;
+        std::vector<uint32_t> mLastCullCount;
+    };
+}
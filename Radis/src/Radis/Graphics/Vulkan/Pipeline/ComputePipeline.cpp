@@ -0,0 +1,73 @@
+#include <PCH/pch.h>
+#include "ComputePipeline.h"
+#include "Pipeline.h"
+#include "VKShader.h"
+
+#include "../Core/Device.h"
+
+namespace Radis
+{
+	ComputePipeline::ComputePipeline(Device& device, const std::string& compFile, const std::vector<VkDescriptorSetLayout>& setLayouts, uint32_t pushConstantSize)
+		: device(device)
+	{
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = pushConstantSize;
+
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+		pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		pipelineLayoutCreateInfo.pSetLayouts = setLayouts.data();
+		pipelineLayoutCreateInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+		pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantSize > 0 ? &pushConstantRange : nullptr;
+
+		if (vkCreatePipelineLayout(device.GetDevice(), &pipelineLayoutCreateInfo, nullptr, &mPipelineLayout) != VK_SUCCESS)
+		{
+			RADIS_CRITICAL("Failed to create compute pipeline layout");
+		}
+
+		// Read code file
+		std::ifstream compSPVFile(Pipeline::SpvDir + compFile + ".spv", std::ios::binary);
+		if (!compSPVFile.is_open())
+		{
+			RADIS_CRITICAL("Failed to open compute shader {}", compFile);
+			return;
+		}
+
+		compSPVFile.seekg(0, std::ios::end);
+		size_t compSPVFileSize = compSPVFile.tellg();
+		compSPVFile.seekg(0, std::ios::beg);
+
+		std::vector<uint32_t> compShaderSPV(compSPVFileSize / sizeof(uint32_t));
+		compSPVFile.read(reinterpret_cast<char*>(compShaderSPV.data()), compSPVFileSize);
+		compSPVFile.close();
+
+		Shader::CreateShaderModule(device, compShaderSPV, &mCompShaderModule);
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = mCompShaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = mPipelineLayout;
+
+		if (vkCreateComputePipelines(device.GetDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &mComputePipeline) != VK_SUCCESS)
+		{
+			RADIS_CRITICAL("Failed to create compute pipeline {}", compFile);
+		}
+	}
+
+	ComputePipeline::~ComputePipeline()
+	{
+		vkDestroyShaderModule(device.GetDevice(), mCompShaderModule, nullptr);
+		vkDestroyPipeline(device.GetDevice(), mComputePipeline, nullptr);
+		vkDestroyPipelineLayout(device.GetDevice(), mPipelineLayout, nullptr);
+	}
+
+	void ComputePipeline::Bind(VkCommandBuffer commandBuffer)
+	{
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline);
+	}
+}
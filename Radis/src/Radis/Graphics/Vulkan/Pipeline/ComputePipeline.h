@@ -0,0 +1,27 @@
+#pragma once
+
+namespace Radis
+{
+	class Device;
+
+	// Single compute shader with its layout. Descriptor sets are owned by the caller.
+	class ComputePipeline
+	{
+	public:
+		ComputePipeline(Device& device, const std::string& compFile, const std::vector<VkDescriptorSetLayout>& setLayouts, uint32_t pushConstantSize = 0);
+		~ComputePipeline();
+
+		ComputePipeline(const ComputePipeline&) = delete;
+		ComputePipeline& operator=(const ComputePipeline&) = delete;
+
+		void Bind(VkCommandBuffer commandBuffer);
+
+		VkPipelineLayout GetLayout() const { return mPipelineLayout; }
+
+	private:
+		Device& device;
+		VkPipeline mComputePipeline = VK_NULL_HANDLE;
+		VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+		VkShaderModule mCompShaderModule = VK_NULL_HANDLE;
+	};
+}
@@ -1,16 +1,138 @@
 #include <PCH/pch.h>
 #include "RenderGraph.h"
+#include "ThreadCommandPools.h"
+#include "Core/Device.h"
+#include "Core/Allocator.h"
+#include "Jobs/JobSystem.h"
 
 namespace Radis
 {
+    namespace
+    {
+        // The state one use of a resource needs it in
+        struct Usage
+        {
+            VkImageLayout layout;
+            VkPipelineStageFlags2 stages;
+            VkAccessFlags2 access;
+        };
+
+        constexpr VkAccessFlags2 WRITE_ACCESS = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        bool IsDepthFormat(VkFormat format)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_D16_UNORM:
+            case VK_FORMAT_X8_D24_UNORM_PACK32:
+            case VK_FORMAT_D32_SFLOAT:
+            case VK_FORMAT_D16_UNORM_S8_UINT:
+            case VK_FORMAT_D24_UNORM_S8_UINT:
+            case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        VkImageAspectFlags GetAspectMask(VkFormat format)
+        {
+            switch (format)
+            {
+            case VK_FORMAT_D16_UNORM_S8_UINT:
+            case VK_FORMAT_D24_UNORM_S8_UINT:
+            case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+            default:
+                return IsDepthFormat(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+            }
+        }
+
+        Usage ReadUsage(VkFormat format, VkPipelineStageFlags2 stages)
+        {
+            return {
+                IsDepthFormat(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                stages,
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT
+            };
+        }
+
+        // Attachments are cleared on load, writes never need what was there before
+        Usage WriteUsage(VkFormat format)
+        {
+            if (IsDepthFormat(format))
+            {
+                return {
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                };
+            }
+            return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+        }
+
+        Usage StorageWriteUsage(VkPipelineStageFlags2 stages)
+        {
+            return { VK_IMAGE_LAYOUT_GENERAL, stages, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        }
+
+        // FNV-1a over the key's words
+        uint64_t HashKey(const std::vector<uint64_t>& key)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (uint64_t word : key)
+            {
+                hash ^= word;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+    }
+
+    void RGPassBuilder::create(const std::string& handleName, const RGTextureDesc& desc)
+    {
+        RGResourceHandle handle = m_graph.CreateTransient(handleName, desc);
+        if (handle.index != UINT32_MAX)
+        {
+            m_pass.writeTargets.push_back(handle);
+        }
+    }
+
+    void RGPassBuilder::createStorage(const std::string& handleName, const RGTextureDesc& desc, VkPipelineStageFlags2 stages)
+    {
+        RGResourceHandle handle = m_graph.CreateTransient(handleName, desc);
+        if (handle.index != UINT32_MAX)
+        {
+            m_pass.storageWriteTargets.push_back({ handle, stages });
+        }
+    }
+
     void RGPassBuilder::writes(const std::string& handleName)
     {
-        m_pass.writeTargets.push_back(handleName);
+        RGResourceHandle handle = m_graph.GetResourceHandle(handleName);
+        if (handle.index != UINT32_MAX)
+        {
+            m_pass.writeTargets.push_back(handle);
+        }
+    }
+
+    void RGPassBuilder::reads(const std::string& handleName, VkPipelineStageFlags2 stages)
+    {
+        RGResourceHandle handle = m_graph.GetResourceHandle(handleName);
+        if (handle.index != UINT32_MAX)
+        {
+            m_pass.readTargets.push_back({ handle, stages });
+        }
+    }
+
+    RenderGraph::RenderGraph(Device& device)
+        : mDevice(device)
+    {
     }
 
-    void RGPassBuilder::reads(const std::string& handleName)
+    RenderGraph::~RenderGraph()
     {
-        m_pass.readTargets.push_back(handleName);
+        DestroyTransients();
     }
 
     RGResourceHandle RenderGraph::ImportTexture(const char* name, VkImage image, VkImageView view, VkExtent2D extent, VkFormat format, bool backBuffer)
@@ -21,7 +143,6 @@ namespace Radis
         resource.imageView = view;
         resource.extent = extent;
         resource.format = format;
-        resource.currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         resource.isBackBuffer = backBuffer;
 
         mResources.push_back(resource);
@@ -34,6 +155,27 @@ namespace Radis
         return ImportTexture(name, image, view, extent, format, true);
     }
 
+    RGResourceHandle RenderGraph::CreateTransient(const std::string& name, const RGTextureDesc& desc)
+    {
+        if (mResourceLookup.contains(name))
+        {
+            RADIS_ERROR("Render graph resource {0} already exists, can't create it", name);
+            return { UINT32_MAX };
+        }
+
+        RGResource resource;
+        resource.name = name;
+        resource.extent = { desc.width, desc.height };
+        resource.format = desc.format;
+        resource.isBackBuffer = false;
+        resource.isTransient = true;
+        resource.desc = desc;
+
+        mResources.push_back(resource);
+        mResourceLookup[name] = static_cast<uint32_t>(mResources.size() - 1);
+        return { static_cast<uint32_t>(mResources.size() - 1) };
+    }
+
     void RenderGraph::AddPass(const char* name,
         std::function<void(RGPassBuilder&)>&& setup,
         std::function<void(VkCommandBuffer)>&& execute)
@@ -43,198 +185,626 @@ namespace Radis
         pass.setupCallback = std::move(setup);
         pass.executeCallback = std::move(execute);
 
-        RGPassBuilder builder(pass);
+        RGPassBuilder builder(*this, pass);
+        pass.setupCallback(builder);
+
+        mPasses.push_back(pass);
+    }
+
+    void RenderGraph::AddParallelPass(const char* name,
+        std::function<void(RGPassBuilder&)>&& setup,
+        RGRangeCallback&& execute,
+        uint32_t itemCount,
+        uint32_t itemsPerRecording)
+    {
+        RGPass pass;
+        pass.name = name;
+        pass.setupCallback = std::move(setup);
+        pass.rangeCallback = std::move(execute);
+        pass.itemCount = itemCount;
+        pass.itemsPerRecording = std::max(itemsPerRecording, 1u);
+
+        RGPassBuilder builder(*this, pass);
         pass.setupCallback(builder);
 
         mPasses.push_back(pass);
     }
 
-    void RenderGraph::Execute(VkCommandBuffer cmd, VkDevice device)
+    void RenderGraph::BuildKey(std::vector<uint64_t>& key) const
+    {
+        // Only what the compiled graph depends on: resource formats and roles, and the order
+        // passes access them in. Names and callbacks change nothing.
+        key.clear();
+        key.push_back(mResources.size());
+        for (const RGResource& resource : mResources)
+        {
+            key.push_back(static_cast<uint64_t>(resource.format) << 2 | (resource.isTransient ? 2 : 0) | (resource.isBackBuffer ? 1 : 0));
+            if (resource.isTransient)
+            {
+                key.push_back(resource.desc.usage);
+            }
+        }
+        for (const RGPass& pass : mPasses)
+        {
+            key.push_back(static_cast<uint64_t>(pass.readTargets.size()) << 40 | static_cast<uint64_t>(pass.storageWriteTargets.size()) << 20 | pass.writeTargets.size());
+            for (const RGRead& read : pass.readTargets)
+            {
+                key.push_back(read.handle.index);
+                key.push_back(read.stages);
+            }
+            for (const RGResourceHandle& write : pass.writeTargets)
+            {
+                key.push_back(write.index);
+            }
+            for (const RGStorageWrite& write : pass.storageWriteTargets)
+            {
+                key.push_back(write.handle.index);
+                key.push_back(write.stages);
+            }
+        }
+    }
+
+    RenderGraph::CompiledGraph& RenderGraph::Compile()
+    {
+        BuildKey(mKey);
+        const uint64_t hash = HashKey(mKey);
+        mShapeChanged = hash != mLastHash;
+        mLastHash = hash;
+
+        auto it = mCompiledGraphs.find(hash);
+        if (it != mCompiledGraphs.end() && it->second.key == mKey)
+        {
+            return it->second;
+        }
+
+        // A handful of shapes alternate at most (passes that only run on some frames), anything
+        // beyond that is stale
+        if (it == mCompiledGraphs.end() && mCompiledGraphs.size() >= MAX_CACHED_GRAPHS)
+        {
+            mCompiledGraphs.clear();
+        }
+
+        CompiledGraph& graph = mCompiledGraphs[hash];
+        graph = CompiledGraph{};
+        graph.key = mKey;
+        BuildCompiledGraph(graph);
+        return graph;
+    }
+
+    void RenderGraph::ResolveTransientUsage(CompiledGraph& graph, const std::vector<uint8_t>& live) const
     {
-        for (const auto& pass : mPasses)
+        const uint32_t resourceCount = static_cast<uint32_t>(mResources.size());
+        graph.transientUsage.assign(resourceCount, 0);
+
+        // Only surviving passes count, a transient nothing live touches isn't allocated
+        std::vector<uint8_t> written(resourceCount, 0);
+        auto use = [&](uint32_t resource, uint32_t pass, VkImageUsageFlags usage, bool write)
         {
+            if (!mResources[resource].isTransient) return;
 
-            // --- 1. Automatic Barrier Insertion (Image Layout Transitions) ---
+            if (!written[resource] && !write)
+            {
+                RADIS_WARN("Render graph transient {0} is read by {1} before any pass writes it", mResources[resource].name, mPasses[pass].name);
+            }
+            written[resource] |= write ? 1 : 0;
+            graph.transientUsage[resource] |= usage | mResources[resource].desc.usage;
+        };
+
+        for (uint32_t p = 0; p < static_cast<uint32_t>(mPasses.size()); ++p)
+        {
+            if (!live[p]) continue;
 
-            for (const auto& handleName : pass.readTargets)
+            for (const RGRead& read : mPasses[p].readTargets)
             {
-                RGResourceHandle handle = GetResourceHandle(handleName);
-                RGResource& resource = mResources[handle.index];
-                if (resource.currentLayout != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-                {
-                    VkImageMemoryBarrier barrier{};
-                    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    barrier.oldLayout = resource.currentLayout;
-                    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    barrier.image = resource.image;
-                    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                    barrier.subresourceRange.levelCount = 1;
-                    barrier.subresourceRange.layerCount = 1;
-
-                    // From color attachment write to shader read
-                    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-                    vkCmdPipelineBarrier(cmd,
-                        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-                    resource.currentLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                use(read.handle.index, p, VK_IMAGE_USAGE_SAMPLED_BIT, false);
+            }
+            for (const RGResourceHandle& write : mPasses[p].writeTargets)
+            {
+                const bool depth = IsDepthFormat(mResources[write.index].format);
+                use(write.index, p, depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true);
+            }
+            for (const RGStorageWrite& write : mPasses[p].storageWriteTargets)
+            {
+                use(write.handle.index, p, VK_IMAGE_USAGE_STORAGE_BIT, true);
+            }
+        }
+    }
+
+    void RenderGraph::BuildCompiledGraph(CompiledGraph& graph) const
+    {
+        const uint32_t resourceCount = static_cast<uint32_t>(mResources.size());
+        const uint32_t passCount = static_cast<uint32_t>(mPasses.size());
+
+        // Cull walking back from the backbuffer. Passes that declare no writes work on state the
+        // graph can't see (buffers, their own images) and always run.
+        std::vector<uint8_t> consumed(resourceCount, 0);
+        for (uint32_t r = 0; r < resourceCount; ++r)
+        {
+            consumed[r] = mResources[r].isBackBuffer ? 1 : 0;
+        }
+
+        std::vector<uint8_t> live(passCount, 0);
+        for (uint32_t p = passCount; p-- > 0;)
+        {
+            const RGPass& pass = mPasses[p];
+            bool keep = pass.writeTargets.empty() && pass.storageWriteTargets.empty();
+            for (const RGResourceHandle& write : pass.writeTargets)
+            {
+                keep = keep || consumed[write.index];
+            }
+            for (const RGStorageWrite& write : pass.storageWriteTargets)
+            {
+                keep = keep || consumed[write.handle.index];
+            }
+
+            if (!keep)
+            {
+                RADIS_TRACE("Culled render graph pass {0}, nothing reads what it writes", pass.name);
+                continue;
+            }
+
+            live[p] = 1;
+            for (const RGRead& read : pass.readTargets)
+            {
+                consumed[read.handle.index] = 1;
+            }
+        }
+
+        // A resource's last use this frame is the state it starts the next one in. The swapchain
+        // image instead comes from the acquire semaphore, which the submit waits on at color
+        // attachment output.
+        std::vector<Usage> state(resourceCount, Usage{ VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE });
+        for (uint32_t p = 0; p < passCount; ++p)
+        {
+            if (!live[p]) continue;
+
+            for (const RGRead& read : mPasses[p].readTargets)
+            {
+                state[read.handle.index] = ReadUsage(mResources[read.handle.index].format, read.stages);
+            }
+            for (const RGResourceHandle& write : mPasses[p].writeTargets)
+            {
+                state[write.index] = WriteUsage(mResources[write.index].format);
+            }
+            for (const RGStorageWrite& write : mPasses[p].storageWriteTargets)
+            {
+                state[write.handle.index] = StorageWriteUsage(write.stages);
+            }
+        }
+        for (uint32_t r = 0; r < resourceCount; ++r)
+        {
+            if (mResources[r].isBackBuffer)
+            {
+                state[r] = { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE };
+            }
+        }
+
+        ResolveTransientUsage(graph, live);
+
+        // Barrier from the resource's current state into usage, skipped for reads of something
+        // already readable in the right layout. Those widen the state so a later write waits on
+        // every reader.
+        auto transition = [&](uint32_t resource, const Usage& usage, bool discard)
+        {
+            Usage& current = state[resource];
+            const bool hazard = (current.access & WRITE_ACCESS) || (usage.access & WRITE_ACCESS);
+            if (current.layout == usage.layout && !hazard)
+            {
+                current.stages |= usage.stages;
+                current.access |= usage.access;
+                return;
+            }
+
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = current.stages;
+            barrier.srcAccessMask = current.access & WRITE_ACCESS;
+            barrier.dstStageMask = usage.stages;
+            barrier.dstAccessMask = usage.access;
+            barrier.oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : current.layout;
+            barrier.newLayout = usage.layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange = { GetAspectMask(mResources[resource].format), 0, 1, 0, 1 };
+
+            graph.barriers.push_back(barrier);
+            graph.barrierResources.push_back(resource);
+            current = usage;
+        };
+
+        for (uint32_t p = 0; p < passCount; ++p)
+        {
+            if (!live[p]) continue;
+
+            const RGPass& pass = mPasses[p];
+            CompiledPass& compiled = graph.passes.emplace_back();
+            compiled.pass = p;
+            compiled.firstBarrier = static_cast<uint32_t>(graph.barriers.size());
+            compiled.colorTarget = NO_TARGET;
+            compiled.depthTarget = NO_TARGET;
+
+            for (const RGRead& read : pass.readTargets)
+            {
+                transition(read.handle.index, ReadUsage(mResources[read.handle.index].format, read.stages), false);
+            }
+            for (const RGResourceHandle& write : pass.writeTargets)
+            {
+                const VkFormat format = mResources[write.index].format;
+                transition(write.index, WriteUsage(format), true);
+                if (IsDepthFormat(format)) {
+                    compiled.depthTarget = write.index;
                 }
+                else {
+                    compiled.colorTarget = write.index;
+                }
+            }
+            for (const RGStorageWrite& write : pass.storageWriteTargets)
+            {
+                transition(write.handle.index, StorageWriteUsage(write.stages), true);
+            }
+
+            compiled.barrierCount = static_cast<uint32_t>(graph.barriers.size()) - compiled.firstBarrier;
+        }
+
+        // After all passes the backbuffer goes to present, nothing in this submission follows
+        graph.finalBarrier = static_cast<uint32_t>(graph.barriers.size());
+        for (uint32_t r = 0; r < resourceCount; ++r)
+        {
+            if (mResources[r].isBackBuffer)
+            {
+                transition(r, { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE }, false);
+            }
+        }
+        graph.finalBarrierCount = static_cast<uint32_t>(graph.barriers.size()) - graph.finalBarrier;
+
+        RADIS_TRACE("Compiled render graph: {0} of {1} passes, {2} barriers", graph.passes.size(), passCount, graph.barriers.size());
+    }
+
+    void RenderGraph::RealizeTransients(const CompiledGraph& graph)
+    {
+        VkExtent2D backBufferExtent{ 1, 1 };
+        for (const RGResource& resource : mResources)
+        {
+            if (resource.isBackBuffer)
+            {
+                backBufferExtent = resource.extent;
             }
+        }
 
+        // Everything the allocation depends on, the images are kept while it doesn't change
+        std::vector<uint64_t> key;
+        for (uint32_t r = 0; r < static_cast<uint32_t>(mResources.size()); ++r)
+        {
+            RGResource& resource = mResources[r];
+            if (graph.transientUsage[r] == 0) continue;
 
-            for (const auto& handleName : pass.writeTargets)
+            const RGTextureDesc& desc = resource.desc;
+            if (desc.width == 0 || desc.height == 0)
             {
-                RGResourceHandle handle = GetResourceHandle(handleName);
-                RGResource& resource = mResources[handle.index];
+                resource.extent.width = std::max(1u, static_cast<uint32_t>(backBufferExtent.width * desc.scale));
+                resource.extent.height = std::max(1u, static_cast<uint32_t>(backBufferExtent.height * desc.scale));
+            }
 
-                // Check if it's a depth format
-                bool isDepth = (resource.format == VK_FORMAT_D32_SFLOAT);
+            key.push_back(std::hash<std::string>{}(resource.name));
+            key.push_back(static_cast<uint64_t>(resource.format) << 32 | graph.transientUsage[r]);
+            key.push_back(static_cast<uint64_t>(resource.extent.width) << 32 | resource.extent.height);
+        }
+
+        if (key != mTransientKey)
+        {
+            // Frames in flight still use the old ones
+            vkDeviceWaitIdle(mDevice.GetDevice());
+            DestroyTransients();
 
-                VkImageLayout newLayout = isDepth ?
-                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL :
-                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            // Every transient gets its own memory. Aliasing transients with disjoint lifetimes
+            // can come back once a graph has two of them that don't overlap.
+            VmaAllocationCreateInfo allocInfo{};
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 
-                // Transition the backbuffer for rendering
-                if (resource.currentLayout != newLayout)
+            VkDeviceSize totalSize = 0;
+            for (uint32_t r = 0; r < static_cast<uint32_t>(mResources.size()); ++r)
+            {
+                const RGResource& resource = mResources[r];
+                if (graph.transientUsage[r] == 0) continue;
+
+                VkImageCreateInfo imageInfo{};
+                imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                imageInfo.imageType = VK_IMAGE_TYPE_2D;
+                imageInfo.format = resource.format;
+                imageInfo.extent = { resource.extent.width, resource.extent.height, 1 };
+                imageInfo.mipLevels = 1;
+                imageInfo.arrayLayers = 1;
+                imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+                imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                imageInfo.usage = graph.transientUsage[r];
+                imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+                TransientImage& transient = mTransientImages[resource.name];
+                VmaAllocationInfo allocationInfo{};
+                if (vmaCreateImage(Allocator::GetAllocator(), &imageInfo, &allocInfo, &transient.image, &transient.allocation, &allocationInfo) != VK_SUCCESS)
                 {
-                    VkImageMemoryBarrier barrier{};
-                    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    barrier.oldLayout = resource.currentLayout;
-                    barrier.newLayout = newLayout;
-                    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                    barrier.image = resource.image;
-                    barrier.subresourceRange.aspectMask = isDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-                    barrier.subresourceRange.baseMipLevel = 0;
-                    barrier.subresourceRange.levelCount = 1;
-                    barrier.subresourceRange.baseArrayLayer = 0;
-                    barrier.subresourceRange.layerCount = 1;
-
-                    barrier.srcAccessMask = 0; // Or determine from previous usage
-                    barrier.dstAccessMask = isDepth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-                    vkCmdPipelineBarrier(cmd,
-                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                        isDepth ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                        0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-                    resource.currentLayout = newLayout;
+                    RADIS_CRITICAL("Failed to create render graph transient {0}", resource.name);
+                    transient = {};
+                    continue;
+                }
+                Allocator::SetAllocationName(transient.allocation, ("Render Graph Transient " + resource.name).c_str());
+                totalSize += allocationInfo.size;
+
+                VkImageViewCreateInfo viewInfo{};
+                viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewInfo.image = transient.image;
+                viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewInfo.format = resource.format;
+                viewInfo.subresourceRange = { GetAspectMask(resource.format), 0, 1, 0, 1 };
+                if (vkCreateImageView(mDevice.GetDevice(), &viewInfo, nullptr, &transient.view) != VK_SUCCESS)
+                {
+                    RADIS_CRITICAL("Failed to create render graph transient view {0}", resource.name);
                 }
             }
 
-            // --- 2. Begin Dynamic Rendering ---
-            // For simplicity, we assume the first write target is the color attachment.
-            // A more robust system would handle multiple attachments.
-            if (!pass.writeTargets.empty())
-            {
-                // Find color and depth targets for the pass
-                RGResource* colorTarget = nullptr;
-                RGResource* depthTarget = nullptr;
-                for (const auto& handleName : pass.writeTargets) {
-                    RGResourceHandle handle = GetResourceHandle(handleName);
-                    RGResource& res = mResources[handle.index];
-                    if (res.format == VK_FORMAT_D32_SFLOAT) { // Or your chosen format
-                        depthTarget = &res;
-                    }
-                    else {
-                        colorTarget = &res;
-                    }
-                }
+            mTransientKey = std::move(key);
+            RADIS_INFO("Allocated {0} render graph transients, {1} KB", mTransientImages.size(), totalSize / 1024);
+        }
 
-                if (colorTarget) {
-
-                    VkRenderingAttachmentInfo colorAttachment{};
-                    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
-                    colorAttachment.imageView = colorTarget->imageView;
-                    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-                    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-                    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-                    colorAttachment.clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
-
-                    VkRenderingAttachmentInfo depthAttachment{};
-                    if (depthTarget) {
-                        depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
-                        depthAttachment.imageView = depthTarget->imageView;
-                        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-                        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear depth at start of pass
-                        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-                        depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
-                    }
-
-                    VkRenderingInfo renderingInfo{};
-                    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
-                    renderingInfo.renderArea = { {0, 0}, colorTarget->extent };
-                    renderingInfo.layerCount = 1;
-                    renderingInfo.colorAttachmentCount = 1;
-                    renderingInfo.pColorAttachments = &colorAttachment;
-                    renderingInfo.pDepthAttachment = depthTarget ? &depthAttachment : nullptr;
-                    renderingInfo.pStencilAttachment = nullptr;
-
-                    vkCmdBeginRendering(cmd, &renderingInfo);
-
-                    pass.executeCallback(cmd);
-
-                    vkCmdEndRendering(cmd);
-                }
+        for (RGResource& resource : mResources)
+        {
+            if (!resource.isTransient) continue;
+
+            auto it = mTransientImages.find(resource.name);
+            if (it != mTransientImages.end())
+            {
+                resource.image = it->second.image;
+                resource.imageView = it->second.view;
+            }
+        }
+    }
+
+    void RenderGraph::DestroyTransients()
+    {
+        for (auto& [name, transient] : mTransientImages)
+        {
+            if (transient.view != VK_NULL_HANDLE) vkDestroyImageView(mDevice.GetDevice(), transient.view, nullptr);
+            if (transient.image != VK_NULL_HANDLE) vmaDestroyImage(Allocator::GetAllocator(), transient.image, transient.allocation);
+        }
+        mTransientImages.clear();
+        mTransientKey.clear();
+    }
+
+    void RenderGraph::RecordParallelPasses(const CompiledGraph& graph, ThreadCommandPools& pools, uint32_t frameIndex)
+    {
+        // What each chunk's secondary buffer inherits, worked out up front so the jobs only read
+        struct Inheritance
+        {
+            VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+            VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+            bool rendering = false;
+        };
+        struct Chunk
+        {
+            RGPass* pass;
+            const Inheritance* inheritance;
+            uint32_t begin;
+            uint32_t end;
+            VkCommandBuffer* recording;
+        };
+
+        for (RGPass& pass : mPasses)
+        {
+            pass.recordings.clear();
+        }
+
+        std::vector<Inheritance> inheritances;
+        inheritances.reserve(graph.passes.size());
+        std::vector<Chunk> chunks;
+        for (const CompiledPass& compiled : graph.passes)
+        {
+            RGPass& pass = mPasses[compiled.pass];
+            // A single chunk (the indirect scene paths are one call) would only add a
+            // vkCmdExecuteCommands, it's recorded inline instead
+            if (!pass.rangeCallback || pass.itemCount <= pass.itemsPerRecording)
+            {
+                continue;
+            }
+
+            // Same attachments Execute begins rendering with
+            Inheritance& inheritance = inheritances.emplace_back();
+            if (compiled.colorTarget != NO_TARGET)
+            {
+                inheritance.colorFormat = mResources[compiled.colorTarget].format;
             }
-            else
+            if (compiled.depthTarget != NO_TARGET)
             {
-                // Just execute that
-                pass.executeCallback(cmd);
+                inheritance.depthFormat = mResources[compiled.depthTarget].format;
+            }
+            inheritance.rendering = compiled.colorTarget != NO_TARGET || compiled.depthTarget != NO_TARGET;
+
+            const uint32_t chunkCount = (pass.itemCount + pass.itemsPerRecording - 1) / pass.itemsPerRecording;
+            pass.recordings.assign(chunkCount, VK_NULL_HANDLE);
+            for (uint32_t i = 0; i < chunkCount; ++i)
+            {
+                const uint32_t begin = i * pass.itemsPerRecording;
+                const uint32_t end = std::min(begin + pass.itemsPerRecording, pass.itemCount);
+                chunks.push_back({ &pass, &inheritance, begin, end, &pass.recordings[i] });
             }
         }
 
-        // --- 3. Final Transition for Presentation ---
-        // After all passes, transition the backbuffer for presenting.
-        if (!mResources.empty())
+        JobSystem::ParallelFor(chunks.size(), 1, [&](size_t first, size_t last)
         {
-            RGResource* finalBackbuffer = nullptr;
-            for (auto& resource : mResources)
+            for (size_t i = first; i < last; ++i)
             {
-                if (resource.isBackBuffer)
+                const Chunk& chunk = chunks[i];
+                VkCommandBuffer recording = pools.Acquire(frameIndex);
+                if (recording == VK_NULL_HANDLE)
+                {
+                    continue;
+                }
+
+                VkCommandBufferInheritanceRenderingInfo renderingInheritance{};
+                renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+                renderingInheritance.colorAttachmentCount = chunk.inheritance->colorFormat != VK_FORMAT_UNDEFINED ? 1 : 0;
+                renderingInheritance.pColorAttachmentFormats = &chunk.inheritance->colorFormat;
+                renderingInheritance.depthAttachmentFormat = chunk.inheritance->depthFormat;
+                renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+                VkCommandBufferInheritanceInfo inheritanceInfo{};
+                inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                inheritanceInfo.pNext = chunk.inheritance->rendering ? &renderingInheritance : nullptr;
+
+                VkCommandBufferBeginInfo beginInfo{};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                if (chunk.inheritance->rendering)
                 {
-                    finalBackbuffer = &resource;
-                    break;
+                    beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
                 }
+                beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+                vkBeginCommandBuffer(recording, &beginInfo);
+                chunk.pass->rangeCallback(recording, chunk.begin, chunk.end);
+                vkEndCommandBuffer(recording);
+                *chunk.recording = recording;
             }
+        });
 
-            if (finalBackbuffer && finalBackbuffer->currentLayout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+        // A chunk that got no command buffer sends its whole pass back to inline recording
+        for (RGPass& pass : mPasses)
+        {
+            if (std::find(pass.recordings.begin(), pass.recordings.end(), VK_NULL_HANDLE) != pass.recordings.end())
             {
-                VkImageMemoryBarrier barrier{};
-                barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                barrier.oldLayout = finalBackbuffer->currentLayout;
-                barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-                barrier.image = finalBackbuffer->image;
-                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                barrier.subresourceRange.baseMipLevel = 0;
-                barrier.subresourceRange.levelCount = 1;
-                barrier.subresourceRange.baseArrayLayer = 0;
-                barrier.subresourceRange.layerCount = 1;
+                RADIS_WARN("Pass {0} couldn't be recorded in parallel, recording it inline", pass.name);
+                pass.recordings.clear();
+            }
+        }
+    }
+
+    void RenderGraph::ExecutePassCommands(const RGPass& pass, VkCommandBuffer cmd) const
+    {
+        if (!pass.recordings.empty())
+        {
+            vkCmdExecuteCommands(cmd, static_cast<uint32_t>(pass.recordings.size()), pass.recordings.data());
+        }
+        else if (pass.rangeCallback)
+        {
+            pass.rangeCallback(cmd, 0, pass.itemCount);
+        }
+        else
+        {
+            pass.executeCallback(cmd);
+        }
+    }
+
+    void RenderGraph::IssueBarriers(VkCommandBuffer cmd, const CompiledGraph& graph, uint32_t first, uint32_t count) const
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = count;
+        dependencyInfo.pImageMemoryBarriers = graph.barriers.data() + first;
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+    }
+
+    void RenderGraph::Execute(VkCommandBuffer cmd, VkDevice device, ThreadCommandPools* pools, uint32_t frameIndex)
+    {
+        CompiledGraph& graph = Compile();
+        RealizeTransients(graph);
+
+        // The backbuffer is a different image every frame
+        for (size_t i = 0; i < graph.barriers.size(); ++i)
+        {
+            graph.barriers[i].image = mResources[graph.barrierResources[i]].image;
+        }
+
+        // The barriers assume the previous frame ran this same graph. The frame the shape changes
+        // the last uses were other ones, so that frame waits on all earlier work once.
+        if (mShapeChanged)
+        {
+            VkMemoryBarrier2 memoryBarrier{};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            memoryBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            memoryBarrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+            memoryBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+            VkDependencyInfo dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.memoryBarrierCount = 1;
+            dependencyInfo.pMemoryBarriers = &memoryBarrier;
+            vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+        }
+
+        // Secondary buffers first, barriers and rendering scopes are then stitched around them in
+        // pass order on this thread
+        if (pools)
+        {
+            RecordParallelPasses(graph, *pools, frameIndex);
+        }
+
+        for (const CompiledPass& compiled : graph.passes)
+        {
+            const RGPass& pass = mPasses[compiled.pass];
+
+            // All of the pass's transitions in one call
+            IssueBarriers(cmd, graph, compiled.firstBarrier, compiled.barrierCount);
 
-                barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                barrier.dstAccessMask = 0;
+            if (compiled.colorTarget == NO_TARGET && compiled.depthTarget == NO_TARGET)
+            {
+                ExecutePassCommands(pass, cmd);
+                continue;
+            }
 
-                vkCmdPipelineBarrier(cmd,
-                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                    0, 0, nullptr, 0, nullptr, 1, &barrier);
+            const RGResource* colorTarget = compiled.colorTarget != NO_TARGET ? &mResources[compiled.colorTarget] : nullptr;
+            const RGResource* depthTarget = compiled.depthTarget != NO_TARGET ? &mResources[compiled.depthTarget] : nullptr;
+
+            VkRenderingAttachmentInfo colorAttachment{};
+            if (colorTarget) {
+                colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+                colorAttachment.imageView = colorTarget->imageView;
+                colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                colorAttachment.clearValue.color = { {0.0f, 0.0f, 0.0f, 1.0f} };
+            }
 
-                finalBackbuffer->currentLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            VkRenderingAttachmentInfo depthAttachment{};
+            if (depthTarget) {
+                depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+                depthAttachment.imageView = depthTarget->imageView;
+                depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Clear depth at start of pass
+                depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
             }
+
+            VkRenderingInfo renderingInfo{};
+            renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+            renderingInfo.flags = pass.recordings.empty() ? 0 : VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+            renderingInfo.renderArea = { {0, 0}, colorTarget ? colorTarget->extent : depthTarget->extent };
+            renderingInfo.layerCount = 1;
+            renderingInfo.colorAttachmentCount = colorTarget ? 1 : 0;
+            renderingInfo.pColorAttachments = colorTarget ? &colorAttachment : nullptr;
+            renderingInfo.pDepthAttachment = depthTarget ? &depthAttachment : nullptr;
+            renderingInfo.pStencilAttachment = nullptr;
+
+            vkCmdBeginRendering(cmd, &renderingInfo);
+
+            ExecutePassCommands(pass, cmd);
+
+            vkCmdEndRendering(cmd);
         }
+
+        // Backbuffer to present
+        IssueBarriers(cmd, graph, graph.finalBarrier, graph.finalBarrierCount);
     }
 
     void RenderGraph::Clear()
     {
         mPasses.clear();
         mResources.clear();
+        mResourceLookup.clear();
     }
 
     void RenderGraph::Resize(uint32_t width, uint32_t height)
@@ -257,4 +827,4 @@ namespace Radis
         RADIS_ERROR("Requested resource {0} not found in RenderGraph!", name);
         return { UINT32_MAX };
     }
-}
\ No newline at end of file
+}
@@ -10,7 +10,20 @@ namespace Radis
         void operator=(const uint32_t& idx) { index = idx; }
     };
 
-    // Internal representation of a resource's state.
+    // A texture the graph creates and owns. It follows the backbuffer's size unless width and
+    // height are both set. Usage for the graph's own accesses is added to usage, which only needs
+    // what is done with the texture outside of declared reads and writes.
+    struct RGTextureDesc
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        float scale = 1.0f;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        VkImageUsageFlags usage = 0;
+    };
+
+    // Internal representation of a resource. Layouts aren't tracked here, the compiled graph
+    // knows the state every pass leaves each resource in.
     struct RGResource
     {
         std::string name;
@@ -20,47 +33,89 @@ namespace Radis
         VkFormat format;
         bool isBackBuffer;
 
-        // State tracking for automatic barriers
-        VkImageLayout currentLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+        // Created by a pass rather than imported, image and view are filled in by Execute
+        bool isTransient = false;
+        RGTextureDesc desc;
+    };
+
+    // A sampled read of a resource by the given shader stages
+    struct RGRead
+    {
+        RGResourceHandle handle;
+        VkPipelineStageFlags2 stages;
+    };
+
+    // A storage image write of a resource by the given shader stages, in GENERAL layout
+    struct RGStorageWrite
+    {
+        RGResourceHandle handle;
+        VkPipelineStageFlags2 stages;
     };
 
     struct RGPass; // Forward declaration
+    class RenderGraph;
+    class ThreadCommandPools;
+    class Device;
 
     // A transient helper object passed to the pass setup lambda.
     // It provides a clean API for declaring what a pass reads from and writes to.
+    // Names are resolved to handles here, once per declaration.
     class RGPassBuilder
     {
     public:
-        RGPassBuilder(RGPass& pass) : m_pass(pass) {}
+        RGPassBuilder(RenderGraph& graph, RGPass& pass) : m_graph(graph), m_pass(pass) {}
+
+        // Declare a texture the graph allocates for this frame, and that this pass writes it first.
+        // Later passes reach it by name.
+        void create(const std::string& handleName, const RGTextureDesc& desc);
+
+        // Same, but the pass writes it as a storage image from the given stages. Like attachment
+        // writes the previous contents are discarded, so the pass has to write every texel.
+        void createStorage(const std::string& handleName, const RGTextureDesc& desc, VkPipelineStageFlags2 stages);
 
-        // Declare that this pass writes to a resource.
+        // Declare that this pass renders to a resource, as the color or depth attachment
+        // depending on its format.
         void writes(const std::string& handleName);
 
-        // Declare that this pass reads from a resource.
-        void reads(const std::string& handleName);
+        // Declare that this pass samples a resource from the given stages.
+        void reads(const std::string& handleName, VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
 
 
     private:
+        RenderGraph& m_graph;
         RGPass& m_pass;
     };
 
+    // Records items [begin, end) of a parallel pass into its own command buffer. Runs on a job
+    // system thread and starts from no bound state.
+    using RGRangeCallback = std::function<void(VkCommandBuffer, uint32_t begin, uint32_t end)>;
+
     // Logical description of a render pass and its resource usage.
     struct RGPass {
         std::string name;
         std::function<void(RGPassBuilder&)> setupCallback;
         std::function<void(VkCommandBuffer)> executeCallback;
 
-        //std::vector<RGResourceHandle> writeTargets;
-        //std::vector<RGResourceHandle> readTargets;
+        // Parallel passes only: itemCount items recorded itemsPerRecording at a time into
+        // secondary command buffers, which Execute stitches back in pass order
+        RGRangeCallback rangeCallback;
+        uint32_t itemCount = 0;
+        uint32_t itemsPerRecording = 0;
+        std::vector<VkCommandBuffer> recordings;
 
-        std::vector<std::string> writeTargets;
-        std::vector<std::string> readTargets;
+        std::vector<RGResourceHandle> writeTargets;
+        std::vector<RGStorageWrite> storageWriteTargets;
+        std::vector<RGRead> readTargets;
     };
 
     // The main orchestrator class
     class RenderGraph {
     public:
-        RenderGraph() = default;
+        RenderGraph(Device& device);
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
 
         // Imports an existing, externally managed image (like the swapchain) into the graph.
         RGResourceHandle ImportTexture(const char* name, VkImage image, VkImageView view, VkExtent2D extent, VkFormat format, bool backBuffer = false);
@@ -71,8 +126,20 @@ namespace Radis
             std::function<void(RGPassBuilder&)>&& setup,
             std::function<void(VkCommandBuffer)>&& execute);
 
-        // Compiles and executes the graph, recording commands into the provided buffer.
-        void Execute(VkCommandBuffer cmd, VkDevice device);
+        // Adds a pass whose work splits into itemCount independent items (draws, say). Chunks of
+        // itemsPerRecording items are recorded concurrently with every other parallel pass's, so
+        // execute must only read shared state. A pass that fits in one chunk is recorded inline.
+        void AddParallelPass(const char* name,
+            std::function<void(RGPassBuilder&)>&& setup,
+            RGRangeCallback&& execute,
+            uint32_t itemCount,
+            uint32_t itemsPerRecording);
+
+        // Compiles and executes the graph, recording commands into the provided buffer. Parallel
+        // passes are recorded into secondary buffers from pools first, or inline without pools.
+        // Passes whose outputs nothing consumes are skipped. Transient textures are (re)allocated
+        // before anything is recorded when their descriptions or the backbuffer size changed.
+        void Execute(VkCommandBuffer cmd, VkDevice device, ThreadCommandPools* pools = nullptr, uint32_t frameIndex = 0);
 
         // Clears all passes and resources for the next frame.
         void Clear();
@@ -80,12 +147,84 @@ namespace Radis
         // Resize
         void Resize(uint32_t width, uint32_t height);
 
+        // UINT32_MAX index when name wasn't imported or created
+        RGResourceHandle GetResourceHandle(const std::string& name) const;
+        // Transients only have their image and view once Execute started, from pass callbacks
+        const RGResource& GetResource(RGResourceHandle handle) const { return mResources[handle.index]; }
+
 
     private:
-        RGResourceHandle GetResourceHandle(const std::string& name) const;
+        friend class RGPassBuilder;
+
+        static constexpr uint32_t NO_TARGET = UINT32_MAX;
+        static constexpr size_t MAX_CACHED_GRAPHS = 8;
+
+        // A pass that survived culling, with the barriers that go in front of it
+        struct CompiledPass
+        {
+            uint32_t pass;          // into mPasses
+            uint32_t firstBarrier;
+            uint32_t barrierCount;
+            uint32_t colorTarget;   // resource indices, NO_TARGET when the pass doesn't render
+            uint32_t depthTarget;
+        };
+
+        // Everything Execute needs that only depends on the shape of the graph. The graph is
+        // rebuilt every frame but its shape rarely changes, so compiled graphs are cached by key.
+        struct CompiledGraph
+        {
+            std::vector<uint64_t> key;
+            std::vector<CompiledPass> passes;
+            std::vector<VkImageMemoryBarrier2> barriers;    // images filled in every frame
+            std::vector<uint32_t> barrierResources;         // resource each barrier transitions
+            uint32_t finalBarrier = 0;                      // after the last pass, to present
+            uint32_t finalBarrierCount = 0;
+
+            // Graph accesses plus the desc's usage of every transient a live pass uses, 0 for
+            // imports and transients that aren't allocated
+            std::vector<VkImageUsageFlags> transientUsage;
+        };
+
+        // A transient texture as allocated, kept across frames until the graph's transients change
+        struct TransientImage
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView view = VK_NULL_HANDLE;
+            VmaAllocation allocation = VK_NULL_HANDLE;
+        };
+
+        RGResourceHandle CreateTransient(const std::string& name, const RGTextureDesc& desc);
+
+        // Finds or builds the compiled graph for this frame's passes
+        CompiledGraph& Compile();
+        void BuildCompiledGraph(CompiledGraph& graph) const;
+        void BuildKey(std::vector<uint64_t>& key) const;
+        // Image usage of every transient used by a live pass
+        void ResolveTransientUsage(CompiledGraph& graph, const std::vector<uint8_t>& live) const;
+
+        // Allocates the transients the compiled graph needs at this frame's backbuffer size, then
+        // points their resources at the images
+        void RealizeTransients(const CompiledGraph& graph);
+        void DestroyTransients();
+
+        // Records every surviving parallel pass's chunks on the job system, filling their recordings
+        void RecordParallelPasses(const CompiledGraph& graph, ThreadCommandPools& pools, uint32_t frameIndex);
+        // Runs the pass's work into cmd, either its recordings or its callback
+        void ExecutePassCommands(const RGPass& pass, VkCommandBuffer cmd) const;
+        void IssueBarriers(VkCommandBuffer cmd, const CompiledGraph& graph, uint32_t first, uint32_t count) const;
 
         std::vector<RGResource> mResources;
         std::vector<RGPass> mPasses;
         std::unordered_map<std::string, RGResourceHandle> mResourceLookup;
+
+        Device& mDevice;
+
+        std::unordered_map<std::string, TransientImage> mTransientImages;
+        std::vector<uint64_t> mTransientKey;            // what they were allocated for
+
+        std::unordered_map<uint64_t, CompiledGraph> mCompiledGraphs; // by hash of their key
+        std::vector<uint64_t> mKey;
+        uint64_t mLastHash = 0;
+        bool mShapeChanged = true;
     };
 }
@@ -0,0 +1,77 @@
+#include <PCH/pch.h>
+#include "ThreadCommandPools.h"
+
+#include "Core/Device.h"
+#include "Jobs/JobSystem.h"
+
+namespace Radis
+{
+    ThreadCommandPools::ThreadCommandPools(Device& device, uint32_t frameCount)
+        : mDevice(device)
+        , mThreadCount(JobSystem::GetWorkerCount() + 1)
+        , mPools(static_cast<size_t>(frameCount) * (JobSystem::GetWorkerCount() + 1))
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = device.GetGraphicsFamily();
+        // Reset as a whole each frame, never per buffer
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        for (ThreadPool& threadPool : mPools)
+        {
+            if (vkCreateCommandPool(device.GetDevice(), &poolInfo, nullptr, &threadPool.pool) != VK_SUCCESS)
+            {
+                RADIS_CRITICAL("Failed to create a thread command pool");
+            }
+        }
+    }
+
+    ThreadCommandPools::~ThreadCommandPools()
+    {
+        for (ThreadPool& threadPool : mPools)
+        {
+            // Frees its command buffers with it
+            vkDestroyCommandPool(mDevice.GetDevice(), threadPool.pool, nullptr);
+        }
+    }
+
+    void ThreadCommandPools::BeginFrame(uint32_t frameIndex)
+    {
+        for (uint32_t thread = 0; thread < mThreadCount; ++thread)
+        {
+            ThreadPool& threadPool = mPools[frameIndex * mThreadCount + thread];
+            if (threadPool.used == 0) continue;
+
+            vkResetCommandPool(mDevice.GetDevice(), threadPool.pool, 0);
+            threadPool.used = 0;
+        }
+    }
+
+    VkCommandBuffer ThreadCommandPools::Acquire(uint32_t frameIndex)
+    {
+        // Any other thread would share the main thread's pool (index 0) without synchronization
+        const uint32_t threadIndex = JobSystem::GetThreadIndex();
+        RADIS_ASSERT(threadIndex != 0 || JobSystem::IsMainThread(), "ThreadCommandPools::Acquire called from a thread the job system doesn't own");
+        RADIS_ASSERT(threadIndex < mThreadCount, "No command pool for this thread");
+
+        ThreadPool& threadPool = mPools[frameIndex * mThreadCount + threadIndex];
+        if (threadPool.used == threadPool.buffers.size())
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = threadPool.pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            if (vkAllocateCommandBuffers(mDevice.GetDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+            {
+                RADIS_CRITICAL("Failed to allocate a secondary command buffer");
+                return VK_NULL_HANDLE;
+            }
+            threadPool.buffers.push_back(commandBuffer);
+        }
+
+        return threadPool.buffers[threadPool.used++];
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace Radis
+{
+    // Forward reference
+    class Device;
+
+    // A command pool per job system thread and frame in flight, handing out secondary command
+    // buffers for parallel recording. A thread only ever touches its own pool, so recording needs
+    // no locks. Buffers are kept and reused; a frame's pools are reset wholesale once its
+    // submission has finished.
+    class ThreadCommandPools
+    {
+    public:
+        ThreadCommandPools(Device& device, uint32_t frameCount);
+        ~ThreadCommandPools();
+
+        ThreadCommandPools(const ThreadCommandPools&) = delete;
+        ThreadCommandPools& operator=(const ThreadCommandPools&) = delete;
+
+        // Takes back every buffer handed out for frameIndex. Its last submission must be complete.
+        void BeginFrame(uint32_t frameIndex);
+
+        // An unbegun secondary command buffer from the calling thread's pool, valid until the
+        // frame's next BeginFrame. Only the main thread and job system workers have a pool.
+        VkCommandBuffer Acquire(uint32_t frameIndex);
+
+    private:
+        // Padded to a cache line, neighbouring threads bump their counters at the same time
+        struct alignas(64) ThreadPool
+        {
+            VkCommandPool pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> buffers;
+            uint32_t used = 0;
+        };
+
+        Device& mDevice;
+        uint32_t mThreadCount = 0;
+        std::vector<ThreadPool> mPools; // frameIndex * mThreadCount + thread index
+    };
+}
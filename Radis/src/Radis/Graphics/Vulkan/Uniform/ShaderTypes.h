@@ -23,6 +23,9 @@ namespace Radis
         uint32_t indexOffset = 0;
         uint32_t vertexOffset = 0;
         uint32_t meshID = 777;
+        // Mesh space position = positionOffset + arena position * positionScale (xyz)
+        glm::vec4 positionOffset{ 0.f };
+        glm::vec4 positionScale{ 1.f };
 
         const static uint32_t MAX_INSTANCES = 10000;
     };
@@ -55,24 +58,23 @@ namespace Radis
         static const uint32_t MAX_LIGHTS = 1000;
     };
 
-    /*struct MeshDataUniform {
-        glm::vec3 position; float _padding1 = 777.0f;
-        glm::vec3 color;    float _padding2 = 777.0f;
-        glm::vec3 normal;   float _padding3 = 777.0f;
-        glm::vec2 texCoord; glm::vec2 _padding4 = glm::vec2(777.0f);
-    };*/
-
-    /*struct MeshDataUniform2 {
-        glm::vec4 positionColorR;
-        glm::vec4 colorGBnormalXY;
-        glm::vec3 normalZtexXY; uint32_t padding;
-    };*/
+    // Front of the clustered light grid buffer (see LightGrid). Followed by uint cells: a
+    // (first, count) pair per cluster, x fastest then y then depth slice, the directional light
+    // indices, then the per cluster light index lists the pairs point into.
+    struct LightGridHeader
+    {
+        glm::uvec4 gridSize;   // tiles x, tiles y, depth slices, directional light count
+        glm::vec4 depthParams; // slice = log(view depth) * x + y, then the near and far planes
+    };
 
+    // Ray tracing's view of the arena's static stream, laid out like PackedVertex so the unified
+    // mesh's CPU mirror goes up as is. Decoded in the hit shaders.
     struct MeshDataUniform
     {
-        float posX, posY, posZ;
-        float colorR, colorG, colorB;
-        float normalX, normalY, normalZ;
-        float texU, texV; float _padding = 777.0f;
+        uint32_t positionXY; // unorm16 x2, dequantized with the instance's positionOffset/Scale
+        uint32_t positionZW;
+        uint32_t normal;     // octahedral snorm16 x2
+        uint32_t uv;         // half x2
+        uint32_t color;      // unorm8 x4
     };
 }
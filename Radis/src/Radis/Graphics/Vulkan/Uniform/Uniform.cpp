@@ -8,6 +8,8 @@
 #include "../Core/SwapChain.h"
 #include "../Core/Buffer.h"
 #include "../Core/AccelerationStructures.h"
+#include "../VKRingBuffer.h"
+#include "../VKInstanceTable.h"
 
 
 namespace Radis
@@ -47,7 +49,9 @@ namespace Radis
             {
                 if (bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
                     bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
-                    bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR)
+                    bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR ||
+                    bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC ||
+                    !bindingInfo.buffered)
                 {
                     continue; // No buffer needed
                 }
@@ -76,7 +80,14 @@ namespace Radis
             }
 
             mBuffersPerBinding[bindingInfo.layoutBinding.binding] = std::move(buffers);
+
+            if (bindingInfo.layoutBinding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+            {
+                mDynamicBindings.push_back(bindingInfo.layoutBinding.binding);
+            }
         }
+        std::sort(mDynamicBindings.begin(), mDynamicBindings.end());
+        mDynamicOffsets.resize(mDynamicBindings.size(), 0);
 
         DescriptorSetLayout::Builder layoutBuilder(device);
         for (const auto& bindingInfo : settings.bindings)
@@ -90,6 +101,23 @@ namespace Radis
 
     void Uniform::Bind(VkCommandBuffer& commandBuffer, VkPipelineLayout& pipelineLayout, int frameIndex, VkPipelineBindPoint bindPoint)
     {
+        {
+            // Parallel passes bind from several threads, the first one in rewrites the set before
+            // any of them records it
+            std::scoped_lock lock(mRewriteMutex);
+
+            // The ring grows while systems write into it, before anything binds this frame's set
+            if (mRingBuffer && mRingVersions[frameIndex] != mRingBuffer->GetVersion(frameIndex))
+            {
+                WriteRingBindings(frameIndex);
+            }
+            // Replaced when the table grows, after a device wait
+            if (mInstanceTable && mTableVersions[frameIndex] != mInstanceTable->GetVersion())
+            {
+                WriteInstanceTableBinding(frameIndex);
+            }
+        }
+
         vkCmdBindDescriptorSets(
             commandBuffer,
             bindPoint,
@@ -97,8 +125,85 @@ namespace Radis
             mPipelineBindingIndex,
             1,
             &mUniformDescriptorSets[frameIndex],
-            0,
-            nullptr);
+            static_cast<uint32_t>(mDynamicOffsets.size()),
+            mDynamicOffsets.data());
+    }
+
+    void Uniform::SetRingBuffer(VKRingBuffer* ringBuffer)
+    {
+        mRingBuffer = ringBuffer;
+        mRingVersions.assign(mUniformDescriptorSets.size(), 0);
+        for (int frameIndex = 0; frameIndex < static_cast<int>(mUniformDescriptorSets.size()); ++frameIndex)
+        {
+            WriteRingBindings(frameIndex);
+        }
+    }
+
+    void Uniform::SetInstanceTable(uint32_t binding, VKInstanceTable* instanceTable)
+    {
+        mInstanceTable = instanceTable;
+        mInstanceTableBinding = binding;
+        mTableVersions.assign(mUniformDescriptorSets.size(), 0);
+        for (int frameIndex = 0; frameIndex < static_cast<int>(mUniformDescriptorSets.size()); ++frameIndex)
+        {
+            WriteInstanceTableBinding(frameIndex);
+        }
+    }
+
+    void Uniform::SetDynamicOffset(uint32_t binding, uint32_t offset)
+    {
+        auto it = std::lower_bound(mDynamicBindings.begin(), mDynamicBindings.end(), binding);
+        if (it == mDynamicBindings.end() || *it != binding)
+        {
+            RADIS_ERROR("Binding {} is not a dynamic binding", binding);
+            return;
+        }
+        mDynamicOffsets[it - mDynamicBindings.begin()] = offset;
+    }
+
+    void Uniform::WriteRingBindings(int frameIndex)
+    {
+        if (!mRingBuffer || mDynamicBindings.empty())
+        {
+            return;
+        }
+
+        const VkDescriptorBufferInfo bufferInfo{
+            .buffer = mRingBuffer->GetBuffer(frameIndex).buffer,
+            .offset = 0,
+            .range = mRingBuffer->GetBindingRange(frameIndex)
+        };
+        std::vector<VkDescriptorBufferInfo> bufferInfos(mDynamicBindings.size(), bufferInfo);
+
+        DescriptorWriter writer(*mUniformDescriptorLayout, *mUniformPool);
+        for (size_t i = 0; i < mDynamicBindings.size(); ++i)
+        {
+            writer.WriteBuffer(mDynamicBindings[i], &bufferInfos[i]);
+        }
+        writer.Overwrite(mUniformDescriptorSets[frameIndex]);
+
+        mRingVersions[frameIndex] = mRingBuffer->GetVersion(frameIndex);
+    }
+
+    void Uniform::WriteInstanceTableBinding(int frameIndex)
+    {
+        if (!mInstanceTable)
+        {
+            return;
+        }
+
+        const Buffer& buffer = mInstanceTable->GetBuffer();
+        const VkDescriptorBufferInfo bufferInfo{
+            .buffer = buffer.buffer,
+            .offset = 0,
+            .range = buffer.bufferSize
+        };
+
+        DescriptorWriter writer(*mUniformDescriptorLayout, *mUniformPool);
+        writer.WriteBuffer(mInstanceTableBinding, &bufferInfo);
+        writer.Overwrite(mUniformDescriptorSets[frameIndex]);
+
+        mTableVersions[frameIndex] = mInstanceTable->GetVersion();
     }
 
     Uniform::~Uniform()
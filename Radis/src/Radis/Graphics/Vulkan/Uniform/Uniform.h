@@ -19,6 +19,8 @@ namespace Radis
     struct RenderingResource;
     class DescriptorPool;
     class DescriptorSetLayout;
+    class VKRingBuffer;
+    class VKInstanceTable;
 
     class Uniform {
     public:
@@ -42,6 +44,31 @@ namespace Radis
          *********************************************************************/
         void Bind(VkCommandBuffer& commandBuffer, VkPipelineLayout& pipelineLayout, int frameIndex, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 
+        /*********************************************************************
+         * param:  ringBuffer: The frame ring buffer
+         *
+         * brief:  Points every dynamic binding at the ring buffer's frame slots.
+         *         Bind rewrites them when a slot's buffer gets replaced.
+         *********************************************************************/
+        void SetRingBuffer(VKRingBuffer* ringBuffer);
+
+        /*********************************************************************
+         * param:  binding: An external storage buffer binding
+         * param:  instanceTable: The instance table
+         *
+         * brief:  Points binding at the instance table in every frame's set.
+         *         Bind rewrites it when the table's buffer gets replaced.
+         *********************************************************************/
+        void SetInstanceTable(uint32_t binding, VKInstanceTable* instanceTable);
+
+        /*********************************************************************
+         * param:  binding: A dynamic binding
+         * param:  offset: This frame's offset into the ring buffer
+         *
+         * brief:  Sets where a dynamic binding reads from on the next Bind
+         *********************************************************************/
+        void SetDynamicOffset(uint32_t binding, uint32_t offset);
+
         /*********************************************************************
          * brief:  Sets the uniform's data
          *********************************************************************/
@@ -74,6 +101,9 @@ namespace Radis
         std::vector<VkDescriptorSetLayoutBinding>& GetRayTracingBindings() { return rayTracingBindings; }
 
     private:
+        void WriteRingBindings(int frameIndex);
+        void WriteInstanceTableBinding(int frameIndex);
+
         std::unordered_map<int, std::vector<Buffer>> mBuffersPerBinding;
         std::vector<VkDescriptorSet> mUniformDescriptorSets;
         std::unique_ptr<DescriptorPool> mUniformPool;
@@ -81,6 +111,16 @@ namespace Radis
         unsigned int mPipelineBindingIndex = std::numeric_limits<unsigned int>::max();
         Device& mDevice;
 
+        // Dynamic bindings in binding order, which is the order vkCmdBindDescriptorSets takes offsets in
+        std::vector<uint32_t> mDynamicBindings;
+        std::vector<uint32_t> mDynamicOffsets;
+        VKRingBuffer* mRingBuffer = nullptr;
+        std::vector<uint32_t> mRingVersions; // ring buffer version each frame's set was written with
+        VKInstanceTable* mInstanceTable = nullptr;
+        uint32_t mInstanceTableBinding = 0;
+        std::vector<uint32_t> mTableVersions; // instance table version each frame's set was written with
+        std::mutex mRewriteMutex;
+
         std::vector<VkDescriptorSetLayoutBinding> rasterBindings;
         std::vector<VkDescriptorSetLayoutBinding> rayTracingBindings;
     };
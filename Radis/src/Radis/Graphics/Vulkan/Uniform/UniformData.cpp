@@ -9,6 +9,8 @@
 #include "../Core/SwapChain.h"
 
 #include "../Texture/VKTexture.h"
+#include "../VKRingBuffer.h"
+#include "../VKInstanceTable.h"
 
 namespace Radis
 {
@@ -45,84 +47,33 @@ namespace Radis
         {
             DescriptorWriter writer(*uniform.GetDescriptorLayout(), *uniform.GetDescriptorPool());
 
-            // Bind uniform buffers (0-2) directly
+            // Camera buffer directly, instances (1) live in the instance table, bones (2), lights (4),
+            // the visible instance slots (5) and the light grid (6) in the frame ring
             const Buffer& ubuf0 = uniform.GetUniformBuffer(0, frameIndex);
-            const Buffer& ubuf1 = uniform.GetUniformBuffer(1, frameIndex);
-            const Buffer& ubuf2 = uniform.GetUniformBuffer(2, frameIndex);
-            const Buffer& ubuf4 = uniform.GetUniformBuffer(4, frameIndex);
 
             VkDescriptorBufferInfo bufferInfo0{
                 .buffer = ubuf0.buffer,
                 .range = ubuf0.bufferSize
             };
-            VkDescriptorBufferInfo bufferInfo1{
-                .buffer = ubuf1.buffer,
-                .range = ubuf1.bufferSize
-            };
-            VkDescriptorBufferInfo bufferInfo2{
-                .buffer = ubuf2.buffer,
-                .range = ubuf2.bufferSize
-            };
-            VkDescriptorBufferInfo bufferInfo4{
-                .buffer = ubuf4.buffer,
-                .range = ubuf4.bufferSize
-            };
 
             writer.WriteBuffer(0, &bufferInfo0);
-            writer.WriteBuffer(1, &bufferInfo1);
-            writer.WriteBuffer(2, &bufferInfo2);
             writer.WriteImage(3, imageInfos.data(), static_cast<uint32_t>(imageInfos.size()));
-            writer.WriteBuffer(4, &bufferInfo4);
 
             writer.Build(uniform.GetDescriptorSets()[frameIndex]);
         }
+
+        uniform.SetRingBuffer(static_cast<VKRingBuffer*>(renderData.frameRing.get()));
+        uniform.SetInstanceTable(1, static_cast<VKInstanceTable*>(renderData.instanceTable.get()));
     }
 
     void RTUniformInit(Uniform& uniform, RenderingResource& renderData)
     {
-        uint32_t width = renderData.swapChain->GetSwapChainExtent().width;
-        uint32_t height = renderData.swapChain->GetSwapChainExtent().height;
-        VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        VkImageUsageFlags usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
-            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-        VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL;
-
-        // Create a vector to hold the pointers to our new textures
-        std::vector<VKTexture*> rtTextures(SwapChain::MAX_FRAMES_IN_FLIGHT * 2);
-
-        // Loop and create one texture for each frame
-        for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
-        {
-            // Give each texture a unique name
-            std::string texName = "RTColorImage_" + std::to_string(i);
-            uint32_t rtInd = renderData.textureLibrary->CreateStorageImage(texName, width, height, format, usage, layout);
-            rtTextures[i] = static_cast<VKTexture*>(renderData.textureLibrary->GetTexture(rtInd));
-        }
-        for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; ++i)
-        {
-            // Give each texture a unique name
-            std::string texName = "RTHeatmapImage_" + std::to_string(i);
-            uint32_t rtInd = renderData.textureLibrary->CreateStorageImage(texName, width, height, format, usage, layout);
-            rtTextures[i + SwapChain::MAX_FRAMES_IN_FLIGHT] = static_cast<VKTexture*>(renderData.textureLibrary->GetTexture(rtInd));
-        }
-
         uniform.GetDescriptorSets().resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
 
-        // This info struct will be updated inside the loop
-        VkDescriptorImageInfo outImageInfo{};
-        outImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // storage image layout
-        outImageInfo.sampler = VK_NULL_HANDLE; // storage images donft use samplers
-        VkDescriptorImageInfo outImageInfo2{};
-        outImageInfo2.imageLayout = VK_IMAGE_LAYOUT_GENERAL; // storage image layout
-        outImageInfo2.sampler = VK_NULL_HANDLE; // storage images donft use samplers
-
-        // Build descriptor sets for each frame
+        // Build descriptor sets for each frame. The output images (bindings 1 and 2) are render
+        // graph transients, RenderSystem::RaytraceSceneVK writes them every frame.
         for (int frameIndex = 0; frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT; ++frameIndex)
         {
-            outImageInfo.imageView = rtTextures[frameIndex]->GetImageView();
-            outImageInfo2.imageView = rtTextures[frameIndex + SwapChain::MAX_FRAMES_IN_FLIGHT]->GetImageView();
-
             DescriptorWriter writer(*uniform.GetDescriptorLayout(), *uniform.GetDescriptorPool());
 
             const Buffer& ubuf2 = uniform.GetUniformBuffer(3, frameIndex);
@@ -136,8 +87,6 @@ namespace Radis
                 .range = ubuf3.bufferSize
             };
 
-            writer.WriteImage(1, &outImageInfo);
-            writer.WriteImage(2, &outImageInfo2);
             writer.WriteBuffer(3, &bufferInfo2);
             writer.WriteBuffer(4, &bufferInfo3);
 
@@ -21,10 +21,12 @@ namespace Radis
 
     const UniformSettings cameraUniformSettings = UniformSettings(CameraUniformInit)
         .AddUBBinding(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags, sizeof(CameraUniforms)).SetDebugName("Camera Uniforms")
-        .AddSSBOBinding(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags, sizeof(InstanceUniforms), InstanceUniforms::MAX_INSTANCES).SetDebugName("Instance SSBO")
-        .AddSSBOBinding(VK_SHADER_STAGE_VERTEX_BIT, sizeof(VQS), 10000).SetDebugName("Animation SSBO")
+        .AddExternalSSBOBinding(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags).SetDebugName("Instance Table SSBO")
+        .AddDynamicSSBOBinding(VK_SHADER_STAGE_VERTEX_BIT).SetDebugName("Animation SSBO")
         .AddISBinding(VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags, TextureLibrary::MAX_TEXTURE_COUNT).SetDebugName("Texture SSBO")
-        .AddSSBOBinding(VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags, sizeof(LightUniform) * 10000 + sizeof(uint32_t)).SetDebugName("Light SSBO");
+        .AddDynamicSSBOBinding(VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags).SetDebugName("Light SSBO")
+        .AddDynamicSSBOBinding(VK_SHADER_STAGE_VERTEX_BIT).SetDebugName("Visible Instance SSBO")
+        .AddDynamicSSBOBinding(VK_SHADER_STAGE_FRAGMENT_BIT | rtFlags).SetDebugName("Light Grid SSBO");
 
     const UniformSettings rayTracingUniformSettings = UniformSettings(RTUniformInit)
         .AddASBinding(rtFlags, 1).SetDebugName("RT TLAS Buffer")
@@ -41,6 +41,20 @@ namespace Radis
             return *this;
         }
 
+        // Storage buffer bound at a per-frame offset into the frame ring buffer, owns no buffer itself
+        UniformSettings& AddDynamicSSBOBinding(VkShaderStageFlags stageFlags)
+        {
+            bindings.push_back({ { nextBinding++, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, stageFlags }, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, 0, false, false });
+            return *this;
+        }
+
+        // Storage buffer owned by someone else (the instance table), pointed at with Uniform::SetInstanceTable
+        UniformSettings& AddExternalSSBOBinding(VkShaderStageFlags stageFlags)
+        {
+            bindings.push_back({ { nextBinding++, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stageFlags }, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0, 0, false, false });
+            return *this;
+        }
+
         UniformSettings& AddSSBOIndirectBinding(VkShaderStageFlags stageFlags, size_t elementSize, size_t elementCount, bool buffered = true, bool doubleBuffered = true)
         {
             bindings.push_back({ { nextBinding++, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, stageFlags }, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, elementSize, elementCount, buffered, doubleBuffered });
@@ -0,0 +1,91 @@
+#include <PCH/pch.h>
+#include "VKInstanceTable.h"
+#include "VKRingBuffer.h"
+
+#include "Core/Device.h"
+#include "Core/Allocator.h"
+
+namespace Radis
+{
+    VKInstanceTable::VKInstanceTable(Device& device)
+        : mDevice(device)
+    {
+        CreateStorage();
+    }
+
+    VKInstanceTable::~VKInstanceTable()
+    {
+        Allocator::DestroyBuffer(mBuffer);
+    }
+
+    bool VKInstanceTable::Reallocate(uint32_t newCapacity)
+    {
+        // Frames in flight still read the old table. Only happens while the scene grows past a
+        // power of two, so waiting beats keeping retired buffers around.
+        if (mBuffer.buffer)
+        {
+            vkDeviceWaitIdle(mDevice.GetDevice());
+            Allocator::DestroyBuffer(mBuffer);
+        }
+
+        Allocator::CreateBuffer(
+            mBuffer,
+            static_cast<VkDeviceSize>(newCapacity) * sizeof(InstanceUniforms),
+            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT_KHR
+        );
+        Allocator::SetAllocationName(mBuffer.allocation, "Instance Table");
+
+        ++mVersion;
+        mPendingCopies.clear();
+        return false;
+    }
+
+    void VKInstanceTable::Upload(FrameRingBuffer& ring, const std::vector<UploadRun>& runs)
+    {
+        // The ring slot may still grow this frame, its buffer is looked up again when recording
+        mPendingCopies.clear();
+        for (const UploadRun& run : runs)
+        {
+            mPendingCopies.push_back({
+                .srcOffset = run.ringOffset,
+                .dstOffset = static_cast<VkDeviceSize>(run.firstSlot) * sizeof(InstanceUniforms),
+                .size = static_cast<VkDeviceSize>(run.count) * sizeof(InstanceUniforms)
+            });
+        }
+    }
+
+    void VKInstanceTable::RecordUpload(VkCommandBuffer cmd, const VKRingBuffer& ring)
+    {
+        if (mPendingCopies.empty())
+        {
+            return;
+        }
+
+        // Earlier frames may still be reading the slots about to be overwritten. Everything that
+        // reads the table (raster, ray tracing, compute) comes after, so all commands it is.
+        VkMemoryBarrier2 barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .srcAccessMask = VK_ACCESS_2_NONE,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT
+        };
+        VkDependencyInfo dependencyInfo{
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &barrier
+        };
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+
+        const VkBuffer source = ring.GetBuffer(ring.GetFrameIndex()).buffer;
+        vkCmdCopyBuffer(cmd, source, mBuffer.buffer, static_cast<uint32_t>(mPendingCopies.size()), mPendingCopies.data());
+
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+
+        mPendingCopies.clear();
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Graphics/Common/InstanceTable.h"
+#include "Core/Buffer.h"
+
+namespace Radis
+{
+    // Forward reference
+    class Device;
+    class VKRingBuffer;
+
+    // Device local storage buffer the draws read instances from. Flush only queues the copies,
+    // RecordUpload issues them from the frame ring inside a render graph pass ahead of every pass
+    // that reads the table.
+    class VKInstanceTable : public InstanceTable
+    {
+    public:
+        VKInstanceTable(Device& device);
+        ~VKInstanceTable();
+
+        const Buffer& GetBuffer() const { return mBuffer; }
+        // Bumped whenever the buffer is replaced, descriptors pointing at it need rewriting
+        uint32_t GetVersion() const { return mVersion; }
+
+        bool HasPendingUpload() const { return !mPendingCopies.empty(); }
+        void RecordUpload(VkCommandBuffer cmd, const VKRingBuffer& ring);
+
+    protected:
+        bool Reallocate(uint32_t newCapacity) override;
+        void Upload(FrameRingBuffer& ring, const std::vector<UploadRun>& runs) override;
+
+    private:
+        Device& mDevice;
+        Buffer mBuffer{};
+        uint32_t mVersion = 0;
+
+        std::vector<VkBufferCopy> mPendingCopies;
+    };
+}
@@ -111,13 +111,160 @@ namespace Radis
         Allocator::DestroyBuffer(staging);
     }
 
+    void VKMesh::ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity)
+    {
+        if (vertexCapacity <= mVertexCapacity && indexCapacity <= mIndexCapacity)
+        {
+            return;
+        }
+        vertexCapacity = std::max(vertexCapacity, mVertexCapacity);
+        indexCapacity = std::max(indexCapacity, mIndexCapacity);
+
+        Buffer newVertexBuffer{};
+        Allocator::CreateBuffer(
+            newVertexBuffer,
+            sizeof(PackedVertex) * vertexCapacity,
+            VK_BUFFER_USAGE_2_VERTEX_BUFFER_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_DST_BIT_KHR,
+            VMA_MEMORY_USAGE_GPU_ONLY
+        );
+        Allocator::SetAllocationName(newVertexBuffer.allocation, "Geometry Arena Vertices");
+
+        Buffer newSkinBuffer{};
+        Allocator::CreateBuffer(
+            newSkinBuffer,
+            sizeof(SkinVertex) * vertexCapacity,
+            VK_BUFFER_USAGE_2_VERTEX_BUFFER_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_DST_BIT_KHR,
+            VMA_MEMORY_USAGE_GPU_ONLY
+        );
+        Allocator::SetAllocationName(newSkinBuffer.allocation, "Geometry Arena Skinning");
+
+        Buffer newIndexBuffer{};
+        Allocator::CreateBuffer(
+            newIndexBuffer,
+            sizeof(uint32_t) * indexCapacity,
+            VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT_KHR |
+            VK_BUFFER_USAGE_2_TRANSFER_DST_BIT_KHR |
+            VK_BUFFER_USAGE_2_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+            VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT_KHR,
+            VMA_MEMORY_USAGE_GPU_ONLY
+        );
+        Allocator::SetAllocationName(newIndexBuffer.allocation, "Geometry Arena Indices");
+
+        // Carry the old contents over, GPU to GPU
+        if (mVertexCapacity > 0 || mIndexCapacity > 0)
+        {
+            // Frames in flight may still be drawing from the old buffers
+            vkDeviceWaitIdle(device->GetDevice());
+
+            VkCommandBuffer commandBuffer = device->BeginSingleTimeCommands();
+            if (mVertexCapacity > 0)
+            {
+                VkBufferCopy vertexCopy{ 0, 0, sizeof(PackedVertex) * mVertexCapacity };
+                vkCmdCopyBuffer(commandBuffer, mVertexBuffer.buffer, newVertexBuffer.buffer, 1, &vertexCopy);
+                VkBufferCopy skinCopy{ 0, 0, sizeof(SkinVertex) * mVertexCapacity };
+                vkCmdCopyBuffer(commandBuffer, mSkinBuffer.buffer, newSkinBuffer.buffer, 1, &skinCopy);
+            }
+            if (mIndexCapacity > 0)
+            {
+                VkBufferCopy indexCopy{ 0, 0, sizeof(uint32_t) * mIndexCapacity };
+                vkCmdCopyBuffer(commandBuffer, mIndexBuffer.buffer, newIndexBuffer.buffer, 1, &indexCopy);
+            }
+            device->EndSingleTimeCommands(commandBuffer);
+
+            DestroyBuffers();
+        }
+
+        mVertexBuffer = newVertexBuffer;
+        mSkinBuffer = newSkinBuffer;
+        mIndexBuffer = newIndexBuffer;
+        mVertexCapacity = vertexCapacity;
+        mIndexCapacity = indexCapacity;
+        mHasIndexBuffer = true;
+    }
+
+    void VKMesh::UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads)
+    {
+        VkDeviceSize stagingSize = 0;
+        for (const MeshRangeUpload& upload : uploads)
+        {
+            stagingSize += (sizeof(PackedVertex) + sizeof(SkinVertex)) * upload.vertexCount + sizeof(uint32_t) * upload.indexCount;
+        }
+        if (stagingSize == 0) return;
+
+        // One staging buffer and one submit for the whole batch
+        Buffer staging{};
+        Allocator::CreateBuffer(
+            staging,
+            stagingSize,
+            VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT_KHR,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        );
+        Allocator::SetAllocationName(staging.allocation, "Geometry Arena Staging");
+
+        if (!staging.mapping)
+        {
+            RADIS_CRITICAL("Failed to map geometry staging memory!");
+            return;
+        }
+
+        std::vector<VkBufferCopy> vertexCopies;
+        std::vector<VkBufferCopy> skinCopies;
+        std::vector<VkBufferCopy> indexCopies;
+        VkDeviceSize stagingOffset = 0;
+        for (const MeshRangeUpload& upload : uploads)
+        {
+            if (upload.vertexCount > 0)
+            {
+                const VkDeviceSize size = sizeof(PackedVertex) * upload.vertexCount;
+                memcpy(staging.mapping + stagingOffset, upload.vertices, static_cast<size_t>(size));
+                vertexCopies.push_back({ stagingOffset, sizeof(PackedVertex) * upload.firstVertex, size });
+                stagingOffset += size;
+
+                const VkDeviceSize skinSize = sizeof(SkinVertex) * upload.vertexCount;
+                memcpy(staging.mapping + stagingOffset, upload.skin, static_cast<size_t>(skinSize));
+                skinCopies.push_back({ stagingOffset, sizeof(SkinVertex) * upload.firstVertex, skinSize });
+                stagingOffset += skinSize;
+            }
+            if (upload.indexCount > 0)
+            {
+                const VkDeviceSize size = sizeof(uint32_t) * upload.indexCount;
+                memcpy(staging.mapping + stagingOffset, upload.indices, static_cast<size_t>(size));
+                indexCopies.push_back({ stagingOffset, sizeof(uint32_t) * upload.firstIndex, size });
+                stagingOffset += size;
+            }
+        }
+
+        VkCommandBuffer commandBuffer = device->BeginSingleTimeCommands();
+        if (!vertexCopies.empty())
+        {
+            vkCmdCopyBuffer(commandBuffer, staging.buffer, mVertexBuffer.buffer, static_cast<uint32_t>(vertexCopies.size()), vertexCopies.data());
+            vkCmdCopyBuffer(commandBuffer, staging.buffer, mSkinBuffer.buffer, static_cast<uint32_t>(skinCopies.size()), skinCopies.data());
+        }
+        if (!indexCopies.empty())
+        {
+            vkCmdCopyBuffer(commandBuffer, staging.buffer, mIndexBuffer.buffer, static_cast<uint32_t>(indexCopies.size()), indexCopies.data());
+        }
+        device->EndSingleTimeCommands(commandBuffer);
+
+        Allocator::DestroyBuffer(staging);
+    }
+
     void VKMesh::DestroyBuffers()
     {
         Allocator::DestroyBuffer(mVertexBuffer);
+        Allocator::DestroyBuffer(mSkinBuffer);
         if (mHasIndexBuffer)
         {
             Allocator::DestroyBuffer(mIndexBuffer);
         }
+        mVertexCapacity = 0;
+        mIndexCapacity = 0;
     }
 
     void VKMesh::Bind(VkCommandBuffer commandBuffer)
@@ -134,9 +281,10 @@ namespace Radis
             return;
         }
 
-        VkBuffer buffers[] = { mVertexBuffer.buffer };
-        VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+        // Arena meshes have the skinning stream as a second binding
+        VkBuffer buffers[] = { mVertexBuffer.buffer, mSkinBuffer.buffer };
+        VkDeviceSize offsets[] = { 0, 0 };
+        vkCmdBindVertexBuffers(commandBuffer, 0, mSkinBuffer.buffer ? 2 : 1, buffers, offsets);
         vkCmdBindIndexBuffer(commandBuffer, mIndexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
     }
 
@@ -151,35 +299,36 @@ namespace Radis
         vkCmdDrawIndexed(commandBuffer, mIndexCount, 1, 0, 0, baseIndex);
     }
 
-    std::vector<VkVertexInputBindingDescription> Vertex::GetBindingDescriptions()
+    std::vector<VkVertexInputBindingDescription> PackedVertex::GetBindingDescriptions()
     {
-        std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions(2);
 
         //Set bind description data
         bindingDescriptions[0].binding = 0;                             
-        bindingDescriptions[0].stride = sizeof(Vertex);                 
+        bindingDescriptions[0].stride = sizeof(PackedVertex);                 
         bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX; 
 
-        //bindingDescriptions[1].binding = 1;
-        //bindingDescriptions[1].stride = sizeof(InstanceUniforms);
-        //bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        bindingDescriptions[1].binding = 1;
+        bindingDescriptions[1].stride = sizeof(SkinVertex);
+        bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
         //Return description
         return bindingDescriptions;
     }
 
-    std::vector<VkVertexInputAttributeDescription> Vertex::GetAttributeDescriptions()
+    std::vector<VkVertexInputAttributeDescription> PackedVertex::GetAttributeDescriptions()
     {
         //Create a vector of attribute descriptions
         std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
 
-        // Per vertex
-        attributeDescriptions.push_back({ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) });
-        attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color) });
-        attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal) });
-        attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) });
-        attributeDescriptions.push_back({ 4, 0, VK_FORMAT_R32G32B32A32_SINT, offsetof(Vertex, boneIDs) });
-        attributeDescriptions.push_back({ 5, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(Vertex, weights) });
+        // Static stream
+        attributeDescriptions.push_back({ 0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, position) });
+        attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color) });
+        attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal) });
+        attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, uv) });
+        // Skinning stream
+        attributeDescriptions.push_back({ 4, 1, VK_FORMAT_R8G8B8A8_UINT, offsetof(SkinVertex, boneIDs) });
+        attributeDescriptions.push_back({ 5, 1, VK_FORMAT_R8G8B8A8_UNORM, offsetof(SkinVertex, weights) });
 
         //Return description
         return attributeDescriptions;
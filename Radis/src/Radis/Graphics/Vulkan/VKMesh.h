@@ -16,7 +16,14 @@ namespace Radis
         void CreateIndexBuffers(Device* device);
         void DestroyBuffers() override;
 
+        void ReserveBuffers(Device* device, uint32_t vertexCapacity, uint32_t indexCapacity) override;
+        void UploadRanges(Device* device, const std::vector<MeshRangeUpload>& uploads) override;
+
         void Bind(VkCommandBuffer commandBuffer);
         void Draw(VkCommandBuffer commandBuffer, uint32_t baseIndex = 0);
+
+    private:
+        // Arena only: the SkinVertex stream next to the PackedVertex one in mVertexBuffer
+        Buffer mSkinBuffer;
     };
 }
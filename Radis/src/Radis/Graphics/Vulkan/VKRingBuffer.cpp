@@ -0,0 +1,112 @@
+#include <PCH/pch.h>
+#include "VKRingBuffer.h"
+
+#include "Core/Device.h"
+#include "Core/Allocator.h"
+
+namespace Radis
+{
+    VKRingBuffer::VKRingBuffer(Device& device, uint32_t frameCount)
+        : FrameRingBuffer(
+            frameCount,
+            static_cast<uint32_t>(device.properties.limits.minStorageBufferOffsetAlignment),
+            std::min(device.properties.limits.maxStorageBufferRange, UINT32_MAX / 2))
+        , mBuffers(frameCount)
+        , mVersions(frameCount, 0)
+        , mWrittenFrom(frameCount, 0)
+        , mPendingCopies(frameCount)
+        , mRetiredBuffers(frameCount)
+    {
+        CreateSlots();
+    }
+
+    VKRingBuffer::~VKRingBuffer()
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(mBuffers.size()); ++i)
+        {
+            for (PendingCopy& copy : mPendingCopies[i]) Allocator::DestroyBuffer(copy.source);
+            for (Buffer& buffer : mRetiredBuffers[i]) Allocator::DestroyBuffer(buffer);
+            Allocator::DestroyBuffer(mBuffers[i]);
+        }
+    }
+
+    void VKRingBuffer::BeginFrame(uint32_t frameIndex)
+    {
+        // The slot's fence was waited on, the copies out of its old buffers are done. Copies that
+        // were never recorded belonged to a frame that wasn't rendered.
+        for (PendingCopy& copy : mPendingCopies[frameIndex]) Allocator::DestroyBuffer(copy.source);
+        for (Buffer& buffer : mRetiredBuffers[frameIndex]) Allocator::DestroyBuffer(buffer);
+        mPendingCopies[frameIndex].clear();
+        mRetiredBuffers[frameIndex].clear();
+        mWrittenFrom[frameIndex] = 0;
+
+        FrameRingBuffer::BeginFrame(frameIndex);
+    }
+
+    void VKRingBuffer::RecordPendingCopies(VkCommandBuffer cmd)
+    {
+        std::vector<PendingCopy>& copies = mPendingCopies[mFrameIndex];
+        if (copies.empty())
+        {
+            return;
+        }
+
+        // The sources were only written by the host, the submission makes that visible
+        const VkBuffer destination = mBuffers[mFrameIndex].buffer;
+        for (PendingCopy& copy : copies)
+        {
+            const VkBufferCopy region{ copy.begin, copy.begin, copy.end - copy.begin };
+            vkCmdCopyBuffer(cmd, copy.source.buffer, destination, 1, &region);
+            mRetiredBuffers[mFrameIndex].push_back(copy.source);
+        }
+        copies.clear();
+
+        // Shaders read the slot, the instance table upload copies out of it
+        VkMemoryBarrier2 barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT
+        };
+        VkDependencyInfo dependencyInfo{
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &barrier
+        };
+        vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+    }
+
+    uint8_t* VKRingBuffer::Reallocate(uint32_t frameIndex, uint32_t newCapacity, uint32_t usedBytes)
+    {
+        Buffer buffer{};
+        Allocator::CreateBuffer(
+            buffer,
+            static_cast<VkDeviceSize>(newCapacity) * 2,
+            VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR | VK_BUFFER_USAGE_2_TRANSFER_SRC_BIT_KHR | VK_BUFFER_USAGE_2_TRANSFER_DST_BIT_KHR,
+            VMA_MEMORY_USAGE_AUTO,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        );
+        std::string dbgName = "Frame Ring Buffer " + std::to_string(frameIndex);
+        Allocator::SetAllocationName(buffer.allocation, dbgName.c_str());
+
+        // Only the slot being written grows, and its fence was waited on in BeginFrame, so the old
+        // buffer isn't in use by earlier frames. What this frame wrote into it is copied on the GPU,
+        // reading it back here would go through write-combined memory. Earlier buffers of this
+        // frame already have copies queued for the bytes before mWrittenFrom.
+        Buffer& oldBuffer = mBuffers[frameIndex];
+        if (oldBuffer.buffer && usedBytes > mWrittenFrom[frameIndex])
+        {
+            mPendingCopies[frameIndex].push_back({ oldBuffer, mWrittenFrom[frameIndex], usedBytes });
+        }
+        else
+        {
+            Allocator::DestroyBuffer(oldBuffer);
+        }
+        mWrittenFrom[frameIndex] = usedBytes;
+
+        oldBuffer = buffer;
+        ++mVersions[frameIndex];
+        return buffer.mapping;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Graphics/Common/FrameRingBuffer.h"
+#include "Core/Buffer.h"
+
+namespace Radis
+{
+    // Forward reference
+    class Device;
+
+    // One host visible storage buffer per frame in flight, bound through dynamic storage
+    // descriptors. A dynamic descriptor has a fixed range that every offset is added to, so each
+    // buffer is twice the slot capacity and the range is the capacity: any offset the slot hands
+    // out plus the range stays inside the buffer.
+    // The mapping is write-combined, so growing never reads it back: what was written before the
+    // slot grew is copied over on the GPU, ahead of everything that reads the slot this frame.
+    class VKRingBuffer : public FrameRingBuffer
+    {
+    public:
+        VKRingBuffer(Device& device, uint32_t frameCount);
+        ~VKRingBuffer();
+
+        void BeginFrame(uint32_t frameIndex) override;
+
+        // The current slot grew this frame and its old contents still have to be copied over
+        bool HasPendingCopies() const { return !mPendingCopies[mFrameIndex].empty(); }
+        // Records those copies, must come before anything in the frame reads the slot
+        void RecordPendingCopies(VkCommandBuffer cmd);
+
+        const Buffer& GetBuffer(uint32_t frameIndex) const { return mBuffers[frameIndex]; }
+        uint32_t GetBindingRange(uint32_t frameIndex) const { return mSlots[frameIndex].capacity; }
+        // Bumped whenever the slot's buffer is replaced, descriptors pointing at it need rewriting
+        uint32_t GetVersion(uint32_t frameIndex) const { return mVersions[frameIndex]; }
+
+    protected:
+        uint8_t* Reallocate(uint32_t frameIndex, uint32_t newCapacity, uint32_t usedBytes) override;
+
+    private:
+        // A buffer the slot grew out of and the bytes in it that were written before it did
+        struct PendingCopy
+        {
+            Buffer source;
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        std::vector<Buffer> mBuffers;
+        std::vector<uint32_t> mVersions;
+        std::vector<uint32_t> mWrittenFrom;                 // first byte the CPU wrote straight into the current buffer
+        std::vector<std::vector<PendingCopy>> mPendingCopies;
+        std::vector<std::vector<Buffer>> mRetiredBuffers;   // copied from, freed when the slot comes around again
+    };
+}
@@ -0,0 +1,246 @@
+#include <PCH/pch.h>
+#include "JobSystem.h"
+
+#include <deque>
+
+namespace Radis
+{
+    namespace
+    {
+        struct Task
+        {
+            JobSystem::Job fn;
+        };
+
+        // One deque per thread. The owner pushes/pops at the back (LIFO keeps caches warm),
+        // thieves take from the front so they grab the oldest - usually largest - work.
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        struct JobState
+        {
+            std::vector<std::unique_ptr<WorkQueue>> queues; // [0] = main/external threads, [1..N] = workers
+            std::vector<std::thread> workers;
+
+            std::mutex sleepMutex;
+            std::condition_variable wake;
+
+            std::atomic<uint32_t> pendingJobs{ 0 };
+            std::atomic<bool> running{ false };
+            std::thread::id mainThread;
+        };
+
+        JobState& S()
+        {
+            static JobState s;
+            return s;
+        }
+
+        thread_local uint32_t tThreadIndex = 0;
+        thread_local uint32_t tJobContext = ~0u;
+
+        bool PopLocal(uint32_t queueIndex, Task& out)
+        {
+            WorkQueue& q = *S().queues[queueIndex];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) return false;
+
+            out = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            return true;
+        }
+
+        bool Steal(uint32_t thiefIndex, Task& out)
+        {
+            auto& st = S();
+            const uint32_t queueCount = static_cast<uint32_t>(st.queues.size());
+
+            for (uint32_t i = 1; i < queueCount; ++i)
+            {
+                WorkQueue& q = *st.queues[(thiefIndex + i) % queueCount];
+                std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+                if (!lock.owns_lock() || q.tasks.empty()) continue;
+
+                out = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                return true;
+            }
+            return false;
+        }
+
+        void RunTask(Task& task)
+        {
+            S().pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+            task.fn();
+        }
+
+        void WorkerLoop(uint32_t index)
+        {
+            tThreadIndex = index;
+            auto& st = S();
+
+            while (st.running.load(std::memory_order_acquire))
+            {
+                if (JobSystem::TryRunPendingJob()) continue;
+
+                std::unique_lock<std::mutex> lock(st.sleepMutex);
+                st.wake.wait(lock, [&st]
+                {
+                    return !st.running.load(std::memory_order_acquire) || st.pendingJobs.load(std::memory_order_acquire) > 0;
+                });
+            }
+        }
+    } // namespace
+
+    void JobSystem::Initialize(uint32_t workerCount)
+    {
+        auto& st = S();
+        if (st.running.load())
+        {
+            RADIS_WARN("JobSystem::Initialize called twice; ignoring.");
+            return;
+        }
+
+        if (workerCount == 0)
+        {
+            const uint32_t hw = std::thread::hardware_concurrency();
+            workerCount = hw > 1 ? hw - 1 : 0;
+        }
+
+        tThreadIndex = 0;
+        st.mainThread = std::this_thread::get_id();
+        st.queues.clear();
+        for (uint32_t i = 0; i < workerCount + 1; ++i)
+        {
+            st.queues.emplace_back(std::make_unique<WorkQueue>());
+        }
+
+        st.running = true;
+        st.workers.reserve(workerCount);
+        for (uint32_t i = 1; i <= workerCount; ++i)
+        {
+            st.workers.emplace_back(WorkerLoop, i);
+        }
+
+        RADIS_INFO("JobSystem started with {0} worker threads", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        auto& st = S();
+        if (!st.running.load()) return;
+
+        // Drain whatever is left so nobody waits on a counter forever.
+        while (TryRunPendingJob()) {}
+
+        {
+            std::lock_guard<std::mutex> lock(st.sleepMutex);
+            st.running = false;
+        }
+        st.wake.notify_all();
+
+        for (auto& worker : st.workers)
+        {
+            worker.join();
+        }
+        st.workers.clear();
+        st.queues.clear();
+    }
+
+    void JobSystem::Submit(Job job, JobCounter* counter)
+    {
+        auto& st = S();
+        const uint32_t context = tJobContext;
+        if (counter)
+        {
+            counter->value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // No workers (or not started) - run inline so callers never deadlock.
+        if (st.queues.empty())
+        {
+            job();
+            CompleteJob(counter);
+            return;
+        }
+
+        {
+            WorkQueue& q = *st.queues[tThreadIndex];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back({ [job = std::move(job), counter, context]
+            {
+                // Whoever runs the job (a worker, or a waiting thread helping out) may be in the
+                // middle of its own job, so put its context back afterwards.
+                const uint32_t previous = SetJobContext(context);
+                job();
+                SetJobContext(previous);
+                CompleteJob(counter);
+            } });
+        }
+        st.pendingJobs.fetch_add(1, std::memory_order_release);
+
+        // Touch the sleep mutex so a worker between its predicate check and wait() can't miss this.
+        { std::lock_guard<std::mutex> lock(st.sleepMutex); }
+        st.wake.notify_one();
+    }
+
+    void JobSystem::CompleteJob(JobCounter* counter)
+    {
+        // Last access to the counter, its waiter may destroy it right after
+        if (counter) counter->value.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!TryRunPendingJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    bool JobSystem::TryRunPendingJob()
+    {
+        auto& st = S();
+        if (st.queues.empty() || st.pendingJobs.load(std::memory_order_acquire) == 0) return false;
+
+        Task task;
+        if (!PopLocal(tThreadIndex, task) && !Steal(tThreadIndex, task))
+        {
+            return false;
+        }
+
+        RunTask(task);
+        return true;
+    }
+
+    uint32_t JobSystem::GetWorkerCount()
+    {
+        return static_cast<uint32_t>(S().workers.size());
+    }
+
+    uint32_t JobSystem::GetThreadIndex()
+    {
+        return tThreadIndex;
+    }
+
+    bool JobSystem::IsMainThread()
+    {
+        return std::this_thread::get_id() == S().mainThread;
+    }
+
+    uint32_t JobSystem::SetJobContext(uint32_t context)
+    {
+        return std::exchange(tJobContext, context);
+    }
+
+    uint32_t JobSystem::GetJobContext()
+    {
+        return tJobContext;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+namespace Radis
+{
+    // Tracks outstanding jobs. Submit increments it, job completion decrements it.
+    struct JobCounter
+    {
+        std::atomic<uint32_t> value{ 0 };
+
+        bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+    };
+
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // workerCount of 0 uses (hardware threads - 1), leaving a core to the main thread.
+        static void Initialize(uint32_t workerCount = 0);
+        static void Shutdown();
+
+        // Pushes onto the calling thread's deque. Idle workers steal from the other end.
+        static void Submit(Job job, JobCounter* counter = nullptr);
+
+        // Blocks until the counter reaches zero, running pending jobs while waiting.
+        static void Wait(JobCounter& counter);
+
+        // Runs a single queued job on the calling thread. Returns false if none were found.
+        static bool TryRunPendingJob();
+
+        // Calls fn(begin, end) over [0, count) in chunks of grainSize and waits for all of them.
+        // The calling thread takes part, so this is safe to use from inside a job.
+        template<typename Func>
+        static void ParallelFor(size_t count, size_t grainSize, Func&& fn)
+        {
+            if (count == 0) return;
+            grainSize = std::max<size_t>(grainSize, 1);
+
+            if (count <= grainSize || GetWorkerCount() == 0)
+            {
+                fn(size_t(0), count);
+                return;
+            }
+
+            JobCounter counter;
+            for (size_t begin = 0; begin < count; begin += grainSize)
+            {
+                const size_t end = std::min(begin + grainSize, count);
+                Submit([&fn, begin, end] { fn(begin, end); }, &counter);
+            }
+            Wait(counter);
+        }
+
+        static uint32_t GetWorkerCount();
+
+        // 0 for the main thread (and any thread not owned by the job system), 1..N for workers.
+        static uint32_t GetThreadIndex();
+
+        // True on the thread that called Initialize.
+        static bool IsMainThread();
+
+        // A per-thread value that jobs inherit: Submit captures the caller's context
+        // and the job runs with it, restoring the worker's own afterwards. The ECS keeps the
+        // command sort key of the running system here. Returns the previous value.
+        static uint32_t SetJobContext(uint32_t context);
+        static uint32_t GetJobContext();
+
+    private:
+        static void CompleteJob(JobCounter* counter);
+
+        // Non-instantiable - static-only class implemented in .cpp
+        JobSystem() = delete;
+        ~JobSystem() = delete;
+    };
+}
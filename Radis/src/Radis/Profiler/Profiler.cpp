@@ -62,7 +62,9 @@ namespace Radis
             std::vector<int> stack;                    // active node stack (indices)
             std::vector<std::string> names;            // interned names; stable memory
             std::unordered_map<std::string, size_t> nameToId; // name -> id
-            std::vector<Aggregate> aggregates;         // per-name aggregates for frame
+            std::mutex nameMutex;                      // names/nameToId - scopes can be registered from any thread
+            std::vector<Aggregate> aggregates;         // per-name aggregates for frame, profiler thread only
+            std::vector<ProfilerSnapshotCounter> counters; // counters set this frame, profiler thread only
             int nextNodeIndex = 0;                     // index to allocate next node
             ns_t frameStartNs = 0;
             ns_t frameTotalNs = 0;
@@ -88,6 +90,9 @@ namespace Radis
             return s;
         }
 
+        // Only the thread that called Initialize records scopes.
+        thread_local bool tIsProfilerThread = false;
+
     } // namespace
 
     // -----------------------------------------------------------------------------
@@ -107,6 +112,7 @@ namespace Radis
         st.ResetNodes();
         st.stack.clear();
         st.rootIndex = -1;
+        tIsProfilerThread = true;
     }
 
     // Intern a name and return the stable nameId
@@ -115,15 +121,20 @@ namespace Radis
         auto& st = S();
         if (nameRaw == nullptr) nameRaw = "<null>";
         std::string key(nameRaw);
+        std::lock_guard<std::mutex> lock(st.nameMutex);
         auto it = st.nameToId.find(key);
         if (it != st.nameToId.end()) return it->second;
         size_t id = st.names.size();
         st.names.emplace_back(std::move(key));
         st.nameToId.emplace(st.names.back(), id);
-        st.aggregates.emplace_back();
         return id;
     }
 
+    uint32_t Profiler::RegisterScope(const char* name)
+    {
+        return static_cast<uint32_t>(InternName(name));
+    }
+
     // ensure there is at least one free node and return its index
     static int AllocNode()
     {
@@ -150,10 +161,12 @@ namespace Radis
         // create root node (index 0)
         int root = AllocNode();
         st.rootIndex = root;
-        st.nodes[root].nameId = InternName("FrameRoot");
+        static const size_t frameRootId = InternName("FrameRoot");
+        st.nodes[root].nameId = frameRootId;
         st.nodes[root].parent = -1;
         st.nodes[root].startNs = st.frameStartNs;
         st.stack.push_back(root);
+        st.counters.clear();
         // reset aggregates for the frame
         for (auto& a : st.aggregates)
         {
@@ -188,7 +201,10 @@ namespace Radis
             snap.frameIndex = ++st.lastFrameIndex;
 
             // copy names
-            snap.names = st.names;
+            {
+                std::lock_guard<std::mutex> lock(st.nameMutex);
+                snap.names = st.names;
+            }
 
             // nodes: only copy used nodes: [0 .. nextNodeIndex)
             int usedCount = st.nextNodeIndex;
@@ -205,9 +221,9 @@ namespace Radis
                 dst.callCount = src.callCount;
             }
 
-            // copy aggregates
-            snap.aggs.resize(st.aggregates.size());
-            for (size_t i = 0; i < st.aggregates.size(); ++i)
+            // copy aggregates (names registered but never entered have none yet)
+            snap.aggs.assign(snap.names.size(), {});
+            for (size_t i = 0; i < std::min(st.aggregates.size(), snap.aggs.size()); ++i)
             {
                 const Aggregate& a = st.aggregates[i];
                 ProfilerSnapshotAggregate& out = snap.aggs[i];
@@ -217,20 +233,28 @@ namespace Radis
                 out.minNs = a.minNs;
             }
 
+            snap.counters = st.counters;
+
             // root index: keep root that was used (may be 0)
             snap.rootIndex = st.rootIndex;
         }
     }
 
     void Profiler::BeginScope(const char* name) 
+    {
+        if (!tIsProfilerThread) return;
+        BeginScope(RegisterScope(name));
+    }
+
+    void Profiler::BeginScope(uint32_t nameId)
     {
         auto& st = S();
+        if (!tIsProfilerThread) return;
         if (st.rootIndex < 0)
         {
             // If BeginFrame not called, start a minimal implicit frame
             BeginFrame();
         }
-        size_t nameId = InternName(name);
         int nodeIdx = AllocNode();
         Node& n = st.nodes[nodeIdx];
         n.nameId = nameId;
@@ -256,6 +280,7 @@ namespace Radis
     void Profiler::EndScope() 
     {
         auto& st = S();
+        if (!tIsProfilerThread) return;
         if (st.stack.empty()) return;
 
         int nodeIdx = st.stack.back();
@@ -275,10 +300,66 @@ namespace Radis
 
         // update per-name aggregate
         size_t nameId = n.nameId;
-        if (nameId < st.aggregates.size())
+        if (nameId >= st.aggregates.size())
+        {
+            st.aggregates.resize(nameId + 1);
+        }
+        st.aggregates[nameId].AddSample(n.totalNs);
+    }
+
+    void Profiler::RecordScope(uint32_t nameId, uint64_t startNs, uint64_t endNs)
+    {
+        auto& st = S();
+        if (!tIsProfilerThread) return;
+        if (st.rootIndex < 0 || st.stack.empty()) return;
+
+        int nodeIdx = AllocNode();
+        Node& n = st.nodes[nodeIdx];
+        n.nameId = nameId;
+        n.parent = st.stack.back();
+        n.startNs = startNs;
+        n.totalNs = (endNs > startNs) ? (endNs - startNs) : 0;
+        n.callCount = 1;
+
+        // insert as head, same as BeginScope
+        n.nextSibling = st.nodes[n.parent].firstChild;
+        st.nodes[n.parent].firstChild = nodeIdx;
+
+        // Concurrent work can overlap, so the parent's exclusive time may go to zero - that's expected.
+        st.nodes[n.parent].childNs += n.totalNs;
+
+        if (nameId >= st.aggregates.size())
         {
-            st.aggregates[nameId].AddSample(n.totalNs);
+            st.aggregates.resize(nameId + 1);
+        }
+        st.aggregates[nameId].AddSample(n.totalNs);
+    }
+
+    uint64_t Profiler::Now()
+    {
+        return NowNs();
+    }
+
+    uint32_t Profiler::RegisterCounter(const char* name)
+    {
+        return static_cast<uint32_t>(InternName(name));
+    }
+
+    void Profiler::SetCounter(uint32_t nameId, int64_t value)
+    {
+        auto& st = S();
+        if (!tIsProfilerThread) return;
+
+        // A handful of counters per frame, a linear search beats hashing
+        for (auto& counter : st.counters)
+        {
+            if (counter.nameId == static_cast<int32_t>(nameId))
+            {
+                counter.value = value;
+                return;
+            }
         }
+        st.counters.push_back({ static_cast<int32_t>(nameId), value });
     }
 
     bool Profiler::GetLastFrameSnapshot(ProfilerSnapshot& out)
@@ -25,10 +25,16 @@ namespace Radis
         uint64_t minNs = 0;
     };
 
+    struct ProfilerSnapshotCounter {
+        int32_t nameId = -1;
+        int64_t value = 0;
+    };
+
     struct ProfilerSnapshot {
         std::vector<ProfilerSnapshotNode> nodes;      // node pool for last frame
         std::vector<std::string> names;               // nameId -> string
         std::vector<ProfilerSnapshotAggregate> aggs;  // per-name aggregates
+        std::vector<ProfilerSnapshotCounter> counters; // values set during the frame, in first-set order
         uint64_t frameTotalNs = 0;
         int32_t rootIndex = -1;
         uint64_t frameIndex = 0;
@@ -43,10 +49,25 @@ namespace Radis
         static void BeginFrame();
         static void EndFrame();
 
-        // CPU scope timing interface
+        // Interns a scope name once and returns its id. Thread-safe; may allocate.
+        static uint32_t RegisterScope(const char* name);
+
+        // CPU scope timing interface. Only the thread that called Initialize records scopes,
+        // scopes opened on other threads are ignored.
+        // The id overload is the hot path: a timestamp and a node write, no hashing or allocation.
+        static void BeginScope(uint32_t nameId);
         static void BeginScope(const char* name);
         static void EndScope();
 
+        // Inserts an already-measured scope under the current scope. Used to report work that
+        // ran on job threads once it has completed. Times come from Profiler::Now().
+        static void RecordScope(uint32_t nameId, uint64_t startNs, uint64_t endNs);
+        static uint64_t Now();
+
+        // Per-frame values (draw counts, culled objects...) shown next to the timings. Counters
+        // share the scope name pool and are cleared at BeginFrame. Profiler thread only.
+        static uint32_t RegisterCounter(const char* name);
+        static void SetCounter(uint32_t nameId, int64_t value);
 
         static bool GetLastFrameSnapshot(ProfilerSnapshot& out);
 
@@ -58,14 +79,22 @@ namespace Radis
 
     // RAII helper that begins a scope on construction and ends it on destruction
     struct ProfilerScope {
-        explicit ProfilerScope(const char* name) : m_name(name) { Profiler::BeginScope(m_name); }
+        explicit ProfilerScope(uint32_t nameId) { Profiler::BeginScope(nameId); }
+        explicit ProfilerScope(const char* name) { Profiler::BeginScope(name); }
         ~ProfilerScope() { Profiler::EndScope(); }
-        const char* m_name;
     };
 
     // Convenience macros
-#define PROFILE_SCOPE(name) ProfilerScope CONCAT_PROF(_profScope_, __LINE__)(name)
+    // PROFILE_SCOPE registers its name once per call site, so it needs a name that doesn't change
+    // between calls (a literal). Use PROFILE_SCOPE_ID with a RegisterScope id for anything built at runtime.
+#define PROFILE_SCOPE(name) \
+    static const uint32_t CONCAT_PROF(_profId_, __LINE__) = ::Radis::Profiler::RegisterScope(name); \
+    ::Radis::ProfilerScope CONCAT_PROF(_profScope_, __LINE__)(CONCAT_PROF(_profId_, __LINE__))
+#define PROFILE_SCOPE_ID(id) ::Radis::ProfilerScope CONCAT_PROF(_profScope_, __LINE__)(static_cast<uint32_t>(id))
 #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_COUNTER(name, value) \
+    static const uint32_t CONCAT_PROF(_profCounterId_, __LINE__) = ::Radis::Profiler::RegisterCounter(name); \
+    ::Radis::Profiler::SetCounter(CONCAT_PROF(_profCounterId_, __LINE__), static_cast<int64_t>(value))
 
 #define CONCAT_IMPL(a,b) a##b
 #define CONCAT_PROF(a,b) CONCAT_IMPL(a,b)
@@ -76,15 +105,22 @@ namespace Radis
 
 // No-op versions when profiling disabled
 #define PROFILE_SCOPE(name)
+#define PROFILE_SCOPE_ID(id)
 #define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
 
 namespace Profiler 
 {
     static void Initialize() {}
     static void BeginFrame() {}
     static void EndFrame() {}
+    static uint32_t RegisterScope(const char*) { return 0; }
     static void BeginScope(const char*) {}
     static void EndScope(const char*) {}
+    static void RecordScope(uint32_t, uint64_t, uint64_t) {}
+    static uint64_t Now() { return 0; }
+    static uint32_t RegisterCounter(const char*) { return 0; }
+    static void SetCounter(uint32_t, int64_t) {}
 }
 
 #endif // PROFILING_ENABLED
@@ -13,6 +13,7 @@ int main(int argc, char* argv<::>)
     すぺくっす.serverPort = 7777;
     すぺくっす.graphicsAPI = Radis::GraphicsAPI::Vulkan;
     //すぺくっす.launchWithEditor = false;
+    //すぺくっす.frameCount = 600; // exit after 600 frames
 
     Radis::Engine Engine(すぺくっす, argc, argv); 
     return Engine.Run("cube");